@@ -509,6 +509,30 @@
       if (out) out.value = s;
     }
 
+    // PackBits compression (format "rle", decoded on the device by utils/rle.cpp)
+    function packBits(bytes) {
+      var out = [];
+      var i = 0;
+      var n = bytes.length;
+      while (i < n) {
+        var run = 1;
+        while (i + run < n && run < 128 && bytes[i + run] === bytes[i]) run++;
+        if (run >= 2) {
+          out.push(257 - run, bytes[i]);
+          i += run;
+          continue;
+        }
+        var start = i;
+        while (i < n && i - start < 128) {
+          if (i + 1 < n && bytes[i] === bytes[i + 1]) break;
+          i++;
+        }
+        out.push(i - start - 1);
+        for (var k = start; k < i; k++) out.push(bytes[k]);
+      }
+      return out;
+    }
+
     async function uploadWallpaper() {
       var imgData = bmpCtx.getImageData(0, 0, bmpWidth, bmpHeight);
       var d = imgData.data;
@@ -539,10 +563,11 @@
         bytes.push(currentByte);
       }
 
-      // Convert to base64
+      // Compress (wallpapers are mostly long runs) and convert to base64
+      var packed = packBits(bytes);
       var binary = '';
-      for (var i = 0; i < bytes.length; i++) {
-        binary += String.fromCharCode(bytes[i]);
+      for (var i = 0; i < packed.length; i++) {
+        binary += String.fromCharCode(packed[i]);
       }
       var base64 = btoa(binary);
 
@@ -551,6 +576,7 @@
         var payload = JSON.stringify({
           width: bmpWidth,
           height: bmpHeight,
+          format: 'rle',
           data: base64
         });
 
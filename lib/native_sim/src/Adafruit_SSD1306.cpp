@@ -0,0 +1,69 @@
+/*
+  Adafruit_SSD1306.cpp (native_sim)
+
+  Host SSD1306: pixels land in the page buffer, display() hands it to sim.h.
+*/
+
+#include "Adafruit_SSD1306.h"
+#include "sim.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire *twi, int8_t rst_pin, uint32_t clkDuring, uint32_t clkAfter)
+  : Adafruit_GFX(w, h), _buffer(nullptr), _inverted(false) {
+  (void)twi; (void)rst_pin; (void)clkDuring; (void)clkAfter;
+}
+
+Adafruit_SSD1306::~Adafruit_SSD1306() {
+  free(_buffer);
+}
+
+bool Adafruit_SSD1306::begin(uint8_t switchvcc, uint8_t i2caddr, bool reset, bool periphBegin) {
+  (void)switchvcc; (void)i2caddr; (void)reset; (void)periphBegin;
+  if (!_buffer) _buffer = (uint8_t *)malloc(WIDTH * ((HEIGHT + 7) / 8));
+  if (!_buffer) return false;
+  clearDisplay();
+  return true;
+}
+
+void Adafruit_SSD1306::clearDisplay(void) {
+  if (_buffer) memset(_buffer, 0, WIDTH * ((HEIGHT + 7) / 8));
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (!_buffer || x < 0 || x >= width() || y < 0 || y >= height()) return;
+
+  switch (getRotation()) {
+    case 1: { int16_t t = x; x = WIDTH - y - 1; y = t; break; }
+    case 2: x = WIDTH - x - 1; y = HEIGHT - y - 1; break;
+    case 3: { int16_t t = x; x = y; y = HEIGHT - t - 1; break; }
+  }
+
+  uint8_t &b = _buffer[x + (y / 8) * WIDTH];
+  uint8_t m = 1 << (y & 7);
+  switch (color) {
+    case SSD1306_WHITE: b |= m; break;
+    case SSD1306_BLACK: b &= ~m; break;
+    case SSD1306_INVERSE: b ^= m; break;
+  }
+}
+
+bool Adafruit_SSD1306::getPixel(int16_t x, int16_t y) {
+  if (!_buffer || x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return false;
+  return _buffer[x + (y / 8) * WIDTH] & (1 << (y & 7));
+}
+
+void Adafruit_SSD1306::display(void) {
+  if (!_buffer) return;
+  if (!_inverted) {
+    sim_oled_present(WIDTH, HEIGHT, _buffer);
+    return;
+  }
+  const size_t n = WIDTH * ((HEIGHT + 7) / 8);
+  uint8_t *inv = (uint8_t *)malloc(n);
+  if (!inv) return;
+  for (size_t i = 0; i < n; ++i) inv[i] = ~_buffer[i];
+  sim_oled_present(WIDTH, HEIGHT, inv);
+  free(inv);
+}
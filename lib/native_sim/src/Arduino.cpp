@@ -0,0 +1,235 @@
+/*
+  Arduino.cpp (native_sim)
+
+  Host implementation of the Arduino core subset declared in Arduino.h,
+  WString.h and Print.h.
+*/
+
+#include "Arduino.h"
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <chrono>
+#include <thread>
+
+// --- Time ---
+
+static const std::chrono::steady_clock::time_point s_start = std::chrono::steady_clock::now();
+
+unsigned long millis(void) {
+  return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - s_start).count();
+}
+
+unsigned long micros(void) {
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_start).count();
+}
+
+void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield(void) {
+  std::this_thread::yield();
+}
+
+// --- Random ---
+
+long random(long howbig) {
+  if (howbig <= 0) return 0;
+  return rand() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) srand((unsigned)seed);
+}
+
+// --- GPIO (no-ops) ---
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return HIGH; }
+
+// --- Serial ---
+
+HardwareSerial Serial;
+
+size_t HardwareSerial::write(uint8_t c) {
+  return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+  return fwrite(buffer, 1, size, stdout);
+}
+
+void HardwareSerial::flush() {
+  fflush(stdout);
+}
+
+// --- Print ---
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while (size--) n += write(*buffer++);
+  return n;
+}
+
+size_t Print::print(long v, int base) {
+  if (base == 10) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%ld", v);
+    return write(buf);
+  }
+  return print((unsigned long)v, base);
+}
+
+size_t Print::print(unsigned long v, int base) {
+  char buf[8 * sizeof(long) + 1];
+  char *p = &buf[sizeof(buf) - 1];
+  *p = 0;
+  if (base < 2) base = 10;
+  do {
+    int d = v % base;
+    *--p = d < 10 ? '0' + d : 'A' + d - 10;
+    v /= base;
+  } while (v);
+  return write(p);
+}
+
+size_t Print::print(double v, int digits) {
+  char buf[40];
+  snprintf(buf, sizeof(buf), "%.*f", digits, v);
+  return write(buf);
+}
+
+size_t Print::printf(const char *format, ...) {
+  char buf[256];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(buf, sizeof(buf), format, args);
+  va_end(args);
+  if (len < 0) return 0;
+  if ((size_t)len < sizeof(buf)) return write((const uint8_t *)buf, len);
+
+  std::string big(len + 1, '\0');
+  va_start(args, format);
+  vsnprintf(&big[0], big.size(), format, args);
+  va_end(args);
+  return write((const uint8_t *)big.data(), len);
+}
+
+// --- String ---
+
+static std::string _toBase(unsigned long v, unsigned char base, bool negative) {
+  if (base < 2 || base > 36) base = 10;
+  std::string out;
+  do {
+    int d = v % base;
+    out.insert(out.begin(), (char)(d < 10 ? '0' + d : 'a' + d - 10));
+    v /= base;
+  } while (v);
+  if (negative) out.insert(out.begin(), '-');
+  return out;
+}
+
+String::String(int v, unsigned char base) : String((long)v, base) {}
+String::String(unsigned int v, unsigned char base) : String((unsigned long)v, base) {}
+
+String::String(long v, unsigned char base) {
+  if (base == 10 && v < 0) _s = _toBase(-(unsigned long)v, base, true);
+  else _s = _toBase((unsigned long)v, base, false);
+}
+
+String::String(unsigned long v, unsigned char base) : _s(_toBase(v, base, false)) {}
+
+String::String(float v, unsigned int decimals) : String((double)v, decimals) {}
+
+String::String(double v, unsigned int decimals) {
+  char buf[40];
+  snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+  _s = buf;
+}
+
+bool String::equalsIgnoreCase(const String &o) const {
+  if (_s.length() != o._s.length()) return false;
+  for (size_t i = 0; i < _s.length(); ++i) {
+    if (tolower((unsigned char)_s[i]) != tolower((unsigned char)o._s[i])) return false;
+  }
+  return true;
+}
+
+bool String::endsWith(const String &suffix) const {
+  if (suffix._s.length() > _s.length()) return false;
+  return _s.compare(_s.length() - suffix._s.length(), suffix._s.length(), suffix._s) == 0;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+  size_t p = _s.find(c, from);
+  return p == std::string::npos ? -1 : (int)p;
+}
+
+int String::indexOf(const String &s, unsigned int from) const {
+  size_t p = _s.find(s._s, from);
+  return p == std::string::npos ? -1 : (int)p;
+}
+
+int String::lastIndexOf(char c) const {
+  size_t p = _s.rfind(c);
+  return p == std::string::npos ? -1 : (int)p;
+}
+
+int String::lastIndexOf(const String &s) const {
+  size_t p = _s.rfind(s._s);
+  return p == std::string::npos ? -1 : (int)p;
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+  if (from > to) std::swap(from, to);
+  if (from >= _s.length()) return String();
+  if (to > _s.length()) to = _s.length();
+  return String(_s.substr(from, to - from));
+}
+
+void String::replace(char find, char repl) {
+  for (auto &c : _s) {
+    if (c == find) c = repl;
+  }
+}
+
+void String::replace(const String &find, const String &repl) {
+  if (find._s.empty()) return;
+  size_t p = 0;
+  while ((p = _s.find(find._s, p)) != std::string::npos) {
+    _s.replace(p, find._s.length(), repl._s);
+    p += repl._s.length();
+  }
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+  if (index >= _s.length()) return;
+  _s.erase(index, count);
+}
+
+void String::toUpperCase() {
+  for (auto &c : _s) c = toupper((unsigned char)c);
+}
+
+void String::toLowerCase() {
+  for (auto &c : _s) c = tolower((unsigned char)c);
+}
+
+void String::trim() {
+  size_t b = 0;
+  size_t e = _s.length();
+  while (b < e && isspace((unsigned char)_s[b])) ++b;
+  while (e > b && isspace((unsigned char)_s[e - 1])) --e;
+  _s = _s.substr(b, e - b);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+/*
+ * Arduino.h (native_sim)
+ *
+ * Minimal Arduino core for running the display drivers on a host (Linux/macOS).
+ *
+ * Notes:
+ *  - millis()/micros() count from process start (steady clock)
+ *  - random()/randomSeed() use the C library generator, so seeded sequences
+ *    are reproducible on one host but differ from the ESP32
+ *  - GPIO calls are accepted and ignored
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+
+#include "WString.h"
+#include "Print.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define PROGMEM
+#define PGM_P const char *
+#define F(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr) (*(void *const *)(addr))
+
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define INPUT_PULLDOWN 0x09
+
+// XIAO pin aliases (values are only used as identifiers on the host)
+static const uint8_t D0 = 1, D1 = 2, D2 = 3, D3 = 4, D4 = 5, D5 = 6;
+static const uint8_t D6 = 43, D7 = 44, D8 = 7, D9 = 8, D10 = 9;
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+// Serial goes to stdout
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  void end() {}
+  int available() { return 0; }
+  int read() { return -1; }
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+  using Print::write;
+  void flush() override;
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,248 @@
+/*
+  FS.cpp (native_sim)
+
+  fs::FS / fs::File on top of stdio and POSIX directories.
+*/
+
+#include "FS.h"
+#include "LittleFS.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+
+// mkdir -p
+static bool _mkdirs(const std::string &dir) {
+  if (dir.empty()) return true;
+  struct stat st;
+  if (stat(dir.c_str(), &st) == 0) return S_ISDIR(st.st_mode);
+  size_t slash = dir.find_last_of('/');
+  if (slash != std::string::npos && slash > 0 && !_mkdirs(dir.substr(0, slash))) return false;
+  return ::mkdir(dir.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+// Host directory backing the file system
+static std::string _defaultRoot() {
+  const char *env = getenv("SIM_FS_ROOT");
+  return env && *env ? env : ".pio/sim/fs";
+}
+
+static bool _hostIsDir(const std::string &hostPath) {
+  struct stat st;
+  return stat(hostPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+// --- File ---
+
+namespace fs {
+
+File::File(const std::string &hostPath, const std::string &path, const char *mode)
+  : _hostPath(hostPath), _path(path) {
+  if (_hostIsDir(hostPath)) {
+    _isDir = true;
+    return;
+  }
+  std::string m = mode ? mode : "r";
+  if (m.find('b') == std::string::npos) m += 'b';
+  FILE *f = fopen(hostPath.c_str(), m.c_str());
+  if (f) _file = std::shared_ptr<FILE>(f, [](FILE *p) { fclose(p); });
+}
+
+size_t File::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t File::write(const uint8_t *buf, size_t size) {
+  if (!_file) return 0;
+  return fwrite(buf, 1, size, _file.get());
+}
+
+int File::available() {
+  if (!_file) return 0;
+  return (int)(size() - position());
+}
+
+int File::read() {
+  if (!_file) return -1;
+  int c = fgetc(_file.get());
+  return c == EOF ? -1 : c;
+}
+
+size_t File::read(uint8_t *buf, size_t size) {
+  if (!_file) return 0;
+  return fread(buf, 1, size, _file.get());
+}
+
+String File::readString() {
+  String out;
+  int c;
+  while ((c = read()) >= 0) out += (char)c;
+  return out;
+}
+
+int File::peek() {
+  if (!_file) return -1;
+  int c = fgetc(_file.get());
+  if (c != EOF) ungetc(c, _file.get());
+  return c == EOF ? -1 : c;
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+  if (!_file) return false;
+  static const int WHENCE[] = {SEEK_SET, SEEK_CUR, SEEK_END};
+  return fseek(_file.get(), pos, WHENCE[mode]) == 0;
+}
+
+size_t File::position() const {
+  if (!_file) return 0;
+  long p = ftell(_file.get());
+  return p < 0 ? 0 : (size_t)p;
+}
+
+size_t File::size() const {
+  struct stat st;
+  if (_file) fflush(_file.get());
+  return stat(_hostPath.c_str(), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+void File::flush() {
+  if (_file) fflush(_file.get());
+}
+
+void File::close() {
+  _file.reset();
+  _isDir = false;
+}
+
+const char *File::name() const {
+  size_t slash = _path.find_last_of('/');
+  return slash == std::string::npos ? _path.c_str() : _path.c_str() + slash + 1;
+}
+
+File File::openNextFile(const char *mode) {
+  if (!_isDir) return File();
+
+  std::vector<std::string> names;
+  if (DIR *d = opendir(_hostPath.c_str())) {
+    while (struct dirent *e = readdir(d)) {
+      if (e->d_name[0] != '.') names.push_back(e->d_name);
+    }
+    closedir(d);
+  }
+  std::sort(names.begin(), names.end());
+  if (_dirIndex >= names.size()) return File();
+
+  const std::string &n = names[_dirIndex++];
+  std::string base = _path == "/" ? "" : _path;
+  return File(_hostPath + "/" + n, base + "/" + n, mode);
+}
+
+// --- FS ---
+
+std::string FS::_hostPath(const char *path) {
+  // The root is resolved on first use so files work without begin() as well
+  if (_root.empty()) {
+    _root = _defaultRoot();
+    _mkdirs(_root);
+  }
+  std::string p = path ? path : "";
+  if (p.empty() || p[0] != '/') p = "/" + p;
+  if (p.size() > 1 && p.back() == '/') p.pop_back();
+  return _root + (p == "/" ? "" : p);
+}
+
+File FS::open(const char *path, const char *mode, const bool create) {
+  std::string host = _hostPath(path);
+  bool writing = mode && (mode[0] == 'w' || mode[0] == 'a');
+  if (!writing && !_hostIsDir(host)) {
+    struct stat st;
+    if (stat(host.c_str(), &st) != 0) return File();
+  }
+  if (writing && create) {
+    size_t slash = host.find_last_of('/');
+    if (slash != std::string::npos) _mkdirs(host.substr(0, slash));
+  }
+  File f(host, path ? path : "/", mode);
+  return f ? f : File();
+}
+
+bool FS::exists(const char *path) {
+  struct stat st;
+  return stat(_hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char *path) {
+  return ::remove(_hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char *from, const char *to) {
+  return ::rename(_hostPath(from).c_str(), _hostPath(to).c_str()) == 0;
+}
+
+bool FS::mkdir(const char *path) {
+  return _mkdirs(_hostPath(path));
+}
+
+bool FS::rmdir(const char *path) {
+  return ::rmdir(_hostPath(path).c_str()) == 0;
+}
+
+} // namespace fs
+
+// --- LittleFS ---
+
+LittleFSFS LittleFS;
+
+bool LittleFSFS::begin(bool formatOnFail, const char *basePath, uint8_t maxOpenFiles, const char *partitionLabel) {
+  (void)formatOnFail; (void)basePath; (void)maxOpenFiles; (void)partitionLabel;
+  if (_root.empty()) _root = _defaultRoot();
+  return _mkdirs(_root);
+}
+
+static void _removeTree(const std::string &dir) {
+  if (DIR *d = opendir(dir.c_str())) {
+    while (struct dirent *e = readdir(d)) {
+      std::string n = e->d_name;
+      if (n == "." || n == "..") continue;
+      std::string p = dir + "/" + n;
+      if (_hostIsDir(p)) {
+        _removeTree(p);
+        ::rmdir(p.c_str());
+      } else {
+        ::remove(p.c_str());
+      }
+    }
+    closedir(d);
+  }
+}
+
+bool LittleFSFS::format() {
+  if (!begin()) return false;
+  _removeTree(_root);
+  return true;
+}
+
+static size_t _treeBytes(const std::string &dir) {
+  size_t total = 0;
+  if (DIR *d = opendir(dir.c_str())) {
+    while (struct dirent *e = readdir(d)) {
+      std::string n = e->d_name;
+      if (n == "." || n == "..") continue;
+      std::string p = dir + "/" + n;
+      struct stat st;
+      if (stat(p.c_str(), &st) != 0) continue;
+      total += S_ISDIR(st.st_mode) ? _treeBytes(p) : (size_t)st.st_size;
+    }
+    closedir(d);
+  }
+  return total;
+}
+
+size_t LittleFSFS::usedBytes() {
+  begin();
+  return _treeBytes(_root);
+}
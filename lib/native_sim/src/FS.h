@@ -0,0 +1,80 @@
+#pragma once
+
+/*
+ * FS.h (native_sim)
+ *
+ * Arduino fs::FS / fs::File over a directory of the host file system.
+ * Paths are absolute within the mounted root ("/wallpaper.bin").
+ */
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File : public Print {
+public:
+  File() {}
+  File(const std::string &hostPath, const std::string &path, const char *mode);
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buf, size_t size) override;
+  using Print::write;
+  int available();
+  int read();
+  size_t read(uint8_t *buf, size_t size);
+  size_t readBytes(char *buf, size_t size) { return read((uint8_t *)buf, size); }
+  String readString();
+  int peek();
+  bool seek(uint32_t pos, SeekMode mode = SeekSet);
+  size_t position() const;
+  size_t size() const;
+  void flush() override;
+  void close();
+  operator bool() const { return _file != nullptr || _isDir; }
+
+  const char *path() const { return _path.c_str(); }
+  const char *name() const;
+  bool isDirectory() const { return _isDir; }
+  File openNextFile(const char *mode = FILE_READ);
+  void rewindDirectory() { _dirIndex = 0; }
+
+private:
+  std::shared_ptr<FILE> _file;
+  std::string _hostPath;
+  std::string _path;
+  bool _isDir = false;
+  size_t _dirIndex = 0;
+};
+
+class FS {
+public:
+  File open(const char *path, const char *mode = FILE_READ, const bool create = false);
+  File open(const String &path, const char *mode = FILE_READ, const bool create = false) { return open(path.c_str(), mode, create); }
+  bool exists(const char *path);
+  bool exists(const String &path) { return exists(path.c_str()); }
+  bool remove(const char *path);
+  bool remove(const String &path) { return remove(path.c_str()); }
+  bool rename(const char *from, const char *to);
+  bool rename(const String &from, const String &to) { return rename(from.c_str(), to.c_str()); }
+  bool mkdir(const char *path);
+  bool mkdir(const String &path) { return mkdir(path.c_str()); }
+  bool rmdir(const char *path);
+  bool rmdir(const String &path) { return rmdir(path.c_str()); }
+
+protected:
+  std::string _hostPath(const char *path);
+  std::string _root;
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
@@ -0,0 +1,17 @@
+#pragma once
+
+/*
+ * GxEPD2.h (native_sim)
+ *
+ * Color constants of GxEPD2 for the host build.
+ */
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#define GxEPD_BLACK 0x0000
+#define GxEPD_DARKGREY 0x7BEF
+#define GxEPD_LIGHTGREY 0xC618
+#define GxEPD_WHITE 0xFFFF
+#define GxEPD_RED 0xF800
+#define GxEPD_YELLOW 0xFFE0
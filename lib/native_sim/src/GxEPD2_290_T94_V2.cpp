@@ -0,0 +1,238 @@
+/*
+  GxEPD2_290_T94_V2.cpp (native_sim)
+
+  Controller / panel model of the simulated SSD1680 (see GxEPD2_290_T94_V2.h).
+*/
+
+#include "GxEPD2_290_T94_V2.h"
+#include "sim.h"
+
+#include <string.h>
+
+GxEPD2_290_T94_V2::GxEPD2_290_T94_V2(int16_t cs, int16_t dc, int16_t rst, int16_t busy)
+  : GxEPD2_EPD(cs, dc, rst, busy, HIGH, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate),
+    _cmd(0), _argIndex(0), _xStart(0), _xEnd(STRIDE - 1), _yStart(0), _yEnd(HEIGHT - 1),
+    _xAddr(0), _yAddr(0), _ramBytes(0), _lutLoaded(false) {
+  memset(_ram, 0xFF, sizeof(_ram));
+  memset(_panel, 0, sizeof(_panel));
+  memset(_args, 0, sizeof(_args));
+}
+
+// Power-on / wake-up: back to the built-in waveforms
+void GxEPD2_290_T94_V2::_initDisplay() {
+  if (_hibernating) _reset();
+  _lutLoaded = false;
+  _init_display_done = true;
+}
+
+void GxEPD2_290_T94_V2::clearScreen(uint8_t value) {
+  writeScreenBuffer(value);
+  refresh(true);
+  writeScreenBufferAgain(value);
+}
+
+void GxEPD2_290_T94_V2::writeScreenBuffer(uint8_t value) {
+  if (!_init_display_done || _hibernating) _initDisplay();
+  if (_initial_write) memset(_ram[1], value, sizeof(_ram[1]));
+  memset(_ram[0], value, sizeof(_ram[0]));
+  sim_epd_countBytes(sizeof(_ram[0]) * (_initial_write ? 2 : 1));
+  _initial_write = false;
+}
+
+void GxEPD2_290_T94_V2::writeScreenBufferAgain(uint8_t value) {
+  if (!_init_display_done || _hibernating) _initDisplay();
+  memset(_ram[1], value, sizeof(_ram[1]));
+  sim_epd_countBytes(sizeof(_ram[1]));
+}
+
+void GxEPD2_290_T94_V2::_writePart(int plane, const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                   int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y) {
+  if (_initial_write) writeScreenBuffer();
+  if (!_init_display_done || _hibernating) _initDisplay();
+  if (!bitmap || w <= 0 || h <= 0 || x_part < 0 || x_part >= w_bitmap || y_part < 0 || y_part >= h_bitmap) return;
+
+  const int16_t wb_bitmap = (w_bitmap + 7) / 8;
+  x_part -= x_part % 8;
+  w = std::min<int16_t>(w_bitmap - x_part, w);
+  h = std::min<int16_t>(h_bitmap - y_part, h);
+  // Controller windows are byte aligned
+  w = 8 * ((w + 7) / 8);
+  int16_t x1 = x < 0 ? 0 : x - x % 8;
+  int16_t y1 = y < 0 ? 0 : y;
+  int16_t w1 = std::min<int16_t>(x + w, WIDTH) - x1;
+  int16_t h1 = std::min<int16_t>(y + h, HEIGHT) - y1;
+  int16_t dx = x1 - x;
+  int16_t dy = y1 - y;
+  w1 -= dx;
+  h1 -= dy;
+  if (w1 <= 0 || h1 <= 0) return;
+
+  uint32_t bytes = 0;
+  for (int16_t i = 0; i < h1; ++i) {
+    for (int16_t j = 0; j < w1 / 8; ++j) {
+      int16_t row = mirror_y ? (h_bitmap - 1 - (y_part + i + dy)) : (y_part + i + dy);
+      int32_t idx = (int32_t)(x_part / 8 + j + dx / 8) + (int32_t)row * wb_bitmap;
+      uint8_t data = bitmap[idx];
+      if (invert) data = ~data;
+      _ram[plane][(y1 + i) * STRIDE + x1 / 8 + j] = data;
+      bytes++;
+    }
+  }
+  sim_epd_countBytes(bytes);
+}
+
+void GxEPD2_290_T94_V2::writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm) {
+  (void)pgm;
+  _writePart(0, bitmap, 0, 0, w, h, x, y, w, h, invert, mirror_y);
+}
+
+void GxEPD2_290_T94_V2::writeImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                       int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm) {
+  (void)pgm;
+  _writePart(0, bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y);
+}
+
+void GxEPD2_290_T94_V2::writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm) {
+  (void)pgm;
+  _writePart(1, bitmap, 0, 0, w, h, x, y, w, h, invert, mirror_y);
+  _writePart(0, bitmap, 0, 0, w, h, x, y, w, h, invert, mirror_y);
+}
+
+void GxEPD2_290_T94_V2::writeImagePartAgain(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                            int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm) {
+  (void)pgm;
+  _writePart(1, bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y);
+  _writePart(0, bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y);
+}
+
+void GxEPD2_290_T94_V2::refresh(bool partial_update_mode) {
+  if (partial_update_mode) {
+    refresh(0, 0, WIDTH, HEIGHT);
+    return;
+  }
+  if (!_init_display_done || _hibernating) _initDisplay();
+  _show(0, 0, WIDTH, HEIGHT, false);
+  _waitWhileBusy("_Update_Full", full_refresh_time);
+  _initial_refresh = false;
+  _power_is_on = true;
+  _using_partial_mode = false;
+}
+
+void GxEPD2_290_T94_V2::refresh(int16_t x, int16_t y, int16_t w, int16_t h) {
+  // The first refresh after init (or a gray update) has to be a full one
+  if (_initial_refresh) {
+    refresh(false);
+    return;
+  }
+  if (!_init_display_done || _hibernating) _initDisplay();
+
+  int16_t x1 = std::max<int16_t>(0, x);
+  int16_t y1 = std::max<int16_t>(0, y);
+  int16_t x2 = std::min<int16_t>(WIDTH, x + w);
+  int16_t y2 = std::min<int16_t>(HEIGHT, y + h);
+  if (x1 >= x2 || y1 >= y2) return;
+  // Same byte alignment as the driver
+  x1 -= x1 % 8;
+  x2 = std::min<int16_t>(WIDTH, (x2 + 7) & ~7);
+
+  _show(x1, y1, x2 - x1, y2 - y1, true);
+  _waitWhileBusy("_Update_Part", partial_refresh_time);
+  _power_is_on = true;
+  _using_partial_mode = true;
+}
+
+void GxEPD2_290_T94_V2::powerOff() {
+  _power_is_on = false;
+  _using_partial_mode = false;
+}
+
+void GxEPD2_290_T94_V2::hibernate() {
+  powerOff();
+  _hibernating = true;
+  _init_display_done = false;
+}
+
+void GxEPD2_290_T94_V2::_show(int16_t x, int16_t y, int16_t w, int16_t h, bool partial) {
+  for (int16_t yy = y; yy < y + h; ++yy) {
+    for (int16_t xx = x; xx < x + w; ++xx) {
+      bool white = _ram[0][yy * STRIDE + (xx >> 3)] & (0x80 >> (xx & 7));
+      _panel[yy * WIDTH + xx] = white ? 0 : 3;
+    }
+  }
+  sim_epd_present(WIDTH, HEIGHT, _panel, partial, false);
+}
+
+void GxEPD2_290_T94_V2::_showGray() {
+  for (int16_t yy = 0; yy < HEIGHT; ++yy) {
+    for (int16_t xx = 0; xx < WIDTH; ++xx) {
+      size_t i = yy * STRIDE + (xx >> 3);
+      uint8_t m = 0x80 >> (xx & 7);
+      _panel[yy * WIDTH + xx] = ((_ram[0][i] & m) ? 1 : 0) | ((_ram[1][i] & m) ? 2 : 0);
+    }
+  }
+  sim_epd_present(WIDTH, HEIGHT, _panel, false, true);
+}
+
+// --- Command level model (used by driver subclasses such as the 4-gray mode) ---
+
+void GxEPD2_290_T94_V2::_simReset() {
+  _lutLoaded = false;
+  _cmd = 0;
+  _argIndex = 0;
+}
+
+void GxEPD2_290_T94_V2::_simCommand(uint8_t c) {
+  if (_ramBytes) {
+    sim_epd_countBytes(_ramBytes);
+    _ramBytes = 0;
+  }
+  _cmd = c;
+  _argIndex = 0;
+
+  switch (c) {
+    case 0x12: // SWRESET
+      _lutLoaded = false;
+      break;
+    case 0x20: // master activation
+      if (_lutLoaded) _showGray();
+      else _show(0, 0, WIDTH, HEIGHT, false);
+      break;
+    case 0x32: // custom waveform
+      _lutLoaded = true;
+      break;
+  }
+}
+
+void GxEPD2_290_T94_V2::_simData(uint8_t d) {
+  uint8_t i = _argIndex < 255 ? _argIndex++ : 255;
+  if (i < sizeof(_args)) _args[i] = d;
+
+  switch (_cmd) {
+    case 0x44: // RAM x range (bytes)
+      if (i == 0) _xStart = d;
+      if (i == 1) _xEnd = std::min<uint16_t>(d, STRIDE - 1);
+      break;
+    case 0x45: // RAM y range
+      if (i == 1) _yStart = _args[0] | (d << 8);
+      if (i == 3) _yEnd = std::min<uint16_t>(_args[2] | (d << 8), HEIGHT - 1);
+      break;
+    case 0x4E: // RAM x counter
+      if (i == 0) _xAddr = d;
+      break;
+    case 0x4F: // RAM y counter
+      if (i == 1) _yAddr = _args[0] | (d << 8);
+      break;
+    case 0x24:
+    case 0x26:
+      if (_xAddr < STRIDE && _yAddr < HEIGHT) {
+        _ram[_cmd == 0x26 ? 1 : 0][_yAddr * STRIDE + _xAddr] = d;
+      }
+      _ramBytes++;
+      // Data entry mode x+, y+ (0x11 = 0x03)
+      if (++_xAddr > _xEnd) {
+        _xAddr = _xStart;
+        _yAddr++;
+      }
+      break;
+  }
+}
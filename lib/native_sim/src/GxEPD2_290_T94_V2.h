@@ -0,0 +1,74 @@
+#pragma once
+
+/*
+ * GxEPD2_290_T94_V2.h (native_sim)
+ *
+ * Simulated 2.9" SSD1680 panel (128x296).
+ *
+ * The model keeps both controller RAM planes (0x24 current, 0x26 previous;
+ * bit set = white) and a panel image that only changes on refresh:
+ *  - full refresh    : the whole screen shows RAM 0x24
+ *  - partial refresh : only the refreshed window shows RAM 0x24
+ *  - 0x20 with a custom LUT loaded (0x32): 4-gray update, level bits taken
+ *    from 0x24 (low) and 0x26 (high)
+ * Every refresh is published to sim.h.
+ */
+
+#include <GxEPD2_EPD.h>
+
+class GxEPD2_290_T94_V2 : public GxEPD2_EPD {
+public:
+  static const uint16_t WIDTH = 128;
+  static const uint16_t WIDTH_VISIBLE = WIDTH;
+  static const uint16_t HEIGHT = 296;
+  static const int panel = 0;
+  static const bool hasColor = false;
+  static const bool hasPartialUpdate = true;
+  static const bool hasFastPartialUpdate = true;
+  static const uint16_t power_on_time = 100;
+  static const uint16_t power_off_time = 150;
+  static const uint16_t full_refresh_time = 2100;
+  static const uint16_t partial_refresh_time = 500;
+
+  GxEPD2_290_T94_V2(int16_t cs, int16_t dc, int16_t rst, int16_t busy);
+
+  void clearScreen(uint8_t value = 0xFF);
+  void writeScreenBuffer(uint8_t value = 0xFF) override;
+  void writeScreenBufferAgain(uint8_t value = 0xFF);
+  void writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false) override;
+  void writeImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                      int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false) override;
+  void writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false) override;
+  void writeImagePartAgain(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                           int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false) override;
+  void refresh(bool partial_update_mode = false) override;
+  void refresh(int16_t x, int16_t y, int16_t w, int16_t h) override;
+  void powerOff() override;
+  void hibernate() override;
+
+protected:
+  void _simReset() override;
+  void _simCommand(uint8_t c) override;
+  void _simData(uint8_t d) override;
+
+private:
+  void _initDisplay();
+  void _writePart(int plane, const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                  int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y);
+  void _show(int16_t x, int16_t y, int16_t w, int16_t h, bool partial);
+  void _showGray();
+
+  static const uint16_t STRIDE = WIDTH / 8;
+
+  uint8_t _ram[2][STRIDE * HEIGHT];
+  uint8_t _panel[WIDTH * HEIGHT]; // gray level per pixel, 0 = white .. 3 = black
+
+  // Command decoder state
+  uint8_t _cmd;
+  uint8_t _argIndex;
+  uint8_t _args[4];
+  uint16_t _xStart, _xEnd, _yStart, _yEnd;
+  uint16_t _xAddr, _yAddr;
+  uint32_t _ramBytes;
+  bool _lutLoaded;
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+/*
+ * GxEPD2_BW.h (native_sim)
+ *
+ * Paged black/white drawing front-end over a simulated driver.
+ *
+ * Same buffer layout as GxEPD2 (bit set = white, WIDTH / 8 bytes per row,
+ * page_height rows). Paged drawing walks the pages of the current window and
+ * refreshes once the last page has been written.
+ */
+
+#include <Adafruit_GFX.h>
+#include <GxEPD2_EPD.h>
+#include <GxEPD2_290_T94_V2.h>
+
+#include <string.h>
+
+template <typename GxEPD2_Type, const uint16_t page_height>
+class GxEPD2_BW : public Adafruit_GFX {
+public:
+  GxEPD2_Type epd2;
+
+  GxEPD2_BW(GxEPD2_Type epd2_instance)
+    : Adafruit_GFX(GxEPD2_Type::WIDTH_VISIBLE, GxEPD2_Type::HEIGHT), epd2(epd2_instance),
+      _using_partial_mode(false), _current_page(0),
+      _pw_x(0), _pw_y(0), _pw_w(GxEPD2_Type::WIDTH), _pw_h(GxEPD2_Type::HEIGHT) {
+    memset(_buffer, 0xFF, sizeof(_buffer));
+  }
+
+  void init(uint32_t serial_diag_bitrate = 0) { init(serial_diag_bitrate, true, 10, false); }
+  void init(uint32_t serial_diag_bitrate, bool initial, uint16_t reset_duration = 10, bool pulldown_rst_mode = false) {
+    epd2.init(serial_diag_bitrate, initial, reset_duration, pulldown_rst_mode);
+    _using_partial_mode = false;
+    _current_page = 0;
+    setFullWindow();
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if (x < 0 || x >= width() || y < 0 || y >= height()) return;
+    switch (getRotation()) {
+      case 1: { int16_t t = x; x = WIDTH - y - 1; y = t; break; }
+      case 2: x = WIDTH - x - 1; y = HEIGHT - y - 1; break;
+      case 3: { int16_t t = x; x = y; y = HEIGHT - t - 1; break; }
+    }
+    if (_using_partial_mode) {
+      if (x < _pw_x || x >= _pw_x + _pw_w || y < _pw_y || y >= _pw_y + _pw_h) return;
+      x -= _pw_x;
+      y -= _pw_y;
+    }
+    y -= _current_page * page_height;
+    if (y < 0 || y >= page_height) return;
+
+    uint8_t &b = _buffer[x / 8 + y * (_pw_w / 8)];
+    uint8_t m = 1 << (7 - x % 8);
+    if (color == GxEPD_WHITE) b |= m;
+    else b &= ~m;
+  }
+
+  void fillScreen(uint16_t color) override {
+    memset(_buffer, color == GxEPD_WHITE ? 0xFF : 0x00, sizeof(_buffer));
+  }
+
+  void setFullWindow() {
+    _using_partial_mode = false;
+    _pw_x = 0;
+    _pw_y = 0;
+    _pw_w = GxEPD2_Type::WIDTH;
+    _pw_h = GxEPD2_Type::HEIGHT;
+  }
+
+  void setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    _pw_x = std::min<int16_t>(x & ~7, GxEPD2_Type::WIDTH);
+    _pw_y = std::min<int16_t>(y, GxEPD2_Type::HEIGHT);
+    _pw_w = std::min<int16_t>((x + w + 7) & ~7, GxEPD2_Type::WIDTH) - _pw_x;
+    _pw_h = std::min<int16_t>(y + h, GxEPD2_Type::HEIGHT) - _pw_y;
+    _using_partial_mode = true;
+  }
+
+  void firstPage() {
+    fillScreen(GxEPD_WHITE);
+    _current_page = 0;
+  }
+
+  bool nextPage() {
+    int16_t page_y = _current_page * page_height;
+    int16_t rows = std::min<int16_t>(page_height, _pw_h - page_y);
+    epd2.writeImage(_buffer, _pw_x, _pw_y + page_y, _pw_w, rows);
+    if (page_y + rows < _pw_h) {
+      _current_page++;
+      fillScreen(GxEPD_WHITE);
+      return true;
+    }
+    if (_using_partial_mode) epd2.refresh(_pw_x, _pw_y, _pw_w, _pw_h);
+    else epd2.refresh(false);
+    _current_page = 0;
+    return false;
+  }
+
+  void display(bool partial_update_mode = false) {
+    epd2.writeImage(_buffer, 0, 0, GxEPD2_Type::WIDTH, std::min<int16_t>(page_height, GxEPD2_Type::HEIGHT));
+    epd2.refresh(partial_update_mode);
+  }
+
+  void hibernate() { epd2.hibernate(); }
+  void powerOff() { epd2.powerOff(); }
+
+private:
+  uint8_t _buffer[(GxEPD2_Type::WIDTH / 8) * page_height];
+  bool _using_partial_mode;
+  int16_t _current_page;
+  int16_t _pw_x, _pw_y, _pw_w, _pw_h;
+};
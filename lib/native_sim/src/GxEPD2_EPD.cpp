@@ -0,0 +1,71 @@
+/*
+  GxEPD2_EPD.cpp (native_sim)
+*/
+
+#include "GxEPD2_EPD.h"
+#include "sim.h"
+
+GxEPD2_EPD::GxEPD2_EPD(int16_t cs, int16_t dc, int16_t rst, int16_t busy, int16_t busy_level, uint32_t busy_timeout,
+                       uint16_t w, uint16_t h, int panel, bool c, bool pu, bool fpu)
+  : WIDTH(w), HEIGHT(h), panel(panel), hasColor(c), hasPartialUpdate(pu), hasFastPartialUpdate(fpu),
+    _cs(cs), _dc(dc), _rst(rst), _busy(busy), _busy_level(busy_level), _busy_timeout(busy_timeout),
+    _diag_enabled(false), _pulldown_rst_mode(false), _pSPIx(&SPI),
+    _initial_write(true), _initial_refresh(true), _power_is_on(false), _using_partial_mode(false),
+    _hibernating(false), _init_display_done(false), _reset_duration(10) {}
+
+void GxEPD2_EPD::init(uint32_t serial_diag_bitrate) {
+  init(serial_diag_bitrate, true, 10, false);
+}
+
+void GxEPD2_EPD::init(uint32_t serial_diag_bitrate, bool initial, uint16_t reset_duration, bool pulldown_rst_mode) {
+  _diag_enabled = serial_diag_bitrate > 0;
+  _initial_write = initial;
+  _initial_refresh = initial;
+  _reset_duration = reset_duration;
+  _pulldown_rst_mode = pulldown_rst_mode;
+  _power_is_on = false;
+  _using_partial_mode = false;
+  _hibernating = false;
+  _init_display_done = false;
+}
+
+void GxEPD2_EPD::_reset() {
+  _simReset();
+  _hibernating = false;
+}
+
+void GxEPD2_EPD::_waitWhileBusy(const char *comment, uint16_t busy_time) {
+  (void)comment;
+  sim_busyWait(busy_time);
+}
+
+void GxEPD2_EPD::_writeCommand(uint8_t c) {
+  _simCommand(c);
+}
+
+void GxEPD2_EPD::_writeData(uint8_t d) {
+  _simData(d);
+}
+
+void GxEPD2_EPD::_writeData(const uint8_t *data, uint16_t n) {
+  for (uint16_t i = 0; i < n; ++i) _simData(data[i]);
+}
+
+void GxEPD2_EPD::_writeDataPGM(const uint8_t *data, uint16_t n, int16_t fill_with_zeroes) {
+  _writeData(data, n);
+  while (fill_with_zeroes-- > 0) _simData(0x00);
+}
+
+void GxEPD2_EPD::_writeCommandData(const uint8_t *pCommandData, uint8_t datalen) {
+  if (datalen == 0) return;
+  _simCommand(pCommandData[0]);
+  _writeData(pCommandData + 1, datalen - 1);
+}
+
+void GxEPD2_EPD::_startTransfer() {}
+
+void GxEPD2_EPD::_transfer(uint8_t value) {
+  _simData(value);
+}
+
+void GxEPD2_EPD::_endTransfer() {}
@@ -0,0 +1,74 @@
+#pragma once
+
+/*
+ * GxEPD2_EPD.h (native_sim)
+ *
+ * Base class of the simulated e-paper drivers. It keeps the GxEPD2 members
+ * and low-level helpers (so driver subclasses compile unchanged) and routes
+ * commands and data bytes to the controller model of the concrete panel.
+ * BUSY waits sleep according to sim_setTimingScale().
+ */
+
+#include <GxEPD2.h>
+
+class GxEPD2_EPD {
+public:
+  GxEPD2_EPD(int16_t cs, int16_t dc, int16_t rst, int16_t busy, int16_t busy_level, uint32_t busy_timeout,
+             uint16_t w, uint16_t h, int panel, bool c, bool pu, bool fpu);
+  virtual ~GxEPD2_EPD() {}
+
+  virtual void init(uint32_t serial_diag_bitrate = 0);
+  virtual void init(uint32_t serial_diag_bitrate, bool initial, uint16_t reset_duration = 10, bool pulldown_rst_mode = false);
+
+  virtual void writeScreenBuffer(uint8_t value = 0xFF) = 0;
+  virtual void writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false) = 0;
+  virtual void writeImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                              int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false) = 0;
+  virtual void writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false) {
+    writeImage(bitmap, x, y, w, h, invert, mirror_y, pgm);
+  }
+  virtual void writeImagePartAgain(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                   int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false) {
+    writeImagePart(bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+  }
+  virtual void refresh(bool partial_update_mode = false) = 0;
+  virtual void refresh(int16_t x, int16_t y, int16_t w, int16_t h) = 0;
+  virtual void powerOff() = 0;
+  virtual void hibernate() = 0;
+
+  void selectSPI(SPIClass &spi, SPISettings settings) { _pSPIx = &spi; _spi_settings = settings; }
+
+  const uint16_t WIDTH;
+  const uint16_t HEIGHT;
+  const int panel;
+  const bool hasColor;
+  const bool hasPartialUpdate;
+  const bool hasFastPartialUpdate;
+
+protected:
+  void _reset();
+  void _waitWhileBusy(const char *comment = 0, uint16_t busy_time = 5000);
+  void _writeCommand(uint8_t c);
+  void _writeData(uint8_t d);
+  void _writeData(const uint8_t *data, uint16_t n);
+  void _writeDataPGM(const uint8_t *data, uint16_t n, int16_t fill_with_zeroes = 0);
+  void _writeCommandData(const uint8_t *pCommandData, uint8_t datalen);
+  void _startTransfer();
+  void _transfer(uint8_t value);
+  void _endTransfer();
+
+  // Controller model of the simulated panel
+  virtual void _simReset() {}
+  virtual void _simCommand(uint8_t c) { (void)c; }
+  virtual void _simData(uint8_t d) { (void)d; }
+
+  int16_t _cs, _dc, _rst, _busy, _busy_level;
+  uint32_t _busy_timeout;
+  bool _diag_enabled, _pulldown_rst_mode;
+  SPIClass *_pSPIx;
+  SPISettings _spi_settings;
+  bool _initial_write, _initial_refresh;
+  bool _power_is_on, _using_partial_mode, _hibernating;
+  bool _init_display_done;
+  uint16_t _reset_duration;
+};
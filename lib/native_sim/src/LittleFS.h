@@ -0,0 +1,20 @@
+#pragma once
+
+/*
+ * LittleFS.h (native_sim)
+ *
+ * LittleFS mounted on a host directory: $SIM_FS_ROOT, or .pio/sim/fs.
+ */
+
+#include "FS.h"
+
+class LittleFSFS : public fs::FS {
+public:
+  bool begin(bool formatOnFail = false, const char *basePath = "/littlefs", uint8_t maxOpenFiles = 10, const char *partitionLabel = "spiffs");
+  void end() {}
+  bool format();
+  size_t totalBytes() { return 1024 * 1024; }
+  size_t usedBytes();
+};
+
+extern LittleFSFS LittleFS;
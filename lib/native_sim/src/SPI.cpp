@@ -0,0 +1,7 @@
+/*
+  SPI.cpp (native_sim)
+*/
+
+#include "SPI.h"
+
+SPIClass SPI;
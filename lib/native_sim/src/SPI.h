@@ -0,0 +1,38 @@
+#pragma once
+
+/*
+ * SPI.h (native_sim)
+ *
+ * SPI bus stand-in: transfers are discarded and read back as 0xFF.
+ */
+
+#include <Arduino.h>
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x01
+#define SPI_MODE2 0x02
+#define SPI_MODE3 0x03
+#define MSBFIRST 1
+#define LSBFIRST 0
+
+class SPISettings {
+public:
+  SPISettings() : clock(4000000), bitOrder(MSBFIRST), dataMode(SPI_MODE0) {}
+  SPISettings(uint32_t clockFreq, uint8_t order, uint8_t mode) : clock(clockFreq), bitOrder(order), dataMode(mode) {}
+  uint32_t clock;
+  uint8_t bitOrder;
+  uint8_t dataMode;
+};
+
+class SPIClass {
+public:
+  void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) { (void)sck; (void)miso; (void)mosi; (void)ss; }
+  void end() {}
+  void beginTransaction(SPISettings settings) { (void)settings; }
+  void endTransaction() {}
+  uint8_t transfer(uint8_t data) { (void)data; return 0xFF; }
+  void writeBytes(const uint8_t *data, uint32_t size) { (void)data; (void)size; }
+  void transferBytes(const uint8_t *data, uint8_t *out, uint32_t size) { (void)data; if (out) memset(out, 0xFF, size); }
+};
+
+extern SPIClass SPI;
@@ -0,0 +1,92 @@
+#pragma once
+
+/*
+ * WString.h (native_sim)
+ *
+ * Arduino String for the host build, backed by std::string.
+ * Only the members used by the firmware sources are provided.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+
+class String {
+public:
+  String() {}
+  String(const char *s) : _s(s ? s : "") {}
+  String(const std::string &s) : _s(s) {}
+  explicit String(char c) : _s(1, c) {}
+  explicit String(int v, unsigned char base = 10);
+  explicit String(unsigned int v, unsigned char base = 10);
+  explicit String(long v, unsigned char base = 10);
+  explicit String(unsigned long v, unsigned char base = 10);
+  explicit String(float v, unsigned int decimals = 2);
+  explicit String(double v, unsigned int decimals = 2);
+
+  const char *c_str() const { return _s.c_str(); }
+  unsigned int length() const { return _s.length(); }
+  bool isEmpty() const { return _s.empty(); }
+  bool reserve(unsigned int size) { _s.reserve(size); return true; }
+
+  char charAt(unsigned int i) const { return i < _s.length() ? _s[i] : 0; }
+  void setCharAt(unsigned int i, char c) { if (i < _s.length()) _s[i] = c; }
+  char operator[](unsigned int i) const { return charAt(i); }
+  char &operator[](unsigned int i) { return _s[i]; }
+
+  String &operator+=(const String &o) { _s += o._s; return *this; }
+  String &operator+=(const char *o) { if (o) _s += o; return *this; }
+  String &operator+=(char c) { _s += c; return *this; }
+  String &operator+=(int v) { return *this += String(v); }
+  String &operator+=(unsigned int v) { return *this += String(v); }
+  String &operator+=(long v) { return *this += String(v); }
+  String &operator+=(unsigned long v) { return *this += String(v); }
+  bool concat(const String &o) { *this += o; return true; }
+  bool concat(const char *o) { *this += o; return true; }
+  bool concat(char c) { *this += c; return true; }
+
+  bool equals(const String &o) const { return _s == o._s; }
+  bool equalsIgnoreCase(const String &o) const;
+  bool operator==(const String &o) const { return _s == o._s; }
+  bool operator==(const char *o) const { return _s == (o ? o : ""); }
+  bool operator!=(const String &o) const { return _s != o._s; }
+  bool operator!=(const char *o) const { return !(*this == o); }
+  bool operator<(const String &o) const { return _s < o._s; }
+
+  bool startsWith(const String &prefix) const { return _s.compare(0, prefix._s.length(), prefix._s) == 0; }
+  bool endsWith(const String &suffix) const;
+
+  int indexOf(char c, unsigned int from = 0) const;
+  int indexOf(const String &s, unsigned int from = 0) const;
+  int lastIndexOf(char c) const;
+  int lastIndexOf(const String &s) const;
+
+  String substring(unsigned int from) const { return substring(from, _s.length()); }
+  String substring(unsigned int from, unsigned int to) const;
+
+  void replace(char find, char repl);
+  void replace(const String &find, const String &repl);
+  void remove(unsigned int index) { remove(index, (unsigned int)-1); }
+  void remove(unsigned int index, unsigned int count);
+  void toUpperCase();
+  void toLowerCase();
+  void trim();
+
+  long toInt() const { return strtol(_s.c_str(), nullptr, 10); }
+  float toFloat() const { return strtof(_s.c_str(), nullptr); }
+  double toDouble() const { return strtod(_s.c_str(), nullptr); }
+
+  friend String operator+(const String &a, const String &b) { return String(a._s + b._s); }
+  friend String operator+(const String &a, const char *b) { return String(a._s + (b ? b : "")); }
+  friend String operator+(const char *a, const String &b) { return String((a ? a : "") + b._s); }
+  friend String operator+(const String &a, char b) { return String(a._s + b); }
+  friend String operator+(const String &a, int b) { return a + String(b); }
+  friend String operator+(const String &a, unsigned int b) { return a + String(b); }
+  friend String operator+(const String &a, long b) { return a + String(b); }
+  friend String operator+(const String &a, unsigned long b) { return a + String(b); }
+  friend String operator+(const String &a, float b) { return a + String(b); }
+  friend String operator+(const String &a, double b) { return a + String(b); }
+
+private:
+  std::string _s;
+};
@@ -0,0 +1,77 @@
+/*
+  Wire.cpp (native_sim)
+
+  I2C bus with an SSD1306 (128x64) behind it, see Wire.h.
+*/
+
+#include "Wire.h"
+#include "sim.h"
+
+#include <string.h>
+
+TwoWire Wire;
+
+#define SSD1306_W 128
+#define SSD1306_PAGES 8
+
+// Display RAM and the addressing window of the last 0x21 / 0x22 commands
+static uint8_t s_gram[SSD1306_W * SSD1306_PAGES];
+static uint8_t s_colStart = 0, s_colEnd = SSD1306_W - 1;
+static uint8_t s_pageStart = 0, s_pageEnd = SSD1306_PAGES - 1;
+static uint8_t s_col = 0, s_page = 0;
+
+static void _commands(const uint8_t *p, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    if ((p[i] == 0x21 || p[i] == 0x22) && i + 2 < n) {
+      if (p[i] == 0x21) {
+        s_colStart = s_col = p[i + 1] & 0x7F;
+        s_colEnd = p[i + 2] & 0x7F;
+      } else {
+        s_pageStart = s_page = p[i + 1] & 0x07;
+        s_pageEnd = p[i + 2] & 0x07;
+      }
+      i += 2;
+    }
+    // Other commands (contrast, power, ...) do not touch the RAM
+  }
+}
+
+static void _data(const uint8_t *p, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    s_gram[s_page * SSD1306_W + s_col] = p[i];
+    if (s_col++ >= s_colEnd) {
+      s_col = s_colStart;
+      s_page = s_page >= s_pageEnd ? s_pageStart : s_page + 1;
+    }
+  }
+  sim_oled_countBytes(n);
+  sim_oled_present(SSD1306_W, SSD1306_PAGES * 8, s_gram);
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  _address = address;
+  _txLen = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (_txLen >= sizeof(_tx)) return 0;
+  _tx[_txLen++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t n) {
+  size_t i = 0;
+  while (i < n && write(data[i])) ++i;
+  return i;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  (void)sendStop;
+  if ((_address == 0x3C || _address == 0x3D) && _txLen > 0) {
+    // Control byte: 0x00 = command stream, 0x40 = data stream
+    if (_tx[0] == 0x00) _commands(_tx + 1, _txLen - 1);
+    else if (_tx[0] == 0x40) _data(_tx + 1, _txLen - 1);
+  }
+  _txLen = 0;
+  return 0;
+}
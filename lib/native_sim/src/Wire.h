@@ -0,0 +1,34 @@
+#pragma once
+
+/*
+ * Wire.h (native_sim)
+ *
+ * I2C bus stand-in. Transmissions to the SSD1306 address (0x3C / 0x3D) feed
+ * a model of its display RAM: the column / page address commands and data
+ * writes in horizontal addressing mode. Every data write publishes the RAM as
+ * the simulated OLED frame (see sim.h). Everything else succeeds and is
+ * discarded.
+ */
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) { (void)sda; (void)scl; (void)frequency; return true; }
+  bool end() { return true; }
+  bool setClock(uint32_t frequency) { (void)frequency; return true; }
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool sendStop = true);
+  size_t write(uint8_t data);
+  size_t write(const uint8_t *data, size_t n);
+  uint8_t requestFrom(uint8_t address, uint8_t n) { (void)address; (void)n; return 0; }
+  int available() { return 0; }
+  int read() { return -1; }
+
+private:
+  uint8_t _address = 0;
+  uint8_t _tx[256];
+  size_t _txLen = 0;
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,23 @@
+#pragma once
+
+/*
+ * freertos/queue.h (native_sim)
+ */
+
+#include "FreeRTOS.h"
+
+typedef struct SimQueue *QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+void vQueueDelete(QueueHandle_t q);
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t wait);
+BaseType_t xQueueSendToFront(QueueHandle_t q, const void *item, TickType_t wait);
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t wait);
+BaseType_t xQueuePeek(QueueHandle_t q, void *item, TickType_t wait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t q);
+BaseType_t xQueueReset(QueueHandle_t q);
+
+#define xQueueSendToBack(q, item, wait) xQueueSend(q, item, wait)
+#define xQueueSendFromISR(q, item, woken) ((void)(woken), xQueueSend(q, item, 0))
+#define xQueueReceiveFromISR(q, item, woken) ((void)(woken), xQueueReceive(q, item, 0))
@@ -0,0 +1,23 @@
+#pragma once
+
+/*
+ * freertos/semphr.h (native_sim)
+ *
+ * Semaphores are counting semaphores; a mutex starts with one token and has
+ * no owner or priority inheritance.
+ */
+
+#include "FreeRTOS.h"
+
+typedef struct SimSemaphore *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount);
+void vSemaphoreDelete(SemaphoreHandle_t s);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s);
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t s);
+
+#define xSemaphoreCreateMutex() xSemaphoreCreateCounting(1, 1)
+#define xSemaphoreCreateBinary() xSemaphoreCreateCounting(1, 0)
+#define xSemaphoreGiveFromISR(s, woken) ((void)(woken), xSemaphoreGive(s))
+#define xSemaphoreTakeFromISR(s, woken) ((void)(woken), xSemaphoreTake(s, 0))
@@ -0,0 +1,221 @@
+/*
+  freertos_sim.cpp (native_sim)
+
+  Tasks, queues and semaphores of the freertos/ headers on std::thread.
+*/
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct SimTask {
+  std::string name;
+  uint32_t stackDepth;
+  BaseType_t core;
+};
+
+// Thrown to unwind a task that deletes itself
+struct SimTaskExit {};
+
+static thread_local SimTask *t_current = nullptr;
+static const auto s_start = std::chrono::steady_clock::now();
+
+// Wait on `cv` until `ready()` or the timeout expires
+template <typename Pred>
+static bool _waitFor(std::condition_variable &cv, std::unique_lock<std::mutex> &lock, TickType_t wait, Pred ready) {
+  if (wait == portMAX_DELAY) {
+    cv.wait(lock, ready);
+    return true;
+  }
+  return cv.wait_for(lock, std::chrono::milliseconds(wait), ready);
+}
+
+// --- Tasks ---
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stackDepth, void *param,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core) {
+  (void)priority;
+  SimTask *task = new SimTask{name ? name : "", stackDepth, core};
+  if (handle) *handle = task;
+
+  std::thread([fn, param, task]() {
+    t_current = task;
+    try {
+      fn(param);
+    } catch (const SimTaskExit &) {
+    }
+  }).detach();
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stackDepth, void *param,
+                       UBaseType_t priority, TaskHandle_t *handle) {
+  return xTaskCreatePinnedToCore(fn, name, stackDepth, param, priority, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  if (task == nullptr || task == t_current) throw SimTaskExit();
+}
+
+void vTaskDelay(TickType_t ticks) {
+  if (ticks == 0) std::this_thread::yield();
+  else std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+TickType_t xTaskGetTickCount(void) {
+  return (TickType_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - s_start).count();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+  return t_current;
+}
+
+const char *pcTaskGetName(TaskHandle_t task) {
+  if (!task) task = t_current;
+  return task ? task->name.c_str() : "main";
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+  if (!task) task = t_current;
+  return task ? task->stackDepth : 0;
+}
+
+BaseType_t xPortGetCoreID(void) {
+  return (t_current && t_current->core != tskNO_AFFINITY) ? t_current->core : 0;
+}
+
+// --- Queues ---
+
+struct SimQueue {
+  std::mutex lock;
+  std::condition_variable changed;
+  std::deque<std::vector<uint8_t>> items;
+  UBaseType_t length;
+  UBaseType_t itemSize;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  SimQueue *q = new SimQueue();
+  q->length = length;
+  q->itemSize = itemSize;
+  return q;
+}
+
+void vQueueDelete(QueueHandle_t q) {
+  delete q;
+}
+
+static BaseType_t _send(QueueHandle_t q, const void *item, TickType_t wait, bool front) {
+  if (!q) return pdFAIL;
+  std::unique_lock<std::mutex> lock(q->lock);
+  if (!_waitFor(q->changed, lock, wait, [q] { return q->items.size() < q->length; })) return errQUEUE_FULL;
+
+  const uint8_t *p = (const uint8_t *)item;
+  std::vector<uint8_t> copy(p, p + q->itemSize);
+  if (front) q->items.push_front(std::move(copy));
+  else q->items.push_back(std::move(copy));
+  q->changed.notify_all();
+  return pdPASS;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t wait) {
+  return _send(q, item, wait, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t q, const void *item, TickType_t wait) {
+  return _send(q, item, wait, true);
+}
+
+static BaseType_t _receive(QueueHandle_t q, void *item, TickType_t wait, bool remove) {
+  if (!q) return pdFAIL;
+  std::unique_lock<std::mutex> lock(q->lock);
+  if (!_waitFor(q->changed, lock, wait, [q] { return !q->items.empty(); })) return errQUEUE_EMPTY;
+
+  memcpy(item, q->items.front().data(), q->itemSize);
+  if (remove) {
+    q->items.pop_front();
+    q->changed.notify_all();
+  }
+  return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t wait) {
+  return _receive(q, item, wait, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t q, void *item, TickType_t wait) {
+  return _receive(q, item, wait, false);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+  if (!q) return 0;
+  std::lock_guard<std::mutex> lock(q->lock);
+  return q->items.size();
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t q) {
+  if (!q) return 0;
+  std::lock_guard<std::mutex> lock(q->lock);
+  return q->length - q->items.size();
+}
+
+BaseType_t xQueueReset(QueueHandle_t q) {
+  if (!q) return pdFAIL;
+  std::lock_guard<std::mutex> lock(q->lock);
+  q->items.clear();
+  q->changed.notify_all();
+  return pdPASS;
+}
+
+// --- Semaphores ---
+
+struct SimSemaphore {
+  std::mutex lock;
+  std::condition_variable changed;
+  UBaseType_t count;
+  UBaseType_t maxCount;
+};
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount) {
+  SimSemaphore *s = new SimSemaphore();
+  s->count = initialCount;
+  s->maxCount = maxCount;
+  return s;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t s) {
+  delete s;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t wait) {
+  if (!s) return pdFAIL;
+  std::unique_lock<std::mutex> lock(s->lock);
+  if (!_waitFor(s->changed, lock, wait, [s] { return s->count > 0; })) return pdFAIL;
+  s->count--;
+  return pdPASS;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s) {
+  if (!s) return pdFAIL;
+  std::lock_guard<std::mutex> lock(s->lock);
+  if (s->count >= s->maxCount) return pdFAIL;
+  s->count++;
+  s->changed.notify_one();
+  return pdPASS;
+}
+
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t s) {
+  if (!s) return 0;
+  std::lock_guard<std::mutex> lock(s->lock);
+  return s->count;
+}
@@ -0,0 +1,274 @@
+/*
+  sim.cpp (native_sim)
+
+  Frame store and image file helpers of the host simulator (see sim.h).
+*/
+
+#include "sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#define SIM_SPI_HZ 4000000 // GxEPD2 default for this panel
+
+static std::mutex s_lock;
+static SimImage s_epdFrame;
+static SimImage s_oledFrame;
+static SimEpdCounters s_counters = {0, 0, 0, 0};
+static uint32_t s_oledDisplays = 0;
+static uint32_t s_oledBytes = 0;
+static float s_timingScale = 0.0f;
+
+// --- Frames ---
+
+void sim_epd_present(uint16_t width, uint16_t height, const uint8_t *levels, bool partial, bool gray) {
+  static const uint8_t LUMA[4] = {255, 170, 85, 0};
+  std::lock_guard<std::mutex> g(s_lock);
+  s_epdFrame.width = width;
+  s_epdFrame.height = height;
+  s_epdFrame.luma.resize((size_t)width * height);
+  for (size_t i = 0; i < s_epdFrame.luma.size(); ++i) {
+    s_epdFrame.luma[i] = LUMA[levels[i] & 3];
+  }
+  if (gray) s_counters.grayRefreshes++;
+  else if (partial) s_counters.partialRefreshes++;
+  else s_counters.fullRefreshes++;
+}
+
+void sim_epd_countBytes(uint32_t n) {
+  {
+    std::lock_guard<std::mutex> g(s_lock);
+    s_counters.bytesWritten += n;
+  }
+  // 8 bits per byte at the panel's SPI clock
+  if (s_timingScale > 0) {
+    std::this_thread::sleep_for(std::chrono::microseconds((int64_t)(n * 8e6f / SIM_SPI_HZ * s_timingScale)));
+  }
+}
+
+void sim_oled_present(uint16_t width, uint16_t height, const uint8_t *pages) {
+  std::lock_guard<std::mutex> g(s_lock);
+  s_oledFrame.width = width;
+  s_oledFrame.height = height;
+  s_oledFrame.luma.resize((size_t)width * height);
+  for (uint16_t y = 0; y < height; ++y) {
+    for (uint16_t x = 0; x < width; ++x) {
+      bool lit = pages[x + (y / 8) * width] & (1 << (y & 7));
+      s_oledFrame.luma[(size_t)y * width + x] = lit ? 255 : 0;
+    }
+  }
+  s_oledDisplays++;
+}
+
+void sim_oled_countBytes(uint32_t n) {
+  std::lock_guard<std::mutex> g(s_lock);
+  s_oledBytes += n;
+}
+
+SimImage sim_epd_frame(void) {
+  std::lock_guard<std::mutex> g(s_lock);
+  return s_epdFrame;
+}
+
+SimImage sim_oled_frame(void) {
+  std::lock_guard<std::mutex> g(s_lock);
+  return s_oledFrame;
+}
+
+SimEpdCounters sim_epd_counters(void) {
+  std::lock_guard<std::mutex> g(s_lock);
+  return s_counters;
+}
+
+uint32_t sim_oled_displayCount(void) {
+  std::lock_guard<std::mutex> g(s_lock);
+  return s_oledDisplays;
+}
+
+uint32_t sim_oled_bytesWritten(void) {
+  std::lock_guard<std::mutex> g(s_lock);
+  return s_oledBytes;
+}
+
+// --- Timing ---
+
+void sim_setTimingScale(float scale) {
+  s_timingScale = scale < 0 ? 0 : scale;
+}
+
+float sim_timingScale(void) {
+  return s_timingScale;
+}
+
+void sim_busyWait(uint32_t nominalMs) {
+  if (s_timingScale <= 0) return;
+  std::this_thread::sleep_for(std::chrono::microseconds((int64_t)(nominalMs * 1000.0f * s_timingScale)));
+}
+
+// --- PBM ---
+
+static inline bool _ink(const SimImage &img, size_t i) {
+  return img.luma[i] < 128;
+}
+
+bool sim_writePbm(const char *path, const SimImage &img) {
+  FILE *f = fopen(path, "wb");
+  if (!f) return false;
+
+  const size_t stride = (img.width + 7) / 8;
+  std::vector<uint8_t> row(stride);
+  fprintf(f, "P4\n%u %u\n", img.width, img.height);
+  for (uint16_t y = 0; y < img.height; ++y) {
+    memset(row.data(), 0, stride);
+    for (uint16_t x = 0; x < img.width; ++x) {
+      if (_ink(img, (size_t)y * img.width + x)) row[x >> 3] |= 0x80 >> (x & 7);
+    }
+    fwrite(row.data(), 1, stride, f);
+  }
+  return fclose(f) == 0;
+}
+
+// Next header token of a PBM file (skips whitespace and comments)
+static bool _pbmToken(FILE *f, char *tok, size_t max) {
+  int c;
+  size_t n = 0;
+  do {
+    c = fgetc(f);
+    if (c == '#') {
+      while (c != '\n' && c != EOF) c = fgetc(f);
+    }
+  } while (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+
+  while (c != EOF && c != ' ' && c != '\t' && c != '\r' && c != '\n' && n + 1 < max) {
+    tok[n++] = (char)c;
+    c = fgetc(f);
+  }
+  tok[n] = 0;
+  return n > 0;
+}
+
+bool sim_readPbm(const char *path, SimImage &img) {
+  FILE *f = fopen(path, "rb");
+  if (!f) return false;
+
+  char tok[16];
+  bool ok = _pbmToken(f, tok, sizeof(tok)) && strcmp(tok, "P4") == 0;
+  int w = 0, h = 0;
+  if (ok && _pbmToken(f, tok, sizeof(tok))) w = atoi(tok);
+  if (ok && _pbmToken(f, tok, sizeof(tok))) h = atoi(tok);
+  ok = ok && w > 0 && h > 0 && w <= 0xFFFF && h <= 0xFFFF;
+
+  if (ok) {
+    const size_t stride = (w + 7) / 8;
+    std::vector<uint8_t> row(stride);
+    img.width = w;
+    img.height = h;
+    img.luma.assign((size_t)w * h, 255);
+    for (int y = 0; ok && y < h; ++y) {
+      ok = fread(row.data(), 1, stride, f) == stride;
+      for (int x = 0; ok && x < w; ++x) {
+        if (row[x >> 3] & (0x80 >> (x & 7))) img.luma[(size_t)y * w + x] = 0;
+      }
+    }
+  }
+  fclose(f);
+  return ok;
+}
+
+size_t sim_diffPixels(const SimImage &a, const SimImage &b) {
+  if (a.width != b.width || a.height != b.height || a.luma.size() != b.luma.size()) return (size_t)-1;
+  size_t n = 0;
+  for (size_t i = 0; i < a.luma.size(); ++i) {
+    if (_ink(a, i) != _ink(b, i)) n++;
+  }
+  return n;
+}
+
+// --- PNG (8-bit grayscale, stored deflate blocks) ---
+
+static uint32_t _crc32(uint32_t crc, const uint8_t *p, size_t n) {
+  static uint32_t table[256];
+  static bool ready = false;
+  if (!ready) {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      table[i] = c;
+    }
+    ready = true;
+  }
+  crc = ~crc;
+  while (n--) crc = table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+static void _put32(std::vector<uint8_t> &out, uint32_t v) {
+  out.push_back(v >> 24);
+  out.push_back(v >> 16);
+  out.push_back(v >> 8);
+  out.push_back(v);
+}
+
+static void _chunk(FILE *f, const char *type, const std::vector<uint8_t> &data) {
+  std::vector<uint8_t> buf;
+  _put32(buf, data.size());
+  buf.insert(buf.end(), type, type + 4);
+  buf.insert(buf.end(), data.begin(), data.end());
+  _put32(buf, _crc32(0, &buf[4], buf.size() - 4));
+  fwrite(buf.data(), 1, buf.size(), f);
+}
+
+bool sim_writePng(const char *path, const SimImage &img) {
+  FILE *f = fopen(path, "wb");
+  if (!f) return false;
+
+  static const uint8_t SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  fwrite(SIGNATURE, 1, sizeof(SIGNATURE), f);
+
+  std::vector<uint8_t> ihdr;
+  _put32(ihdr, img.width);
+  _put32(ihdr, img.height);
+  ihdr.push_back(8); // bit depth
+  ihdr.push_back(0); // grayscale
+  ihdr.push_back(0); // deflate
+  ihdr.push_back(0); // adaptive filtering
+  ihdr.push_back(0); // no interlace
+  _chunk(f, "IHDR", ihdr);
+
+  // Raw scanlines (filter type 0) wrapped in a zlib stream of stored blocks
+  std::vector<uint8_t> raw;
+  raw.reserve((size_t)(img.width + 1) * img.height);
+  for (uint16_t y = 0; y < img.height; ++y) {
+    raw.push_back(0);
+    raw.insert(raw.end(), &img.luma[(size_t)y * img.width], &img.luma[(size_t)y * img.width] + img.width);
+  }
+
+  std::vector<uint8_t> z = {0x78, 0x01};
+  size_t pos = 0;
+  do {
+    size_t n = std::min<size_t>(raw.size() - pos, 65535);
+    z.push_back(pos + n == raw.size() ? 1 : 0);
+    z.push_back(n & 0xFF);
+    z.push_back(n >> 8);
+    z.push_back(~n & 0xFF);
+    z.push_back((~n >> 8) & 0xFF);
+    z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + n);
+    pos += n;
+  } while (pos < raw.size());
+
+  uint32_t a = 1, b = 0;
+  for (uint8_t v : raw) {
+    a = (a + v) % 65521;
+    b = (b + a) % 65521;
+  }
+  _put32(z, (b << 16) | a);
+  _chunk(f, "IDAT", z);
+  _chunk(f, "IEND", {});
+
+  return fclose(f) == 0;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+/*
+ * sim.h (native_sim)
+ *
+ * Inspection API of the host simulator.
+ *
+ * The fake panel drivers record what a real panel would show after each
+ * refresh (e-paper) or display RAM write (OLED). Frames are 8-bit luminance,
+ * row-major, 0 = black .. 255 = white:
+ *  - e-paper: level 0 (white) .. 3 (black) maps to 255, 170, 85, 0
+ *  - OLED   : lit pixels are 255, dark pixels 0
+ *
+ * PBM files are 1-bpp (luminance < 128 is written as a set bit); PNG files
+ * are 8-bit grayscale.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+struct SimImage {
+  uint16_t width = 0;
+  uint16_t height = 0;
+  std::vector<uint8_t> luma;
+};
+
+struct SimEpdCounters {
+  uint32_t fullRefreshes;
+  uint32_t partialRefreshes;
+  uint32_t grayRefreshes;
+  uint32_t bytesWritten;   // controller RAM bytes sent over "SPI"
+};
+
+// Copy of the panel contents after the last refresh / display().
+SimImage sim_epd_frame(void);
+SimImage sim_oled_frame(void);
+
+SimEpdCounters sim_epd_counters(void);
+uint32_t sim_oled_displayCount(void);
+// Display RAM bytes sent to the OLED over "I2C" (data only, no commands)
+uint32_t sim_oled_bytesWritten(void);
+
+// Model panel timing: 0 = instant (default), 1 = real durations. BUSY waits
+// sleep for the driver's nominal refresh times and controller RAM writes for
+// their time on a 4 MHz SPI bus.
+void sim_setTimingScale(float scale);
+float sim_timingScale(void);
+
+bool sim_writePng(const char *path, const SimImage &img);
+bool sim_writePbm(const char *path, const SimImage &img);
+bool sim_readPbm(const char *path, SimImage &img);
+
+// Number of pixels whose PBM bit differs (SIZE_MAX when the sizes differ).
+size_t sim_diffPixels(const SimImage &a, const SimImage &b);
+
+// --- Backend hooks (used by the fake drivers) ---
+void sim_epd_present(uint16_t width, uint16_t height, const uint8_t *levels, bool partial, bool gray);
+void sim_epd_countBytes(uint32_t n);
+void sim_oled_present(uint16_t width, uint16_t height, const uint8_t *pages);
+void sim_oled_countBytes(uint32_t n);
+void sim_busyWait(uint32_t nominalMs);
@@ -1,4 +1,5 @@
 #include "beszel.h"
+#include "app/registry.h"
 #include "app/ui/ui_internal.h"
 #include "app/ui/common/types.h"
 #include "app/ui/common/components.h"
@@ -16,16 +17,30 @@ static uint8_t s_prevIndex = 0;
 static unsigned long s_lastFetch = 0;
 static const unsigned long FETCH_INTERVAL = 30000; // 30 seconds
 
-static void fetch_data() {
-    if (oled_isAvailable()) oled_showToast("Fetching Beszel...", 1000);
-    if (BeszelService::getInstance().fetchSystems()) {
-        if (oled_isAvailable()) oled_showToast("Data Updated", 800);
+static std::vector<BeszelSystem> s_fetched; // filled by the fetch job
+
+// App worker
+static bool fetch_work(void*) {
+    return BeszelService::getInstance().fetchSystems(s_fetched);
+}
+
+// UI task. `background` is set for the refreshes started by app events.
+static void fetch_done(bool ok, void* background) {
+    if (ok) {
+        BeszelService::getInstance().setSystems(s_fetched);
+        if (s_index >= BeszelService::getInstance().getSystemCount()) s_index = s_prevIndex = 0;
+        if (oled_isAvailable() && !background) oled_showToast("Data Updated", 800);
     } else {
-        if (oled_isAvailable()) oled_showToast("Fetch Failed", 1500);
+        if (oled_isAvailable() && !background) oled_showToast("Fetch Failed", 1500);
     }
+    s_fetched.clear();
     s_lastFetch = millis();
 }
 
+static void fetch_data() {
+    ui_runAsync("Fetching Beszel...", fetch_work, fetch_done, NULL);
+}
+
 static void render_system_item(uint8_t index, int16_t x, int16_t y) {
     const auto& systems = BeszelService::getInstance().getSystems();
     if (index < systems.size()) {
@@ -41,7 +56,7 @@ static void render_system_item(uint8_t index, int16_t x, int16_t y) {
 static void view_render(int16_t x_offset, int16_t y_offset) {
     auto count = BeszelService::getInstance().getSystemCount();
     if (count == 0) {
-        oled_drawBigText("No Data", x_offset, y_offset, false);
+        oled_drawBigText(ui_isLoading() ? "Loading" : "No Data", x_offset, y_offset, false);
         return;
     }
 
@@ -110,10 +125,10 @@ static void view_back(void) {
     ui_setView(NULL);
 }
 
-static float view_get_progress(void) {
+static q16_t view_get_progress(void) {
     auto count = BeszelService::getInstance().getSystemCount();
-    if (count == 0) return 0.0f;
-    return (float)(s_index + 1) / (float)count;
+    if (count == 0) return 0;
+    return q16_div(s_index + 1, (int32_t)count);
 }
 
 static void view_poll(void) {
@@ -146,8 +161,28 @@ static void app_select(void) {
     }
 }
 
+// App events (loop task): while the view is open, refresh every
+// FETCH_INTERVAL and when the network comes back
+static bool s_online = false;
+static bool s_background = true; // fetch_done() ctx
+
+static void refresh_shown(void) {
+    if (s_online && ui_getView() == &VIEW_BESZEL) ui_runAsync(NULL, fetch_work, fetch_done, &s_background);
+}
+
+static void on_network(const AppEvent& event) {
+    s_online = event.type == APP_EVENT_NETWORK_UP;
+    refresh_shown();
+}
+
+static void on_tick(const AppEvent&) {
+    refresh_shown();
+}
+
 static void app_setup(void) {
     BeszelService::getInstance().begin("https://beszel.francesco-bruno.com/");
+    AppRegistry::subscribe(APP_EVENT_BIT(APP_EVENT_NETWORK_UP) | APP_EVENT_BIT(APP_EVENT_NETWORK_DOWN), on_network);
+    AppRegistry::subscribeTick(FETCH_INTERVAL, on_tick);
 }
 
 const App APP_BESZEL = {
@@ -155,6 +190,5 @@ const App APP_BESZEL = {
     .renderPreview = app_renderPreview,
     .onSelect = app_select,
     .setup = app_setup,
-    .registerRoutes = nullptr,
-    .poll = nullptr 
+    .registerRoutes = nullptr
 };
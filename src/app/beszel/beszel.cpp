@@ -18,7 +18,7 @@ bool BeszelService::begin(const String& baseUrl) {
     return true;
 }
 
-bool BeszelService::fetchSystems() {
+bool BeszelService::fetchSystems(std::vector<BeszelSystem>& out) {
     if (!_isInitialized) return false;
 
     String url = _baseUrl + "api/collections/systems/records";
@@ -36,7 +36,7 @@ bool BeszelService::fetchSystems() {
     }
 
     JsonArray items = doc["items"];
-    _systems.clear();
+    out.clear();
     
     for (JsonObject item : items) {
         BeszelSystem sys;
@@ -67,7 +67,7 @@ bool BeszelService::fetchSystems() {
             }
         }
         
-        _systems.push_back(sys);
+        out.push_back(sys);
     }
     
     return true;
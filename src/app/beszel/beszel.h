@@ -19,7 +19,11 @@ public:
     static BeszelService& getInstance();
     
     bool begin(const String& baseUrl);
-    bool fetchSystems();
+
+    // Fetch the systems into `out` (blocking: run it as a UI job). The list
+    // the getters return only changes through setSystems().
+    bool fetchSystems(std::vector<BeszelSystem>& out);
+    void setSystems(std::vector<BeszelSystem>& systems) { _systems.swap(systems); }
     
     const std::vector<BeszelSystem>& getSystems() const { return _systems; }
     size_t getSystemCount() const { return _systems.size(); }
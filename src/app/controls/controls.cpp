@@ -9,6 +9,11 @@
  * - Default actions are preserved for compatibility, but the UI module usually disables them.
  *
  * Buttons are expected to be wired active-low: button connects the GPIO to GND when pressed.
+ *
+ * Edges are captured by GPIO interrupts into a single-producer ring with the
+ * time they happened; controls_poll() replays them, so debounce and long
+ * press are judged on those timestamps and a press made while the poller was
+ * busy is still seen with its real duration.
  */
 
 #include "controls.h"
@@ -16,6 +21,16 @@
 #include "drivers/oled/oled.h"
 
 #include <Arduino.h>
+#include <atomic>
+
+// Serial logging: 0 = off, 1 = presses and actions, 2 = also every raw edge
+#ifndef CONTROLS_LOG_LEVEL
+#define CONTROLS_LOG_LEVEL 1
+#endif
+#define CONTROLS_LOG(level, ...) do { if (CONTROLS_LOG_LEVEL >= (level)) Serial.printf(__VA_ARGS__); } while (0)
+
+// Edge ring (power of two). A press with bounce is a few dozen edges at most.
+#define CONTROLS_RING_SIZE 64
 
 // Internal state for a single button
 struct ButtonState {
@@ -32,6 +47,24 @@ static ButtonState s_prevBtn;
 static ButtonState s_nextBtn;
 static ButtonState s_confirmBtn;
 
+// Indexed by the interrupt argument; not const so it stays in RAM for the ISR
+static ButtonState *s_buttons[] = {&s_prevBtn, &s_nextBtn, &s_confirmBtn};
+static const int BUTTON_COUNT = sizeof(s_buttons) / sizeof(s_buttons[0]);
+
+struct ButtonEdge {
+  uint32_t ms;     // millis() at the edge
+  uint8_t button;  // index into s_buttons
+  uint8_t level;   // pin level after the edge
+};
+
+// Written by the ISR (head) and controls_poll() (tail) only
+static ButtonEdge s_ring[CONTROLS_RING_SIZE];
+static std::atomic<uint32_t> s_ringHead(0);
+static std::atomic<uint32_t> s_ringTail(0);
+static volatile bool s_ringOverflow = false;
+static volatile bool s_resync = false;
+static controls_button_cb_t volatile s_edge_cb = nullptr;
+
 static unsigned long s_debounceMs = 50;
 static unsigned long s_longPressMs = 1000;
 
@@ -57,7 +90,7 @@ static void defaultNextAction() {
 }
 static void defaultConfirmAction() {
   // No-op by default (log for diagnostics)
-  Serial.println("controls: defaultConfirmAction -> no action");
+  CONTROLS_LOG(1, "controls: defaultConfirmAction -> no action\n");
 }
 static void defaultLongPressAction() {
   // Run the recovery clear sequence (long operation)
@@ -67,6 +100,23 @@ static void defaultLongPressAction() {
   }
 }
 
+/* ---------- Edge capture ---------- */
+static void IRAM_ATTR _onEdge(void *arg) {
+  uint32_t head = s_ringHead.load(std::memory_order_relaxed);
+  if (head - s_ringTail.load(std::memory_order_acquire) >= CONTROLS_RING_SIZE) {
+    s_ringOverflow = true; // controls_poll() re-reads the pins
+    return;
+  }
+  ButtonEdge &e = s_ring[head & (CONTROLS_RING_SIZE - 1)];
+  e.ms = millis();
+  e.button = (uint8_t)(uintptr_t)arg;
+  e.level = digitalRead(s_buttons[e.button]->pin);
+  s_ringHead.store(head + 1, std::memory_order_release);
+
+  controls_button_cb_t cb = s_edge_cb;
+  if (cb) cb();
+}
+
 /* ---------- Initialization ---------- */
 void controls_init(uint8_t prevPin, uint8_t nextPin, uint8_t confirmPin, unsigned long debounceMs) {
   s_prevBtn.pin = prevPin;
@@ -74,7 +124,7 @@ void controls_init(uint8_t prevPin, uint8_t nextPin, uint8_t confirmPin, unsigne
   s_confirmBtn.pin = confirmPin;
   s_debounceMs = debounceMs;
 
-  Serial.printf("controls_init: prevPin=%d nextPin=%d confirmPin=%d debounceMs=%lu\n", prevPin, nextPin, confirmPin, s_debounceMs);
+  CONTROLS_LOG(1, "controls_init: prevPin=%d nextPin=%d confirmPin=%d debounceMs=%lu\n", prevPin, nextPin, confirmPin, s_debounceMs);
 
   // Configure pins. Your buttons are wired to GND (active-low), so enable
   // the internal pull-ups to keep the pins HIGH at idle and read LOW when
@@ -91,24 +141,28 @@ void controls_init(uint8_t prevPin, uint8_t nextPin, uint8_t confirmPin, unsigne
   s_prevBtn.idleState = HIGH; 
   s_prevBtn.lastChange = millis();
   s_prevBtn.pressStart = 0;
-  s_prevBtn.longFired = false;
+  s_prevBtn.longFired = s_prevBtn.raw != HIGH; // held through boot (e.g. the wake button): ignore its release
 
   s_nextBtn.raw = digitalRead(s_nextBtn.pin);
   s_nextBtn.stable = s_nextBtn.raw;
   s_nextBtn.idleState = HIGH; 
   s_nextBtn.lastChange = millis();
   s_nextBtn.pressStart = 0;
-  s_nextBtn.longFired = false;
+  s_nextBtn.longFired = s_nextBtn.raw != HIGH;
 
   s_confirmBtn.raw = digitalRead(s_confirmBtn.pin);
   s_confirmBtn.stable = s_confirmBtn.raw;
   s_confirmBtn.idleState = HIGH; 
   s_confirmBtn.lastChange = millis();
   s_confirmBtn.pressStart = 0;
-  s_confirmBtn.longFired = false;
+  s_confirmBtn.longFired = s_confirmBtn.raw != HIGH;
 
-  Serial.printf("controls_init: initial raw prev=%d stable=%d next raw=%d stable=%d confirm raw=%d stable=%d\n",
-                s_prevBtn.raw, s_prevBtn.stable, s_nextBtn.raw, s_nextBtn.stable, s_confirmBtn.raw, s_confirmBtn.stable);
+  CONTROLS_LOG(1, "controls_init: initial raw prev=%d stable=%d next raw=%d stable=%d confirm raw=%d stable=%d\n",
+               s_prevBtn.raw, s_prevBtn.stable, s_nextBtn.raw, s_nextBtn.stable, s_confirmBtn.raw, s_confirmBtn.stable);
+
+  for (int i = 0; i < BUTTON_COUNT; ++i) {
+    attachInterruptArg(digitalPinToInterrupt(s_buttons[i]->pin), _onEdge, (void *)(uintptr_t)i, CHANGE);
+  }
 
   // If defaults enabled and no callbacks provided, leave callbacks null:
   // callbacks are checked at invocation-time and fall back to defaults if needed.
@@ -151,6 +205,25 @@ void controls_setUseDefaultActions(bool enable) {
   s_useDefaultActions = enable;
 }
 
+void controls_setEdgeCallback(controls_button_cb_t cb) {
+  s_edge_cb = cb;
+}
+
+// Read from other tasks (idle governor): a stale answer only costs one poll
+bool controls_isIdle(void) {
+  if (s_ringOverflow || s_resync) return false;
+  if (s_ringHead.load(std::memory_order_acquire) != s_ringTail.load(std::memory_order_acquire)) return false;
+  for (int i = 0; i < BUTTON_COUNT; ++i) {
+    const ButtonState &b = *s_buttons[i];
+    if (b.raw != b.idleState || b.stable != b.idleState) return false;
+  }
+  return true;
+}
+
+void controls_resync(void) {
+  s_resync = true;
+}
+
 // Diagnostic helpers
 uint8_t controls_getPrevPin(void) { return s_prevBtn.pin; }
 uint8_t controls_getNextPin(void) { return s_nextBtn.pin; }
@@ -159,96 +232,119 @@ uint8_t controls_getConfirmPin(void) { return s_confirmBtn.pin; }
 // Read raw digital state of a pin (convenience wrapper)
 int controls_readPin(uint8_t pin) { return digitalRead(pin); }
 
-float controls_getConfirmHoldProgress(void) {
+q16_t controls_getConfirmHoldProgress(void) {
   if (s_confirmBtn.stable == s_confirmBtn.idleState || s_confirmBtn.pressStart == 0 || s_confirmBtn.longFired) {
-    return 0.0f;
+    return 0;
   }
   unsigned long held = millis() - s_confirmBtn.pressStart;
-  float p = (float)held / (float)s_longPressMs;
-  if (p > 1.0f) p = 1.0f;
-  if (p < 0.0f) p = 0.0f;
-  return p;
-}
-
-/* ---------- Polling + debounce logic ---------- */
-// Helper that handles a single button's state machine.
-// - b: reference to ButtonState
-// - onShort: short-press handler (may be null)
-// - onLong: long-press handler (may be null)
-static void _pollButton(ButtonState &b, controls_button_cb_t onShort, controls_button_cb_t onLong) {
-  int reading = digitalRead(b.pin);
-
-  // Raw change detection
-  if (reading != b.raw) {
-    b.lastChange = millis();
-    b.raw = reading;
-    Serial.printf("controls: pin %d raw changed -> %d\n", b.pin, b.raw);
-    // If the device has an attached USB-serial chip that resets on DTR/RTS,
-    // rapid connect/disconnects can be observed by platformio monitor when
-    // pressing a pin wired to the USB-serial control lines. Log an extra
-    // message to help correlate disconnects.
-    Serial.printf("controls-debug: pin %d lastChange=%lu\n", b.pin, b.lastChange);
+  if (s_longPressMs == 0 || held >= s_longPressMs) return Q16_ONE;
+  return q16_div((int32_t)held, (int32_t)s_longPressMs);
+}
+
+/* ---------- Debounce + long-press logic ---------- */
+static void _callbacks(ButtonState &b, controls_button_cb_t &onShort, controls_button_cb_t &onLong) {
+  // Prefer per-button long-press callbacks when set; otherwise fall back to the global one.
+  if (&b == &s_prevBtn) {
+    onShort = s_prev_cb;
+    onLong = s_prev_long_cb ? s_prev_long_cb : s_longpress_cb;
+  } else if (&b == &s_nextBtn) {
+    onShort = s_next_cb;
+    onLong = s_next_long_cb ? s_next_long_cb : s_longpress_cb;
+  } else {
+    onShort = s_confirm_cb;
+    onLong = s_confirm_long_cb ? s_confirm_long_cb : s_longpress_cb;
   }
+}
 
-  // If the raw reading has been stable for more than debounce period,
-  // and differs from previously stable state, commit the new stable state.
-  if ((millis() - b.lastChange) > s_debounceMs) {
-    if (b.raw != b.stable) {
-      b.stable = b.raw;
-      if (b.stable != b.idleState) {
-        // Button became pressed: mark press start
-        b.pressStart = millis();
-        b.longFired = false;
-        Serial.printf("controls: pin %d pressed\n", b.pin);
-      } else {
-        // Button released: if long press wasn't fired, treat as short press
-        if (!b.longFired) {
-          if (onShort) {
-            Serial.printf("controls: pin %d short -> custom callback\n", b.pin);
-            onShort();
-          } else if (s_useDefaultActions) {
-            Serial.printf("controls: pin %d short -> default action\n", b.pin);
-            // choose the correct default depending on which button
-            if (&b == &s_prevBtn) defaultPrevAction();
-            else if (&b == &s_nextBtn) defaultNextAction();
-            else if (&b == &s_confirmBtn) defaultConfirmAction();
-          } else {
-            Serial.printf("controls: pin %d short -> no action registered\n", b.pin);
-          }
-        }
-        // reset pressStart
-        b.pressStart = 0;
-        b.longFired = false;
-      }
+static void _fireShort(ButtonState &b) {
+  controls_button_cb_t onShort, onLong;
+  _callbacks(b, onShort, onLong);
+  if (onShort) {
+    CONTROLS_LOG(1, "controls: pin %d short -> custom callback\n", b.pin);
+    onShort();
+  } else if (s_useDefaultActions) {
+    CONTROLS_LOG(1, "controls: pin %d short -> default action\n", b.pin);
+    // choose the correct default depending on which button
+    if (&b == &s_prevBtn) defaultPrevAction();
+    else if (&b == &s_nextBtn) defaultNextAction();
+    else if (&b == &s_confirmBtn) defaultConfirmAction();
+  } else {
+    CONTROLS_LOG(1, "controls: pin %d short -> no action registered\n", b.pin);
+  }
+}
+
+static void _fireLong(ButtonState &b) {
+  controls_button_cb_t onShort, onLong;
+  _callbacks(b, onShort, onLong);
+  if (onLong) {
+    CONTROLS_LOG(1, "controls: pin %d long -> custom callback\n", b.pin);
+    onLong();
+  } else if (s_useDefaultActions) {
+    CONTROLS_LOG(1, "controls: pin %d long -> default long action\n", b.pin);
+    defaultLongPressAction();
+  } else {
+    CONTROLS_LOG(1, "controls: pin %d long -> no action registered\n", b.pin);
+  }
+  b.longFired = true;
+}
+
+// Advance a button's state machine to time `t`: commit a raw level that held
+// for the debounce time (as of when it changed) and fire a due long press.
+static void _settle(ButtonState &b, unsigned long t) {
+  if (b.raw != b.stable && (t - b.lastChange) > s_debounceMs) {
+    const unsigned long at = b.lastChange;
+    b.stable = b.raw;
+    if (b.stable != b.idleState) {
+      // Button became pressed: mark press start (0 means "no press")
+      b.pressStart = at ? at : 1;
+      b.longFired = false;
+      CONTROLS_LOG(1, "controls: pin %d pressed\n", b.pin);
     } else {
-      // If button is held down, check for long press
-      if (b.stable != b.idleState && !b.longFired && b.pressStart != 0) {
-        if ((millis() - b.pressStart) >= s_longPressMs) {
-          // long press detected
-          if (onLong) {
-            Serial.printf("controls: pin %d long -> custom per-button callback\n", b.pin);
-            onLong();
-          } else if (s_longpress_cb) {
-            Serial.printf("controls: pin %d long -> global long callback\n", b.pin);
-            s_longpress_cb();
-          } else if (s_useDefaultActions) {
-            Serial.printf("controls: pin %d long -> default long action\n", b.pin);
-            defaultLongPressAction();
-          } else {
-            Serial.printf("controls: pin %d long -> no action registered\n", b.pin);
-          }
-
-          b.longFired = true;
-        }
+      // Button released: held long enough for a long press that was not
+      // polled in time, or a short press
+      if (!b.longFired && b.pressStart != 0) {
+        if (at - b.pressStart >= s_longPressMs) _fireLong(b);
+        else _fireShort(b);
       }
+      b.pressStart = 0;
+      b.longFired = false;
     }
   }
+
+  // If button is held down, check for long press
+  if (b.stable != b.idleState && !b.longFired && b.pressStart != 0 && (t - b.pressStart) >= s_longPressMs) {
+    _fireLong(b);
+  }
+}
+
+// Apply one raw edge at its timestamp
+static void _edge(ButtonState &b, unsigned long t, int level) {
+  _settle(b, t);
+  if (level == b.raw) return; // bounce lost in between, nothing changed
+  b.raw = level;
+  b.lastChange = t;
+  CONTROLS_LOG(2, "controls: pin %d raw -> %d at %lu\n", b.pin, b.raw, t);
 }
 
 void controls_poll(void) {
-  // Must be called frequently (e.g., from loop())
-  // Prefer per-button long-press callbacks when set; otherwise fall back to the global one.
-  _pollButton(s_prevBtn, s_prev_cb, (s_prev_long_cb ? s_prev_long_cb : s_longpress_cb));
-  _pollButton(s_nextBtn, s_next_cb, (s_next_long_cb ? s_next_long_cb : s_longpress_cb));
-  _pollButton(s_confirmBtn, s_confirm_cb, (s_confirm_long_cb ? s_confirm_long_cb : s_longpress_cb));
+  // Replay the captured edges in order
+  uint32_t tail = s_ringTail.load(std::memory_order_relaxed);
+  const uint32_t head = s_ringHead.load(std::memory_order_acquire);
+  while (tail != head) {
+    const ButtonEdge e = s_ring[tail & (CONTROLS_RING_SIZE - 1)];
+    s_ringTail.store(++tail, std::memory_order_release);
+    if (e.button < BUTTON_COUNT) _edge(*s_buttons[e.button], e.ms, e.level);
+  }
+
+  // Edges were dropped or not seen: resync with the pins
+  if (s_ringOverflow || s_resync) {
+    if (s_ringOverflow) CONTROLS_LOG(1, "controls: edge ring overflow, re-reading pins\n");
+    s_ringOverflow = false;
+    s_resync = false;
+    for (int i = 0; i < BUTTON_COUNT; ++i) _edge(*s_buttons[i], millis(), digitalRead(s_buttons[i]->pin));
+  }
+
+  // Read after the replay, so no edge is newer than `now`
+  const unsigned long now = millis();
+  for (int i = 0; i < BUTTON_COUNT; ++i) _settle(*s_buttons[i], now);
 }
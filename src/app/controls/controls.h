@@ -5,7 +5,9 @@
  *
  * Modular button handling (Clear, Toggle Partial Update).
  *
- * - Software debounce
+ * - Edges captured by GPIO interrupts with their timestamps, so presses made
+ *   while the poller is busy are not lost
+ * - Software debounce and long press judged on those timestamps
  * - Event callbacks (short press)
  * - Default behavior: Clear -> epd_clear(), Toggle -> epd_setPartialEnabled(!...)
  *
@@ -14,6 +16,7 @@
  */
 
 #include <Arduino.h>
+#include "utils/anim.h"
 
 using controls_button_cb_t = void (*)(void);
 
@@ -26,7 +29,9 @@ using controls_button_cb_t = void (*)(void);
 // third parameter is not provided, `confirmPin` will use the default value.
 void controls_init(uint8_t prevPin = 14, uint8_t nextPin = 16, uint8_t confirmPin = 9, unsigned long debounceMs = 50);
 
-// Must be called frequently from the main loop to handle button polling
+// Replay captured edges and run the callbacks. Call regularly (the UI task
+// does): callbacks run on the caller's task, and a held button's long press
+// fires on the first call after the threshold.
 void controls_poll(void);
 
 // Set callbacks invoked on short button presses (Prev / Next / Confirm)
@@ -53,8 +58,20 @@ uint8_t controls_getPrevPin(void);
 uint8_t controls_getNextPin(void);
 uint8_t controls_getConfirmPin(void);
 
-// Returns the hold progress (0.0 to 1.0) of the confirm button relative to the long-press threshold
-float controls_getConfirmHoldProgress(void);
+// Returns the hold progress (0 to Q16_ONE) of the confirm button relative to the long-press threshold
+q16_t controls_getConfirmHoldProgress(void);
+
+// (Optional) Called from the GPIO interrupt on every edge, e.g. to wake the
+// task that polls. Must be ISR-safe (IRAM_ATTR, *FromISR calls only).
+void controls_setEdgeCallback(controls_button_cb_t cb);
+
+// True when no button is down and nothing waits for debounce or replay:
+// controls_poll() has nothing to do until the next edge
+bool controls_isIdle(void);
+
+// Re-read the pins on the next poll, for edges the interrupts could not see
+// (e.g. while light sleep had them switched to wake-up levels)
+void controls_resync(void);
 
 // Read raw digital state of a pin (convenience wrapper)
 int controls_readPin(uint8_t pin);
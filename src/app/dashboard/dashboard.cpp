@@ -1,14 +1,20 @@
 #include "dashboard.h"
 #include "app/wifi/wifi.h"
 #include "drivers/epaper/display.h"
+#include "drivers/epaper/stats.h"
+#include "drivers/oled/oled.h"
 #include "app/controls/controls.h"
 #include "app/ui/ui.h"
+#include "app/power/power.h"
 #include "utils/logger/logger.h"
 #include "utils/base64.h"
+#include "utils/image_stream.h"
+#include "utils/task_stats.h"
 #include <WebServer.h>
 #include <ArduinoJson.h>
 #include <LittleFS.h>
 #include <GxEPD2_BW.h>
+#include <algorithm>
 
 // --- Static Helpers ---
 
@@ -50,20 +56,235 @@ static void handleRoot() {
   if(g_server) serve_file_from_littlefs(g_server, "/index.html", "text/html");
 }
 
+// Queue EPD work attributed to "http" in /api/epd/stats (the tag is per
+// task: the UI keeps its own). Also counts as activity for the deep-sleep
+// idle timer.
+template <typename F>
+static void with_http_source(F fn) {
+  power_noteActivity();
+  epd_setSourceTag("http");
+  fn();
+}
+
+static float avg_ms(const EpdPhaseAggregate &a) {
+  return a.count ? (float)(a.sumUs / a.count) / 1000.0f : 0.0f;
+}
+
 static void handleStatus() {
   if(!g_server) return;
-  StaticJsonDocument<256> doc;
-  IPAddress ip = wifi_getIP();
-  doc["ip"] = ip.toString();
-  doc["text"] = epd_getCurrentText();
+  String ip = wifi_getIP().toString();
+  String text = epd_getCurrentText();
+
+  // One term per object below, plus the copied strings. Keep it in step
+  // with the fields; overflow is checked before sending.
+  const size_t capacity = JSON_OBJECT_SIZE(10)                      // top level
+      + JSON_OBJECT_SIZE(6) + JSON_OBJECT_SIZE(7)                   // epd, epd.fb
+      + JSON_OBJECT_SIZE(4)                                         // oled
+      + JSON_OBJECT_SIZE(11)                                        // power
+      + JSON_ARRAY_SIZE(TASK_STAT_COUNT) + TASK_STAT_COUNT * JSON_OBJECT_SIZE(4)
+      + ip.length() + text.length() + 2;
+  DynamicJsonDocument doc(capacity);
+  doc["ip"] = ip;
+  doc["text"] = text;
   doc["partialSupported"] = epd_hasPartialUpdate();
   doc["partialEnabled"] = epd_getPartialEnabled();
   doc["epdBusy"] = epd_isBusy();
+
+  EpdStatsSummary sum;
+  epd_stats_summary(sum);
+  EpdJobStats last;
+  JsonObject epd = doc.createNestedObject("epd");
+  epd["jobs"] = sum.jobs;
+  epd["avgFullMs"] = avg_ms(sum.full[EPD_PHASE_TOTAL]);
+  epd["avgPartialMs"] = avg_ms(sum.partial[EPD_PHASE_TOTAL]);
+  if (epd_stats_recent(&last, 1) == 1) {
+    epd["lastType"] = last.type;
+    epd["lastMs"] = last.us[EPD_PHASE_TOTAL] / 1000;
+  }
+
+  // Frame buffer footprint, to weigh heap-hungry features against render speed
+  EpdMemoryInfo mem;
+  epd_getMemoryInfo(mem);
+  JsonObject fb = epd.createNestedObject("fb");
+  fb["mode"] = mem.paged ? "paged" : "full";
+  fb["rows"] = mem.rows;
+  fb["bytes"] = mem.framebuffer;
+  fb["atlasBytes"] = mem.atlas;
+  fb["bandBytes"] = mem.bands;
+  fb["jobBytes"] = mem.jobs;
+  fb["heapPayloads"] = mem.heapPayloads;
+  doc["freeHeap"] = ESP.getFreeHeap();
+
+  // OLED text caches: misses are frames that rendered or measured text
+  OledCacheStats oc;
+  oled_getCacheStats(oc);
+  JsonObject oled = doc.createNestedObject("oled");
+  oled["spriteHits"] = oc.spriteHits;
+  oled["spriteMisses"] = oc.spriteMisses;
+  oled["measureHits"] = oc.measureHits;
+  oled["measureMisses"] = oc.measureMisses;
+
+  // Idle governor: time slept / waited and button wake latency
+  PowerIdleStats ps;
+  power_getIdleStats(ps);
+  JsonObject power = doc.createNestedObject("power");
+  power["lightSleeps"] = ps.lightSleeps;
+  power["sleptMs"] = ps.sleptMs;
+  power["waitedMs"] = ps.waitedMs;
+  power["wakes"] = ps.wakes;
+  power["lastWakeUs"] = ps.lastWakeUs;
+  power["maxWakeUs"] = ps.maxWakeUs;
+  power["slowWakes"] = ps.slowWakes;
+  power["httpRequests"] = ps.httpRequests;
+  power["lastHttpUs"] = ps.lastHttpUs;
+  power["maxHttpUs"] = ps.maxHttpUs;
+  power["slowHttp"] = ps.slowHttp;
+
+  // Task load over the last window; maxUs of "loop" is the worst UI stall
+  TaskStat tasks[TASK_STAT_COUNT];
+  task_stats_read(tasks);
+  JsonArray arr = doc.createNestedArray("tasks");
+  for (const TaskStat &t : tasks) {
+    JsonObject o = arr.createNestedObject();
+    o["name"] = t.name;
+    o["core"] = t.core;
+    o["load"] = t.load;
+    o["maxUs"] = t.maxUs;
+  }
+
+  if (doc.overflowed()) {
+    logger_log("status: JSON document too small (%u bytes)", (unsigned)capacity);
+    send_error(g_server, 500, "status too large");
+    return;
+  }
   String out;
   serializeJson(doc, out);
   g_server->send(200, "application/json", out);
 }
 
+static void add_phases(JsonObject obj, const EpdPhaseAggregate *agg) {
+  for (int p = 0; p < EPD_PHASE_COUNT; ++p) {
+    const EpdPhaseAggregate &a = agg[p];
+    JsonObject ph = obj.createNestedObject(epd_stats_phaseName((EpdStatPhase)p));
+    ph["count"] = a.count;
+    ph["avgMs"] = avg_ms(a);
+    ph["maxMs"] = a.maxUs / 1000.0f;
+    JsonArray hist = ph.createNestedArray("hist");
+    for (int b = 0; b < EPD_STATS_BUCKETS; ++b) hist.add(a.hist[b]);
+  }
+}
+
+// Recent job timings + aggregates (histogram buckets are log2 ms, see "bucketsMs")
+static void handleEpdStats() {
+  if(!g_server) return;
+  static EpdJobStats recent[EPD_STATS_RING];
+  size_t n = epd_stats_recent(recent, EPD_STATS_RING);
+  EpdStatsSummary sum;
+  epd_stats_summary(sum);
+
+  DynamicJsonDocument doc(12288);
+  doc["jobs"] = sum.jobs;
+  JsonArray buckets = doc.createNestedArray("bucketsMs");
+  for (int b = 0; b < EPD_STATS_BUCKETS; ++b) buckets.add(epd_stats_bucketMs(b));
+  add_phases(doc.createNestedObject("full"), sum.full);
+  add_phases(doc.createNestedObject("partial"), sum.partial);
+
+  JsonArray arr = doc.createNestedArray("recent");
+  for (size_t i = 0; i < n; ++i) {
+    const EpdJobStats &j = recent[i];
+    JsonObject o = arr.createNestedObject();
+    o["type"] = j.type;
+    o["source"] = j.source;
+    o["partial"] = j.partial;
+    o["standby"] = j.standby;
+    o["at"] = j.enqueuedMs;
+    o["queueUs"] = j.us[EPD_PHASE_QUEUE];
+    o["rasterUs"] = j.us[EPD_PHASE_RASTER];
+    o["transferUs"] = j.us[EPD_PHASE_TRANSFER];
+    o["busyUs"] = j.us[EPD_PHASE_BUSY];
+    o["totalUs"] = j.us[EPD_PHASE_TOTAL];
+  }
+
+  String out;
+  serializeJson(doc, out);
+  g_server->send(200, "application/json", out);
+}
+
+// --- Screenshot ---
+
+// How long a request waits for a running EPD job before giving up (blocks the loop)
+#define SCREENSHOT_WAIT_MS 500
+
+// Encoder output is collected into TCP-sized pieces; the response headers go
+// out with the first one, so an error can still be sent when nothing was read
+struct ScreenshotOut {
+  img_stream_t img;
+  const char *mime;
+  bool started;
+  size_t fill;
+  uint8_t buf[512];
+};
+
+static void screenshot_flush(ScreenshotOut &out) {
+  if (!out.started) {
+    g_server->setContentLength(CONTENT_LENGTH_UNKNOWN); // chunked
+    g_server->sendHeader("Cache-Control", "no-store");
+    g_server->send(200, out.mime, "");
+    out.started = true;
+  }
+  if (out.fill) g_server->sendContent((const char *)out.buf, out.fill);
+  out.fill = 0;
+}
+
+static void screenshot_write(const uint8_t *data, size_t len, void *ctx) {
+  ScreenshotOut &out = *(ScreenshotOut *)ctx;
+  while (len > 0) {
+    size_t n = std::min(len, sizeof(out.buf) - out.fill);
+    memcpy(out.buf + out.fill, data, n);
+    out.fill += n;
+    data += n;
+    len -= n;
+    if (out.fill == sizeof(out.buf)) screenshot_flush(out);
+  }
+}
+
+static void screenshot_row(const uint8_t *row, int y, void *ctx) {
+  ScreenshotOut &out = *(ScreenshotOut *)ctx;
+  if (y == 0) {
+    img_stream_begin(&out.img, out.img.format, out.img.width, out.img.height, screenshot_write, &out);
+  }
+  img_stream_row(&out.img, row);
+}
+
+// Current frame buffer as PBM (default) or PNG: ?format=png, ?oled=1 appends
+// the OLED below the panel
+static void handleEpdScreenshot() {
+  if(!g_server) return;
+  static ScreenshotOut out;
+  bool withOled = g_server->arg("oled") == "1";
+  out.img.format = g_server->arg("format") == "png" ? IMG_PNG : IMG_PBM;
+  out.img.width = epd_width();
+  out.img.height = epd_snapshotHeight(withOled);
+  out.mime = out.img.format == IMG_PNG ? "image/png" : "image/x-portable-bitmap";
+  out.started = false;
+  out.fill = 0;
+
+  switch (epd_snapshot(screenshot_row, &out, withOled, SCREENSHOT_WAIT_MS)) {
+    case EPD_SNAPSHOT_OK:
+      img_stream_end(&out.img);
+      screenshot_flush(out);
+      g_server->sendContent("");
+      break;
+    case EPD_SNAPSHOT_BUSY:
+      g_server->sendHeader("Retry-After", "1");
+      send_error(g_server, 503, "epd busy");
+      break;
+    case EPD_SNAPSHOT_PAGED:
+      send_error(g_server, 409, "paged frame buffer keeps no frame: set rows 0 with /api/epd/buffer, then redraw");
+      break;
+  }
+}
+
 static void handleLogs() {
   if(!g_server) return;
   const std::deque<String>& logs = logger_getLogs();
@@ -86,7 +307,7 @@ static void handleSetText() {
     String color = g_server->arg("color");
     uint16_t col = GxEPD_BLACK;
     logger_log("SetText (form): %s", text.c_str());
-    epd_displayText(text, col, false);
+    with_http_source([&]() { epd_displayText(text, col, false); });
     send_success(g_server);
     return;
   }
@@ -105,7 +326,7 @@ static void handleSetText() {
   uint16_t col = GxEPD_BLACK;
 
   logger_log("SetText: %s (%s)", txt, color);
-  epd_displayText(String(txt), col, forceFull);
+  with_http_source([&]() { epd_displayText(String(txt), col, forceFull); });
 
   StaticJsonDocument<128> res;
   res["status"] = "ok";
@@ -147,7 +368,8 @@ static void handleImageUpload() {
   }
 
   logger_log("ImageUpload: %dx%d %s", width, height, format);
-  bool ok = epd_drawImageFromBitplanes(width, height, img, format, color, forceFull);
+  bool ok = false;
+  with_http_source([&]() { ok = epd_drawImageFromBitplanes(width, height, img, format, color, forceFull); });
   if (!ok) {
     logger_log("ImageUpload: draw failed");
     send_error(g_server, 400, "invalid image or format");
@@ -163,9 +385,51 @@ static void handleImageUpload() {
   g_server->send(200, "application/json", out);
 }
 
+// {"rows": N} switches the EPD layers to N-row pages, {"rows": 0} to full frame
+#define EPD_BUFFER_WAIT_MS 2000
+static void handleEpdBuffer() {
+  if(!g_server) return;
+  StaticJsonDocument<64> doc;
+  if (deserializeJson(doc, g_server->arg("plain"))) {
+    send_error(g_server, 400, "invalid json");
+    return;
+  }
+  int rows = doc["rows"] | -1;
+  if (rows < 0 || rows > epd_height()) {
+    send_error(g_server, 400, "rows must be 0 (full frame) .. panel height");
+    return;
+  }
+  if (!epd_setFramebufferRows(rows)) {
+    send_error(g_server, 503, "epd queue full");
+    return;
+  }
+  logger_log("EPD buffer: %d rows", rows);
+
+  // Applied between jobs: wait for the outcome, the heap may not fit it
+  EpdMemoryInfo mem;
+  char msg[64];
+  switch (epd_getFramebufferResult(EPD_BUFFER_WAIT_MS)) {
+    case EPD_BUFFER_OK:
+      send_success(g_server, "epd_buffer");
+      break;
+    case EPD_BUFFER_FALLBACK:
+      epd_getMemoryInfo(mem);
+      snprintf(msg, sizeof(msg), "not enough RAM, using %u rows", (unsigned)mem.rows);
+      send_error(g_server, 507, msg);
+      break;
+    case EPD_BUFFER_NO_RAM:
+      send_error(g_server, 507, "not enough RAM for any frame buffer");
+      break;
+    case EPD_BUFFER_PENDING:
+      // Still applied later; the size in use shows in /status (epd.fb)
+      g_server->send(202, "application/json", "{\"status\":\"queued\",\"action\":\"epd_buffer\"}");
+      break;
+  }
+}
+
 static void handleClear() {
   logger_log("Cmd: Clear");
-  epd_clear();
+  with_http_source([]() { epd_clear(); });
   if(g_server) send_success(g_server, "cleared");
 }
 
@@ -185,6 +449,9 @@ static void dashboard_registerRoutes(void* serverPtr) {
     
     g_server->on("/status", HTTP_GET, handleStatus);
     g_server->on("/logs", HTTP_GET, handleLogs);
+    g_server->on("/api/epd/stats", HTTP_GET, handleEpdStats);
+    g_server->on("/api/epd/buffer", HTTP_POST, handleEpdBuffer);
+    g_server->on("/api/epd/screenshot", HTTP_GET, handleEpdScreenshot);
     g_server->on("/text", HTTP_POST, handleSetText);
     g_server->on("/image", HTTP_POST, handleImageUpload);
     g_server->on("/button/next", HTTP_POST, handleButtonNext);
@@ -213,6 +480,7 @@ static void dashboard_registerRoutes(void* serverPtr) {
         int width = doc["width"] | 0;
         int height = doc["height"] | 0;
         const char* data_b64 = doc["data"] | "";
+        const char* format = doc["format"] | "bw";
         
         if (width <= 0 || height <= 0 || strlen(data_b64) == 0) {
             send_error(g_server, 400, "missing fields");
@@ -226,31 +494,21 @@ static void dashboard_registerRoutes(void* serverPtr) {
             return;
         }
         
-        // Save to LittleFS
-        File f = LittleFS.open("/wallpaper.bin", "w");
-        if (!f) {
-            logger_log("Wallpaper: failed to open file");
-            send_error(g_server, 500, "failed to save");
+        // Validates, compresses and writes /wallpaper.bin
+        if (!epd_saveWallpaper(width, height, img, format)) {
+            logger_log("Wallpaper: invalid image or write failed");
+            send_error(g_server, 400, "invalid image or failed to save");
             return;
         }
         
-        // Write header: width (2 bytes), height (2 bytes), then data
-        uint8_t header[4];
-        header[0] = (width >> 8) & 0xFF;
-        header[1] = width & 0xFF;
-        header[2] = (height >> 8) & 0xFF;
-        header[3] = height & 0xFF;
-        f.write(header, 4);
-        f.write(img.data(), img.size());
-        f.close();
-        
-        logger_log("Wallpaper saved: %dx%d", width, height);
+        logger_log("Wallpaper saved: %dx%d %s", width, height, format);
         send_success(g_server, "wallpaper_saved");
     });
     
     g_server->on("/api/wallpaper/delete", HTTP_POST, [](){
         if (LittleFS.exists("/wallpaper.bin")) {
             LittleFS.remove("/wallpaper.bin");
+            epd_invalidateWallpaper();
             logger_log("Wallpaper deleted");
         }
         if(g_server) send_success(g_server, "wallpaper_deleted");
@@ -299,6 +557,5 @@ const App APP_DASHBOARD = {
     .renderPreview = dashboard_renderPreview,
     .onSelect = dashboard_onSelect,
     .setup = nullptr,
-    .registerRoutes = dashboard_registerRoutes,
-    .poll = nullptr
+    .registerRoutes = dashboard_registerRoutes
 };
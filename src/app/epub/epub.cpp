@@ -1,9 +1,11 @@
 #include "epub.h"
 #include "../ui/ui.h"
+#include "../ui/ui_internal.h"
 #include "drivers/oled/oled.h"
 #include "drivers/epaper/display.h"
 #include "drivers/epaper/layout.h"
 #include "app/ui/common/types.h"
+#include "app/power/power.h"
 #include "utils/logger/logger.h"
 #include <LittleFS.h>
 #include <WebServer.h>
@@ -30,34 +32,78 @@ static struct {
     int chapterIndex = 0;
     int prevChapterIndex = 0;
     
-    // Current Chapter
-    String currentChapterText; // Stripped text
+    // Current Chapter: one paragraph over the stripped text, split into
+    // screens by the EPD layout pass
+    EpdPage chapter;
+    EpdLayout chapterLayout;
     int pageIndex = 0;
     int totalPages = 1;
     
     bool isLoading = false;
+    bool reading = false;     // read view (or its chapter list) is open
+    uint8_t partialTurns = 0; // partial page turns since the last full refresh
 } s_state;
 
+// Page turns use a partial refresh (when enabled); every Nth turn is a full
+// refresh to clear the ghosting
+static const uint8_t FULL_REFRESH_EVERY = 10;
+
+// Opening a book or a chapter runs as a UI job (ui_runAsync): the worker
+// fills this from the ZIP, the UI task then swaps it into s_state
+static struct {
+    String book;
+    String name;              // chapter entry in the ZIP
+    bool open = false;        // index the book and restore the saved position first
+    vector<String> spine;     // open only
+    int chapter = 0;
+    int page = 0;
+    bool pageTurn = false;    // refresh as a page turn (partial)
+    const View* from = NULL;  // view the load was started from
+    const View* then = NULL;  // view to show once loaded (if still on `from`)
+    EpdPage text;
+    EpdLayout layout;
+    int pages = 1;
+} s_load;
+
 // --- Helper Prototypes ---
 static void loadBookList();
-static bool indexBook(const String& path); // Parse OPF/Spine
-static void loadChapter(int index);
+static bool indexBook(const String& path, vector<String>& spine); // Parse OPF/Spine
+static void readChapter(const String& book, const String& name, EpdPage& out);
+static void loadChapter(int index, int page = 0);
+static void loadChapterAsync(int index, bool pageTurn, const View* then);
 static void renderRead(int16_t x, int16_t y);
 static void renderPage();
+static void updateEpaper(bool pageTurn = false);
 static void saveProgress();
-static void loadProgress();
+static void readProgress(const String& book, size_t chapters, int& chapter, int& page);
 
 // --- Views ---
 
+// File name of `path` without the first matching extension in `exts`
+// (NULL-terminated). No allocation: list items are drawn every frame.
+static void baseName(const String& path, const char* const* exts, char* out, size_t size) {
+    int slash = path.lastIndexOf('/');
+    const char* name = path.c_str() + slash + 1;
+    size_t len = strlen(name);
+    for (; *exts; ++exts) {
+        size_t n = strlen(*exts);
+        if (len >= n && strcmp(name + len - n, *exts) == 0) {
+            len -= n;
+            break;
+        }
+    }
+    if (len >= size) len = size - 1;
+    memcpy(out, name, len);
+    out[len] = '\0';
+}
+
 // 1. Book List View
 static void render_book_item(int index, int16_t x, int16_t y) {
     if (index < 0 || index >= s_state.bookList.size()) return;
-    String title = s_state.bookList[index];
-    int lastSlash = title.lastIndexOf('/');
-    if (lastSlash >= 0) title = title.substring(lastSlash + 1);
-    if (title.endsWith(".epub")) title = title.substring(0, title.length() - 5);
-    
-    oled_drawBigText(title.c_str(), x, y, false, true);
+    static const char* const EXTS[] = {".epub", NULL};
+    char title[96];
+    baseName(s_state.bookList[index], EXTS, title, sizeof(title));
+    oled_drawBigText(title, x, y, false, true);
 }
 
 static void renderBookList(int16_t x, int16_t y) {
@@ -104,20 +150,70 @@ static void onBookListBack() {
 // Forward declare
 extern const View viewRead;
 
+// App worker: index the book, restore the last position, read its chapter
+static bool openBookWork(void*) {
+    if (!indexBook(s_load.book, s_load.spine)) return false;
+    readProgress(s_load.book, s_load.spine.size(), s_load.chapter, s_load.page);
+    readChapter(s_load.book, s_load.spine[s_load.chapter], s_load.text);
+    s_load.pages = (int)epd_layout_paginate(s_load.text, s_load.layout);
+    return true;
+}
+
+// App worker: read and lay out the chapter in s_load
+static bool loadChapterWork(void*) {
+    readChapter(s_load.book, s_load.name, s_load.text);
+    s_load.pages = (int)epd_layout_paginate(s_load.text, s_load.layout);
+    return true;
+}
+
+// UI task: swap the loaded chapter in, refresh the panel, switch views
+static void loadDone(bool ok, void*) {
+    if (!ok) {
+        oled_showToast("Error", 1500);
+    } else {
+        if (s_load.open) {
+            s_state.currentBookPath = s_load.book;
+            s_state.currentTitle = s_load.book.substring(s_load.book.lastIndexOf('/') + 1);
+            if (s_state.currentTitle.endsWith(".epub"))
+                s_state.currentTitle = s_state.currentTitle.substring(0, s_state.currentTitle.length() - 5);
+            s_state.spine.swap(s_load.spine);
+        }
+        s_state.chapterIndex = s_load.chapter;
+        std::swap(s_state.chapter, s_load.text);
+        std::swap(s_state.chapterLayout, s_load.layout);
+        s_state.totalPages = s_load.pages;
+        int page = s_load.page;
+        s_state.pageIndex = page < 0 ? 0 : (page >= s_state.totalPages ? s_state.totalPages - 1 : page);
+
+        updateEpaper(s_load.pageTurn);
+        saveProgress(); // checkpoints
+        if (s_load.then && ui_getView() == s_load.from) {
+            if (s_load.then == &viewRead) s_state.reading = true;
+            ui_setView(s_load.then);
+        }
+    }
+    s_load.spine.clear();
+    s_load.text = EpdPage();
+    s_load.layout = EpdLayout();
+}
+
 static void onBookListSelect() {
     if (s_state.bookList.empty()) return;
-    
-    s_state.currentBookPath = s_state.bookList[s_state.bookIndex];
-    oled_showStatus("Opening...");
-    
-    if (indexBook(s_state.currentBookPath)) {
-        loadProgress(); // Restore last position
-        loadChapter(s_state.chapterIndex);
-        ui_setView(&viewRead);
-    } else {
-        oled_showStatus("Error");
-        delay(1000);
+    // One app job at a time (a feed refresh may hold the worker)
+    if (ui_isLoading()) {
+        if (oled_isAvailable()) oled_showToast("Busy...", 800);
+        return;
     }
+
+    s_load.book = s_state.bookList[s_state.bookIndex];
+    s_load.open = true;
+    s_load.chapter = s_load.page = 0;
+    s_load.pageTurn = false;
+    s_load.from = ui_getView();
+    s_load.then = &viewRead;
+    s_load.text = EpdPage();
+    s_load.layout = EpdLayout();
+    ui_runAsync("Opening...", openBookWork, loadDone, NULL);
 }
 
 static const View viewBookList = {
@@ -128,106 +224,34 @@ static const View viewBookList = {
     .onSelect = onBookListSelect,
     .onBack = onBookListBack, 
     .poll = NULL,
-    .getScrollProgress = []() -> float { 
-        if(s_state.bookList.empty()) return 0.0f;
-        return (float)(s_state.bookIndex + 1) / (float)s_state.bookList.size();
+    .getScrollProgress = []() -> q16_t {
+        if(s_state.bookList.empty()) return 0;
+        return q16_div(s_state.bookIndex + 1, (int32_t)s_state.bookList.size());
     }
 };
 
 // 2. Read View (Main Reader)
 
 
-static void updateEpaper() {
-    if (s_state.currentChapterText.length() == 0) {
+static void updateEpaper(bool pageTurn) {
+    if (s_state.chapter.components.empty()) {
         epd_displayText("Empty Chapter", 0);
         return;
     }
     
-    // Display: 296x128 pixels (VERTICAL: 296 height, 128 width)
-    // Using profont12 (~6x10): 128px / 6 = ~21 chars/line, 296px / 10 = ~29 lines
-    // But EPD_COMP_ROW has margins, so reduce both. 19 chars to avoid clipping.
-    const int CHARS_PER_LINE = 19;
-    const int LINES_PER_PAGE = 24;
-    const int CHARS_PER_PAGE = CHARS_PER_LINE * LINES_PER_PAGE;
-    
-    int start = s_state.pageIndex * CHARS_PER_PAGE;
-    if (start >= s_state.currentChapterText.length()) {
-        start = 0;
-        s_state.pageIndex = 0;
-    }
-    
-    // Extract text for this page
-    int end = start + CHARS_PER_PAGE;
-    if (end < s_state.currentChapterText.length()) {
-        // Try to break at sentence end
-        int sentenceEnd = s_state.currentChapterText.lastIndexOf('.', end);
-        if (sentenceEnd > start && sentenceEnd - start > CHARS_PER_PAGE * 0.7) {
-            end = sentenceEnd + 1;
-        } else {
-            // Break at word boundary
-            int spacePos = s_state.currentChapterText.lastIndexOf(' ', end);
-            if (spacePos > start && spacePos - start > CHARS_PER_PAGE * 0.5) {
-                end = spacePos;
-            }
-        }
-    } else {
-        end = s_state.currentChapterText.length();
-    }
-    
-    String pageText = s_state.currentChapterText.substring(start, end);
-    pageText.trim();
-    
-    // Create EpdPage with text content as multiple rows
-    EpdPage page;
-    page.title = "";
-    
-    // Split text into lines manually
-    int pos = 0;
-    int lineCount = 0;
-    while (pos < pageText.length() && lineCount < LINES_PER_PAGE) {
-        int lineEnd = pos + CHARS_PER_LINE;
-        String line;
-        
-        if (lineEnd >= pageText.length()) {
-            line = pageText.substring(pos);
-            pos = pageText.length();
-        } else {
-            // Find last space before lineEnd
-            int spacePos = pageText.lastIndexOf(' ', lineEnd);
-            if (spacePos > pos && spacePos - pos > CHARS_PER_LINE * 0.6) {
-                line = pageText.substring(pos, spacePos);
-                pos = spacePos + 1;
-            } else {
-                line = pageText.substring(pos, lineEnd);
-                pos = lineEnd;
-            }
-        }
-        
-        // Add line as a simple row component (using text1 only, no text2)
-        EpdComponent comp;
-        comp.type = EPD_COMP_ROW;
-        comp.text1 = line;
-        comp.text2 = "";
-        comp.value = 0;
-        comp.color = GxEPD_BLACK;
-        page.components.push_back(comp);
-        lineCount++;
-    }
-    
-    epd_displayPage(page);
+    bool forceFull = !pageTurn || s_state.partialTurns >= FULL_REFRESH_EVERY;
+    s_state.partialTurns = forceFull ? 0 : s_state.partialTurns + 1;
+    epd_displayPageScreen(s_state.chapter, s_state.chapterLayout, s_state.pageIndex, forceFull);
 }
 
 static void onReadNext() {
     if (s_state.pageIndex < s_state.totalPages - 1) {
         s_state.pageIndex++;
-        updateEpaper();
+        updateEpaper(true);
     } else {
         // Next chapter
         if (s_state.chapterIndex < s_state.spine.size() - 1) {
-            s_state.chapterIndex++;
-            oled_showStatus("Loading...");
-            loadChapter(s_state.chapterIndex);
-            saveProgress(); // checkpoints
+            loadChapterAsync(s_state.chapterIndex + 1, true, NULL);
         }
     }
 }
@@ -235,16 +259,13 @@ static void onReadNext() {
 static void onReadPrev() {
     if (s_state.pageIndex > 0) {
         s_state.pageIndex--;
-        updateEpaper();
+        updateEpaper(true);
     } else {
         // Prev chapter
         if (s_state.chapterIndex > 0) {
-            s_state.chapterIndex--;
-            oled_showStatus("Loading...");
-            loadChapter(s_state.chapterIndex);
             // Go to last page of new chapter?
             // For now start at 0
-            saveProgress();
+            loadChapterAsync(s_state.chapterIndex - 1, true, NULL);
         }
     }
 }
@@ -263,27 +284,20 @@ const View viewRead = {
     .onNext = onReadNext,
     .onPrev = onReadPrev,
     .onSelect = onReadSelect,
-    .onBack = [](){ saveProgress(); ui_setView(&viewBookList); }, // Back to book list
+    .onBack = [](){ saveProgress(); s_state.reading = false; ui_setView(&viewBookList); }, // Back to book list
     .poll = NULL,
-    .getScrollProgress = []() -> float { 
-        if (s_state.totalPages <= 1) return 0.0f;
-        return (float)s_state.pageIndex / (float)(s_state.totalPages - 1);
+    .getScrollProgress = []() -> q16_t {
+        if (s_state.totalPages <= 1) return 0;
+        return q16_div(s_state.pageIndex, s_state.totalPages - 1);
     }
 };
 
 static void render_chapter_item(int index, int16_t x, int16_t y) {
     if(index < 0 || index >= s_state.spine.size()) return;
-    String name = s_state.spine[index];
-    // Strip path
-    int idx = name.lastIndexOf('/');
-    if (idx >= 0) name = name.substring(idx+1);
-
-    // Remove extension
-    if (name.endsWith(".html")) name = name.substring(0, name.length() - 5);
-    else if (name.endsWith(".xhtml")) name = name.substring(0, name.length() - 6);
-    else if (name.endsWith(".htm")) name = name.substring(0, name.length() - 4);
-    
-    oled_drawBigText(name.c_str(), x, y, false, true);
+    static const char* const EXTS[] = {".html", ".xhtml", ".htm", NULL};
+    char name[96];
+    baseName(s_state.spine[index], EXTS, name, sizeof(name));
+    oled_drawBigText(name, x, y, false, true);
 }
 
 // 3. Chapter List View
@@ -312,10 +326,7 @@ static void onChapterPrev() {
 }
 
 static void onChapterSelect() {
-    oled_showStatus("Loading...");
-    loadChapter(s_state.chapterIndex);
-    saveProgress();
-    ui_setView(&viewRead);
+    loadChapterAsync(s_state.chapterIndex, false, &viewRead);
 }
 
 const View viewChapterList = {
@@ -326,9 +337,9 @@ const View viewChapterList = {
     .onSelect = onChapterSelect,
     .onBack = [](){ ui_setView(&viewRead); }, // Back to read
     .poll = NULL,
-    .getScrollProgress = []() -> float {
-        if (s_state.spine.empty()) return 0.0f;
-        return (float)s_state.chapterIndex / (float)s_state.spine.size();
+    .getScrollProgress = []() -> q16_t {
+        if (s_state.spine.empty()) return 0;
+        return q16_div(s_state.chapterIndex, (int32_t)s_state.spine.size());
     }
 };
 
@@ -348,8 +359,7 @@ const App APP_EPUB = {
     .renderPreview = app_renderPreview,
     .onSelect = app_onSelect,
     .setup = nullptr,
-    .registerRoutes = EpubApp::registerRoutes,
-    .poll = NULL
+    .registerRoutes = EpubApp::registerRoutes
 };
 
 // --- Helpers Implementation ---
@@ -385,11 +395,9 @@ static void loadBookList() {
 // Optimization: Check if /tmp_book/ is already this book?
 // MOCK REMOVED - Real ZIP Scanner
 // Better ZIP Scanner: Read Central Directory
-static bool indexBook(const String& path) {
-    s_state.spine.clear();
-    s_state.currentTitle = path.substring(path.lastIndexOf('/')+1);
-    if(s_state.currentTitle.endsWith(".epub")) 
-        s_state.currentTitle = s_state.currentTitle.substring(0, s_state.currentTitle.length()-5);
+// Fills `spine` only (runs on the app worker when opening a book)
+static bool indexBook(const String& path, vector<String>& spine) {
+    spine.clear();
 
     ZipReader reader;
     if (!reader.open(path)) {
@@ -408,7 +416,7 @@ static bool indexBook(const String& path) {
              if (count % 5 == 0) {
                  logger_log("EPUB: Found ch %d: %s (Heap: %d)", count, name.c_str(), ESP.getFreeHeap());
              }
-             s_state.spine.push_back(name);
+             spine.push_back(name);
              count++;
              
              // Safety limit for now to see if it's purely memory capacity
@@ -420,14 +428,14 @@ static bool indexBook(const String& path) {
         return true;
     });
     
-    logger_log("EPUB: Index done. Chapters: %d. Heap: %d", s_state.spine.size(), ESP.getFreeHeap());
+    logger_log("EPUB: Index done. Chapters: %d. Heap: %d", spine.size(), ESP.getFreeHeap());
     
     reader.close();
     
-    std::sort(s_state.spine.begin(), s_state.spine.end());
-    logger_log("EPUB: Found %d chapters", s_state.spine.size());
+    std::sort(spine.begin(), spine.end());
+    logger_log("EPUB: Found %d chapters", spine.size());
     
-    return !s_state.spine.empty();
+    return !spine.empty();
 }
 
 // 2. Read View (Main Reader)
@@ -480,11 +488,12 @@ static void saveProgress() {
     }
 }
 
-static void loadProgress() {
-    if(s_state.currentBookPath.length() == 0) return;
+// Saved position of `book` (left unchanged when there is none)
+static void readProgress(const String& book, size_t chapters, int& chapter, int& page) {
+    if(book.length() == 0) return;
      unsigned long hash = 5381;
-    for(unsigned int i=0; i<s_state.currentBookPath.length(); i++) 
-        hash = ((hash << 5) + hash) + s_state.currentBookPath.charAt(i);
+    for(unsigned int i=0; i<book.length(); i++) 
+        hash = ((hash << 5) + hash) + book.charAt(i);
         
     String p = "/progress/" + String(hash) + ".json";
     if(LittleFS.exists(p)) {
@@ -492,24 +501,22 @@ static void loadProgress() {
         if(f) {
              StaticJsonDocument<128> doc;
              deserializeJson(doc, f);
-             s_state.chapterIndex = doc["chapter"] | 0;
-             s_state.pageIndex = doc["page"] | 0;
+             chapter = doc["chapter"] | 0;
+             page = doc["page"] | 0;
              f.close();
              
              // Validate
-             if(s_state.chapterIndex >= s_state.spine.size()) s_state.chapterIndex = 0;
+             if(chapter < 0 || chapter >= (int)chapters) chapter = 0;
         }
     }
 }
 
 
 
-static void loadChapter(int index) {
-    if (index < 0 || index >= s_state.spine.size()) return;
-    
-    String chName = s_state.spine[index];
-    logger_log("EPUB: Loading chapter %d: %s", index, chName.c_str());
-    oled_showStatus("Loading...");
+// Read chapter `name` of `book` as one paragraph of plain text (blocking:
+// ZIP inflate and HTML strip)
+static void readChapter(const String& book, const String& chName, EpdPage& out) {
+    logger_log("EPUB: Loading chapter %s", chName.c_str());
     
     uint8_t* rawBuf = NULL;
     size_t rawSize = 0;
@@ -517,7 +524,7 @@ static void loadChapter(int index) {
     bool success = false;
     
     logger_log("EPUB: Opening ZIP...");
-    if (reader.open(s_state.currentBookPath)) {
+    if (reader.open(book)) {
         logger_log("EPUB: ZIP opened, calling readBinary...");
         success = reader.readBinary(chName, &rawBuf, &rawSize);
         logger_log("EPUB: readBinary returned: %d", success);
@@ -526,6 +533,7 @@ static void loadChapter(int index) {
         logger_log("EPUB: Failed to open ZIP");
     }
     
+    out = EpdPage();
     if (success && rawBuf && rawSize > 0) {
          logger_log("EPUB: Loaded %d bytes, heap: %d", rawSize, ESP.getFreeHeap());
          
@@ -538,37 +546,85 @@ static void loadChapter(int index) {
          logger_log("EPUB: HTML stripped, assigning to String...");
          // Now rawBuf contains the stripped text
          // We can now assign it to String, or better yet, if we can keep it as char*?
-         // s_state.currentChapterText is a String.
+         // The chapter buffer (EpdPage::text) is a String.
          // Assigning char* to String will copy it.
          // But at least we didn't have 3 copies in memory at once (Raw+String+Result).
          // We only had Raw -> (processed in place) -> Copy to String.
          // Still 2 copies effectively for a moment, but avoiding the big intermediate "HTML String" object.
          
-         s_state.currentChapterText = (char*)rawBuf;
-         
-         logger_log("EPUB: String assigned");
-         size_t plainSize = s_state.currentChapterText.length();
-         logger_log("EPUB: After strip: %d bytes (was %d)", plainSize, rawSize);
+         // The stripper leaves one '\n' per block tag: fold whitespace runs
+         // into single spaces and empty blocks away, so each '\n' left
+         // separates two source paragraphs
+         char* text = (char*)rawBuf;
+         size_t len = 0;
+         bool space = true; // also drops leading whitespace
+         for (const char* p = text; *p; ++p) {
+             char ch = *p;
+             if (ch == '\n') {
+                 while (len > 0 && text[len - 1] == ' ') len--;
+                 if (len > 0 && text[len - 1] != '\n') text[len++] = '\n';
+                 space = true;
+                 continue;
+             }
+             if (ch == ' ' && space) continue;
+             space = ch == ' ';
+             text[len++] = ch;
+         }
+         while (len > 0 && (text[len - 1] == ' ' || text[len - 1] == '\n')) len--;
+         text[len] = '\0';
+
+         // One paragraph component per source paragraph
+         out.text = std::make_shared<String>();
+         out.text->reserve(len);
+         for (char* start = text; len > 0 && *start; ) {
+             char* brk = strchr(start, '\n');
+             if (brk) *brk = '\0';
+             epd_page_addParagraph(out, String(start), GxEPD_BLACK);
+             if (!brk) break;
+             start = brk + 1;
+         }
+         logger_log("EPUB: After strip: %d bytes (was %d)", len, rawSize);
          
          free(rawBuf); // Modified buffer is freed
     } else {
          logger_log("EPUB: Failed to load chapter");
-         s_state.currentChapterText = "Error loading chapter: " + chName;
+         epd_page_addParagraph(out, "Error loading chapter: " + chName, GxEPD_BLACK);
          if (rawBuf) free(rawBuf);
     }
+}
 
-    // Clean HTML tags (basic strip)
-    // TODO: Implement proper HTML tag stripping
-    
-    s_state.pageIndex = 0;
-    // Calculate pages (must match updateEpaper constants)
-    const int CHARS_PER_LINE = 19;
-    const int LINES_PER_PAGE = 24;
-    const int CHARS_PER_PAGE = CHARS_PER_LINE * LINES_PER_PAGE; // 456
-    s_state.totalPages = (s_state.currentChapterText.length() + CHARS_PER_PAGE - 1) / CHARS_PER_PAGE;
-    if (s_state.totalPages < 1) s_state.totalPages = 1;
-    
-    updateEpaper();
+// Load chapter `index` and go to `page` (clamped), blocking. Does not redraw
+// the panel (resume path, before the UI runs).
+static void loadChapter(int index, int page) {
+    if (index < 0 || index >= s_state.spine.size()) return;
+
+    s_state.chapterIndex = index;
+    readChapter(s_state.currentBookPath, s_state.spine[index], s_state.chapter);
+    s_state.chapterLayout = EpdLayout();
+    s_state.totalPages = (int)epd_layout_paginate(s_state.chapter, s_state.chapterLayout);
+    s_state.pageIndex = page < 0 ? 0 : (page >= s_state.totalPages ? s_state.totalPages - 1 : page);
+}
+
+// Load chapter `index` on the app worker, then show its first page (and
+// switch to `then`, if not NULL)
+static void loadChapterAsync(int index, bool pageTurn, const View* then) {
+    if (index < 0 || index >= s_state.spine.size()) return;
+    if (ui_isLoading()) {
+        if (oled_isAvailable()) oled_showToast("Busy...", 800);
+        return;
+    }
+
+    s_load.book = s_state.currentBookPath;
+    s_load.name = s_state.spine[index];
+    s_load.open = false;
+    s_load.chapter = index;
+    s_load.page = 0;
+    s_load.pageTurn = pageTurn;
+    s_load.from = ui_getView();
+    s_load.then = then;
+    s_load.text = EpdPage();
+    s_load.layout = EpdLayout();
+    ui_runAsync("Loading...", loadChapterWork, loadDone, NULL);
 }
 
 
@@ -576,6 +632,43 @@ static void loadChapter(int index) {
 
 namespace EpubApp {
 
+bool isReading() {
+    return s_state.reading;
+}
+
+void saveResumeState(PowerResumeState& state) {
+    if (!s_state.reading || s_state.currentBookPath.length() >= sizeof(state.book)) return;
+    saveProgress();
+    state.view = POWER_VIEW_READER;
+    strncpy(state.book, s_state.currentBookPath.c_str(), sizeof(state.book) - 1);
+    state.chapter = s_state.chapterIndex;
+    state.page = s_state.pageIndex;
+    state.partialTurns = s_state.partialTurns;
+}
+
+bool resume(const PowerResumeState& state) {
+    if (state.view != POWER_VIEW_READER) return false;
+
+    loadBookList();
+    String path = state.book;
+    for (size_t i = 0; i < s_state.bookList.size(); ++i) {
+        if (s_state.bookList[i] == path) s_state.bookIndex = i;
+    }
+    s_state.currentBookPath = path;
+    if (!indexBook(path, s_state.spine) || state.chapter >= s_state.spine.size()) {
+        s_state.currentBookPath = "";
+        return false;
+    }
+
+    // The panel still shows this page: load the text, don't redraw
+    s_state.chapterIndex = state.chapter;
+    loadChapter(s_state.chapterIndex, state.page);
+    s_state.partialTurns = state.partialTurns;
+    s_state.reading = true;
+    ui_restoreApp(state.appIndex, &viewRead);
+    return true;
+}
+
 void registerRoutes(void* serverPtr) {
     WebServer* server = (WebServer*)serverPtr;
     
@@ -630,6 +723,7 @@ void registerRoutes(void* serverPtr) {
                 logger_log("Upload Start: %s", path.c_str());
             }
         } else if (upload.status == UPLOAD_FILE_WRITE) {
+            power_noteActivity(); // don't sleep in the middle of an upload
             if (uploadFile) {
                 uploadFile.write(upload.buf, upload.currentSize);
             }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../ui/common/types.h"
+#include "../power/power.h"
 #include <vector>
 #include <Arduino.h>
 
@@ -10,4 +11,9 @@ extern const App APP_EPUB;
 // Public API for server routes
 namespace EpubApp {
     void registerRoutes(void* serverPtr); // Pass WebServer* as void* to avoid include cycles
+
+    // Deep-sleep resume (see app/power)
+    bool isReading();                                 // a book is open in the reader
+    void saveResumeState(PowerResumeState& state);    // book / chapter / page, if reading
+    bool resume(const PowerResumeState& state);       // reopen the read view without redrawing
 }
@@ -29,14 +29,34 @@ static const std::vector<HAShoppingItem>& getCurrentList() {
 
 static void update_epaper();
 
-static void fetch_data(bool update_epd = false) {
-    if (oled_isAvailable()) oled_showToast("Syncing List...", 1000);
-    if (HAService::getInstance().fetchList()) {
+// Jobs (see ui_runAsync): inputs and results, owned by the job in flight
+static std::vector<HAShoppingItem> s_fetchedActive, s_fetchedCompleted;
+static bool s_syncUpdateEpd = false;
+static String s_toggleId;
+static bool s_toggleState = false;
+
+// App worker
+static bool sync_work(void*) {
+    return HAService::getInstance().fetchList(s_fetchedActive, s_fetchedCompleted);
+}
+
+// UI task
+static void sync_done(bool ok, void*) {
+    if (ok) {
+        HAService::getInstance().setLists(s_fetchedActive, s_fetchedCompleted);
+        if (s_mode != MODE_MENU && s_index >= getCurrentList().size()) s_index = s_prevIndex = 0;
         if (oled_isAvailable()) oled_showToast("List Updated", 800);
-        if (update_epd) update_epaper();
+        if (s_syncUpdateEpd) update_epaper();
     } else {
         if (oled_isAvailable()) oled_showToast("Sync Failed", 1500);
     }
+    s_fetchedActive.clear();
+    s_fetchedCompleted.clear();
+}
+
+static void fetch_data(bool update_epd = false) {
+    // done() runs on this (UI) task, so setting the flag after submitting is safe
+    if (ui_runAsync("Syncing List...", sync_work, sync_done, NULL)) s_syncUpdateEpd = update_epd;
 }
 
 // --- Menu View ---
@@ -100,7 +120,7 @@ static const View VIEW_HA_MENU = {
 static void render_item(uint8_t index, int16_t x, int16_t y) {
     const auto& items = getCurrentList();
     if (items.empty()) {
-        oled_drawBigText("Empty List", x, y, false);
+        oled_drawBigText(ui_isLoading() ? "Loading" : "Empty List", x, y, false);
         return;
     }
     
@@ -184,23 +204,35 @@ static void view_prev(void) {
     ui_triggerVerticalAnimation(false);
 }
 
+// App worker
+static bool toggle_work(void*) {
+    return HAService::getInstance().setComplete(s_toggleId, s_toggleState);
+}
+
+// UI task
+static void toggle_done(bool ok, void*) {
+    if (ok) {
+        // Success
+        const auto& items = getCurrentList();
+        if (s_index >= items.size() - 1 && s_index > 0) {
+            s_index--;
+        }
+        fetch_data(true); // Refetch and update EPD
+    } else {
+        if (oled_isAvailable()) oled_showToast("Failed", 1000);
+    }
+}
+
 static void view_select(void) {
     const auto& items = getCurrentList();
     if (s_index < items.size()) {
-        const auto& item = items[s_index];
-        bool targetState = (s_mode == MODE_ACTIVE); // If Active, we want to complete (true). If Completed, uncomplete (false).
-        
-        if (oled_isAvailable()) oled_showToast(targetState ? "Completing..." : "Restoring...", 1000);
-        
-        if (HAService::getInstance().setComplete(item.id, targetState)) {
-             // Success
-            if (s_index >= items.size() - 1 && s_index > 0) {
-                s_index--;
-            }
-            fetch_data(true); // Refetch and update EPD
-        } else {
-            if (oled_isAvailable()) oled_showToast("Failed", 1000);
+        if (ui_isLoading()) {
+            if (oled_isAvailable()) oled_showToast("Busy...", 800);
+            return;
         }
+        s_toggleId = items[s_index].id;
+        s_toggleState = (s_mode == MODE_ACTIVE); // If Active, we want to complete (true). If Completed, uncomplete (false).
+        ui_runAsync(s_toggleState ? "Completing..." : "Restoring...", toggle_work, toggle_done, NULL);
     } else {
         fetch_data(true); // Refetch
     }
@@ -212,10 +244,10 @@ static void view_back(void) {
     ui_setView(&VIEW_HA_MENU);
 }
 
-static float view_get_progress(void) {
+static q16_t view_get_progress(void) {
     auto count = getCurrentList().size();
-    if (count == 0) return 0.0f;
-    return (float)(s_index + 1) / (float)count;
+    if (count == 0) return 0;
+    return q16_div(s_index + 1, (int32_t)count);
 }
 
 const View VIEW_HA_LIST = {
@@ -253,6 +285,5 @@ extern const App APP_HA_LIST = {
     .renderPreview = app_renderPreview,
     .onSelect = app_select,
     .setup = app_setup,
-    .registerRoutes = nullptr,
-    .poll = nullptr 
+    .registerRoutes = nullptr
 };
@@ -21,7 +21,7 @@ bool HAService::begin(const String& baseUrl, const String& token) {
     return true;
 }
 
-bool HAService::fetchList() {
+bool HAService::fetchList(std::vector<HAShoppingItem>& active, std::vector<HAShoppingItem>& completed) {
     if (!_isInitialized) return false;
     
     String url = _baseUrl + "api/shopping_list";
@@ -48,8 +48,8 @@ bool HAService::fetchList() {
         return false;
     }
     
-    _activeItems.clear();
-    _completedItems.clear();
+    active.clear();
+    completed.clear();
     
     JsonArray arr = doc.as<JsonArray>();
     for (JsonObject item : arr) {
@@ -59,13 +59,13 @@ bool HAService::fetchList() {
         i.complete = item["complete"] | false;
         
         if (i.complete) {
-            _completedItems.push_back(i);
+            completed.push_back(i);
         } else {
-            _activeItems.push_back(i);
+            active.push_back(i);
         }
     }
     
-    logger_log("HA: Fetched %d active, %d completed", _activeItems.size(), _completedItems.size());
+    logger_log("HA: Fetched %d active, %d completed", active.size(), completed.size());
     return true;
 }
 
@@ -15,10 +15,15 @@ public:
     // Initialize with base URL (e.g., http://raspberrypi:8123/) and Long-Lived Token
     bool begin(const String& baseUrl, const String& token);
     
-    // Fetch shopping list from API
-    bool fetchList();
+    // Fetch shopping list from API into `active` / `completed` (blocking: run
+    // it as a UI job). The getters only change through setLists().
+    bool fetchList(std::vector<HAShoppingItem>& active, std::vector<HAShoppingItem>& completed);
+    void setLists(std::vector<HAShoppingItem>& active, std::vector<HAShoppingItem>& completed) {
+        _activeItems.swap(active);
+        _completedItems.swap(completed);
+    }
 
-    // Mark an item as complete or incomplete
+    // Mark an item as complete or incomplete (blocking)
     bool setComplete(const String& itemId, bool complete);
     
     // Getters for filtered lists
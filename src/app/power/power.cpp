@@ -0,0 +1,252 @@
+/*
+  power.cpp
+
+  Idle deep sleep with button wake and RTC-memory resume state, and the
+  light-sleep idle governor for loop() (see power.h).
+*/
+
+#include "power.h"
+#include "config.h"
+#include "drivers/epaper/display.h"
+#include "drivers/oled/oled.h"
+#include "utils/logger/logger.h"
+
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include <driver/rtc_io.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <string.h>
+
+#define POWER_MAX_DEADLINES 8
+
+// Survives deep sleep (initialized on cold boot only)
+struct PowerRtc {
+  bool valid;              // `resume` was saved before the last sleep
+  bool sleepEnabled;
+  bool partialEnabled;     // epd_setPartialEnabled() is not persisted otherwise
+  PowerResumeState resume;
+};
+RTC_DATA_ATTR static PowerRtc s_rtc = {false, ENABLE_DEEP_SLEEP, ENABLE_PARTIAL_UPDATE, {}};
+
+static bool s_resume = false;
+static int s_wakePin = -1;
+static uint32_t s_lastActivity = 0;
+static power_save_cb_t s_saveCb = nullptr;
+static power_wake_cb_t s_wakeCb = nullptr;
+static power_deadline_cb_t s_deadlines[POWER_MAX_DEADLINES];
+static size_t s_deadlineCount = 0;
+static PowerIdleStats s_idleStats = {};
+static bool s_radioOn = false;
+static SemaphoreHandle_t s_statsMutex = NULL;
+
+// s_idleStats is written by the loop task (power_idle) and the UI task
+// (power_noteWakeLatency); power_init() creates the mutex before either runs.
+static bool _lockStats(void) {
+  return s_statsMutex && xSemaphoreTake(s_statsMutex, pdMS_TO_TICKS(50)) == pdTRUE;
+}
+
+static void _unlockStats(void) {
+  xSemaphoreGive(s_statsMutex);
+}
+
+void power_init(void) {
+  if (s_statsMutex == NULL) s_statsMutex = xSemaphoreCreateMutex();
+  s_resume = false;
+  s_wakePin = -1;
+  s_lastActivity = millis();
+
+  if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT1) {
+    uint64_t status = esp_sleep_get_ext1_wakeup_status();
+    for (int pin = 0; pin < 64; ++pin) {
+      if (status & (1ULL << pin)) {
+        s_wakePin = pin;
+        break;
+      }
+    }
+    s_resume = s_rtc.valid;
+    epd_setPartialEnabled(s_rtc.partialEnabled);
+    logger_log("power: woke on GPIO %d%s", s_wakePin, s_resume ? ", resuming" : "");
+  }
+  s_rtc.valid = false;
+}
+
+bool power_isResume(void) { return s_resume; }
+int power_wakePin(void) { return s_wakePin; }
+const PowerResumeState &power_resumeState(void) { return s_rtc.resume; }
+void power_setSaveCallback(power_save_cb_t cb) { s_saveCb = cb; }
+void power_noteActivity(void) { s_lastActivity = millis(); }
+
+void power_setSleepEnabled(bool enabled) {
+  s_rtc.sleepEnabled = enabled;
+  s_lastActivity = millis();
+}
+
+bool power_getSleepEnabled(void) { return s_rtc.sleepEnabled; }
+
+// Buttons that can wake the chip (RTC / LP GPIOs only)
+static uint64_t _wakeMask(void) {
+  const uint8_t pins[] = {PIN_BUTTON_PREV, PIN_BUTTON_NEXT, PIN_BUTTON_CONFIRM};
+  uint64_t mask = 0;
+  for (uint8_t pin : pins) {
+    if (esp_sleep_is_valid_wakeup_gpio((gpio_num_t)pin)) mask |= 1ULL << pin;
+  }
+  return mask;
+}
+
+static void _enterSleep(uint64_t mask) {
+  logger_log("power: idle for %lu ms, entering deep sleep", (unsigned long)(millis() - s_lastActivity));
+
+  memset(&s_rtc.resume, 0, sizeof(s_rtc.resume));
+  if (s_saveCb) s_saveCb(s_rtc.resume);
+  s_rtc.partialEnabled = epd_getPartialEnabled();
+  s_rtc.valid = true;
+
+  // Hibernate keeps the controller RAM, so the first page after the wake
+  // can still use a partial refresh
+  epd_hibernate();
+  uint32_t start = millis();
+  while (epd_isBusy() && millis() - start < 5000) delay(10);
+  oled_setPower(false);
+
+  // Buttons are active low: keep the pull-ups on through sleep
+  for (int pin = 0; pin < 64; ++pin) {
+    if (!(mask & (1ULL << pin))) continue;
+    rtc_gpio_pullup_en((gpio_num_t)pin);
+    rtc_gpio_pulldown_dis((gpio_num_t)pin);
+  }
+#if SOC_PM_SUPPORT_RTC_PERIPH_PD
+  esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_ON);
+#endif
+  esp_sleep_enable_ext1_wakeup(mask, ESP_EXT1_WAKEUP_ANY_LOW);
+
+  Serial.flush();
+  esp_deep_sleep_start();
+}
+
+// Deadline of the deep-sleep timeout itself
+static uint32_t _msUntilDeepSleep(void) {
+  if (!s_rtc.sleepEnabled) return UINT32_MAX;
+  uint32_t idle = millis() - s_lastActivity;
+  return idle < POWER_IDLE_TIMEOUT_MS ? POWER_IDLE_TIMEOUT_MS - idle : 0;
+}
+
+void power_poll(void) {
+  if (!s_rtc.sleepEnabled) return;
+  if (millis() - s_lastActivity < POWER_IDLE_TIMEOUT_MS) return;
+  if (epd_isBusy()) return;
+
+  uint64_t mask = _wakeMask();
+  if (mask == 0) {
+    logger_log("power: no button can wake the chip, not sleeping");
+    s_rtc.sleepEnabled = false;
+    return;
+  }
+  _enterSleep(mask);
+}
+
+bool power_addDeadline(power_deadline_cb_t cb) {
+  if (!cb || s_deadlineCount >= POWER_MAX_DEADLINES) return false;
+  s_deadlines[s_deadlineCount++] = cb;
+  return true;
+}
+
+void power_setWakeCallback(power_wake_cb_t cb) { s_wakeCb = cb; }
+
+// Count one latency sample; true when it missed `target`
+static bool _noteLatency(uint32_t &count, uint32_t &last, uint32_t &max,
+                         uint32_t &slow, uint32_t us, uint32_t target) {
+  if (!_lockStats()) return false;
+  count++;
+  last = us;
+  if (us > max) max = us;
+  bool missed = us > target;
+  if (missed) slow++;
+  _unlockStats();
+  return missed;
+}
+
+void power_noteWakeLatency(uint32_t us) {
+  PowerIdleStats &st = s_idleStats;
+  if (_noteLatency(st.wakes, st.lastWakeUs, st.maxWakeUs, st.slowWakes, us, POWER_WAKE_TARGET_US)) {
+    logger_log("power: button wake took %lu us", (unsigned long)us);
+  }
+}
+
+void power_noteHttpLatency(uint32_t us) {
+  PowerIdleStats &st = s_idleStats;
+  if (_noteLatency(st.httpRequests, st.lastHttpUs, st.maxHttpUs, st.slowHttp, us, POWER_HTTP_TARGET_US)) {
+    logger_log("power: HTTP request waited %lu us", (unsigned long)us);
+  }
+}
+
+void power_getIdleStats(PowerIdleStats &out) {
+  if (!_lockStats()) {
+    out = {};
+    return;
+  }
+  out = s_idleStats;
+  _unlockStats();
+}
+
+// Light sleep until the timer or a button. The buttons' edge interrupts are
+// swapped for low-level wake-ups meanwhile, then restored.
+static void _lightSleep(uint32_t ms) {
+  const uint8_t pins[] = {PIN_BUTTON_PREV, PIN_BUTTON_NEXT, PIN_BUTTON_CONFIRM};
+  for (uint8_t pin : pins) {
+    gpio_intr_disable((gpio_num_t)pin);
+    gpio_wakeup_enable((gpio_num_t)pin, GPIO_INTR_LOW_LEVEL);
+  }
+  esp_sleep_enable_gpio_wakeup();
+  esp_sleep_enable_timer_wakeup((uint64_t)ms * 1000);
+  Serial.flush();
+
+  uint32_t start = millis();
+  esp_light_sleep_start();
+  uint32_t wakeUs = micros();
+  bool byButton = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO;
+
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_GPIO);
+  for (uint8_t pin : pins) {
+    gpio_wakeup_disable((gpio_num_t)pin);
+    gpio_set_intr_type((gpio_num_t)pin, GPIO_INTR_ANYEDGE);
+    gpio_intr_enable((gpio_num_t)pin);
+  }
+
+  if (_lockStats()) {
+    s_idleStats.lightSleeps++;
+    s_idleStats.sleptMs += millis() - start;
+    _unlockStats();
+  }
+  if (byButton && s_wakeCb) s_wakeCb(wakeUs);
+}
+
+void power_setRadioOn(bool on) { s_radioOn = on; }
+
+void power_idle(void) {
+  if (!ENABLE_LIGHT_SLEEP) return;
+
+  uint32_t budget = _msUntilDeepSleep();
+  for (size_t i = 0; i < s_deadlineCount && budget > 0; ++i) {
+    uint32_t left = s_deadlines[i]();
+    if (left < budget) budget = left;
+  }
+  // Something is due now: still give up a tick so loop() never busy-spins
+  if (budget == 0) budget = 1;
+
+  // Light sleep would drop the WiFi association
+  if (s_radioOn && budget > POWER_LIGHT_SLEEP_MAX_MS) budget = POWER_LIGHT_SLEEP_MAX_MS;
+
+  if (s_radioOn || budget < POWER_LIGHT_SLEEP_MIN_MS) {
+    TickType_t ticks = pdMS_TO_TICKS(budget);
+    vTaskDelay(ticks > 0 ? ticks : 1);
+    if (_lockStats()) {
+      s_idleStats.waitedMs += budget;
+      _unlockStats();
+    }
+    return;
+  }
+  _lightSleep(budget < POWER_LIGHT_SLEEP_MAX_MS ? budget : POWER_LIGHT_SLEEP_MAX_MS);
+}
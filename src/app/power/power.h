@@ -0,0 +1,127 @@
+#pragma once
+
+/*
+ * app/power/power.h
+ *
+ * Deep-sleep "display-only" mode, and light sleep between loop() passes.
+ *
+ * The e-paper keeps its image without power, so once the UI has been idle
+ * for POWER_IDLE_TIMEOUT_MS the chip goes to deep sleep and the buttons
+ * wake it again. What the UI needs to come back (active app, reader
+ * position) lives in RTC memory, so a wake can turn the page straight away
+ * instead of bringing up WiFi and the web server first.
+ *
+ * Flow:
+ *  - power_init() first thing in setup(): reads the wake cause
+ *  - power_isResume(): true after a button woke the chip from our sleep
+ *  - power_noteActivity(): call on user / API input
+ *  - power_poll() from loop(): sleeps once idle (if enabled)
+ *
+ * Notes:
+ *  - Only RTC-capable GPIOs can wake the chip (all three buttons on the S3,
+ *    Prev / Next only on the C6). Other button pins are skipped.
+ *  - The web API is unreachable while asleep, so sleeping is off by default
+ *    (ENABLE_DEEP_SLEEP) and toggled from Settings > E-Paper.
+ *
+ * Idle governor (ENABLE_LIGHT_SLEEP):
+ *  - Subsystems register their next deadline (power_addDeadline): UI frames,
+ *    the EPD queue, app ticks, HTTP polling.
+ *  - power_idle() at the end of loop() waits until the earliest one instead
+ *    of spinning: a plain task delay for short waits, light sleep with the
+ *    buttons and a timer as wake sources from POWER_LIGHT_SLEEP_MIN_MS up.
+ *  - Light sleep only runs with the radio off (power_setRadioOn): it would
+ *    drop the WiFi association. While connected the governor only delays
+ *    the loop task between HTTP polls (fast while a client is served, slow
+ *    otherwise) and the modem sleeps between beacons on its own. Automatic
+ *    light sleep (esp_pm) needs a core built with tickless idle and level
+ *    wake-ups on the buttons, which would replace their edge interrupts.
+ *  - Button wake latency (edge to handled frame) is measured by the UI,
+ *    HTTP latency (request ready to its handler) by the server; both are
+ *    reported through power_getIdleStats().
+ */
+
+#include <Arduino.h>
+#include <stdint.h>
+
+enum PowerView : uint8_t {
+  POWER_VIEW_CAROUSEL = 0, // app carousel (cold-boot path on wake)
+  POWER_VIEW_READER        // epub read view
+};
+
+// UI state kept in RTC memory across deep sleep
+struct PowerResumeState {
+  uint8_t appIndex;
+  PowerView view;
+  char book[64];           // epub path (reader only)
+  uint16_t chapter;
+  uint16_t page;
+  uint8_t partialTurns;    // partial page turns since the last full refresh
+};
+
+// Read the wake cause and restore the RTC settings. Call first in setup().
+void power_init(void);
+
+// True when this boot is a wake from power_poll()'s deep sleep with a valid
+// saved state. The panel still shows the page the device went to sleep on.
+bool power_isResume(void);
+
+// GPIO that woke the chip, or -1 (cold boot, timer, ...)
+int power_wakePin(void);
+
+// State saved before the last sleep (valid when power_isResume())
+const PowerResumeState &power_resumeState(void);
+
+// Called right before sleeping to fill in the state to resume from
+typedef void (*power_save_cb_t)(PowerResumeState &state);
+void power_setSaveCallback(power_save_cb_t cb);
+
+// Reset the idle timer
+void power_noteActivity(void);
+
+// Enter deep sleep once idle (EPD queue drained). Call from loop().
+void power_poll(void);
+
+// Runtime switch for deep sleep, kept across sleep cycles
+void power_setSleepEnabled(bool enabled);
+bool power_getSleepEnabled(void);
+
+// Milliseconds until a subsystem next needs loop() or the CPU: 0 = busy now,
+// UINT32_MAX = only on an external event (button, network)
+typedef uint32_t (*power_deadline_cb_t)(void);
+
+// Add a deadline source for power_idle() (setup time only)
+bool power_addDeadline(power_deadline_cb_t cb);
+
+// Called on the loop task after a button woke the chip from light sleep,
+// with micros() at the wake. Edge interrupts are off while asleep, so the
+// press itself may not have been captured.
+typedef void (*power_wake_cb_t)(uint32_t wakeUs);
+void power_setWakeCallback(power_wake_cb_t cb);
+
+// WiFi is up: power_idle() no longer light sleeps
+void power_setRadioOn(bool on);
+
+// Wait (or light sleep) until the earliest deadline, at least one tick.
+// Call at the end of loop().
+void power_idle(void);
+
+// Record one button wake: `us` from the edge (or the wake) to the handled frame
+void power_noteWakeLatency(uint32_t us);
+
+// Record one HTTP request: `us` from the server's last empty poll to the handler
+void power_noteHttpLatency(uint32_t us);
+
+struct PowerIdleStats {
+  uint32_t lightSleeps;     // light sleeps entered
+  uint32_t sleptMs;         // total time in light sleep
+  uint32_t waitedMs;        // total time power_idle() delayed the loop task
+  uint32_t wakes;           // button wakes measured
+  uint32_t lastWakeUs;      // latency of the last one
+  uint32_t maxWakeUs;
+  uint32_t slowWakes;       // over POWER_WAKE_TARGET_US
+  uint32_t httpRequests;    // HTTP requests measured
+  uint32_t lastHttpUs;      // latency of the last one
+  uint32_t maxHttpUs;
+  uint32_t slowHttp;        // over POWER_HTTP_TARGET_US
+};
+void power_getIdleStats(PowerIdleStats &out);
@@ -1,8 +1,35 @@
 #include "registry.h"
 #include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+#define APP_EVENT_QUEUE_DEPTH 16
+#define APP_MAX_SUBSCRIBERS 16
 
 static std::vector<const App*> g_apps;
 
+struct Subscriber {
+    uint32_t mask;       // APP_EVENT_BIT bits
+    uint32_t periodMs;   // APP_EVENT_TICK only
+    uint32_t nextTickMs;
+    AppEventHandler handler;
+};
+
+// Written at setup time only, read by dispatch() on the loop task
+static Subscriber g_subscribers[APP_MAX_SUBSCRIBERS];
+static size_t g_subscriberCount = 0;
+static QueueHandle_t g_events = NULL; // published, not delivered yet
+
+static bool addSubscriber(const Subscriber& sub) {
+    if (g_subscriberCount >= APP_MAX_SUBSCRIBERS) {
+        Serial.println("AppRegistry: subscriber table full");
+        return false;
+    }
+    if (g_events == NULL) g_events = xQueueCreate(APP_EVENT_QUEUE_DEPTH, sizeof(AppEvent));
+    g_subscribers[g_subscriberCount++] = sub;
+    return true;
+}
+
 namespace AppRegistry {
     void registerApp(const App* app) {
         if (app) {
@@ -29,12 +56,59 @@ namespace AppRegistry {
         }
     }
 
-    void pollAll() {
-        for (const auto* app : g_apps) {
-            if (app->poll) {
-                app->poll();
+    bool subscribe(uint32_t mask, AppEventHandler handler) {
+        if (!handler) return false;
+        return addSubscriber({mask & ~APP_EVENT_BIT(APP_EVENT_TICK), 0, 0, handler});
+    }
+
+    bool subscribeTick(uint32_t periodMs, AppEventHandler handler) {
+        if (!handler || periodMs == 0) return false;
+        return addSubscriber({APP_EVENT_BIT(APP_EVENT_TICK), periodMs, millis() + periodMs, handler});
+    }
+
+    void publish(AppEventType type, const char* source) {
+        // Nobody subscribed yet: nobody to tell
+        if (g_events == NULL) return;
+        AppEvent event = {type, source};
+        if (xQueueSend(g_events, &event, 0) != pdTRUE) {
+            Serial.printf("AppRegistry: event queue full, event %d dropped\n", type);
+        }
+    }
+
+    void dispatch() {
+        if (g_events == NULL) return;
+
+        AppEvent event;
+        while (xQueueReceive(g_events, &event, 0) == pdTRUE) {
+            for (size_t i = 0; i < g_subscriberCount; ++i) {
+                if (g_subscribers[i].mask & APP_EVENT_BIT(event.type)) g_subscribers[i].handler(event);
             }
         }
+
+        // Ticks go to their own subscriber; a late loop() skips missed ones
+        uint32_t now = millis();
+        for (size_t i = 0; i < g_subscriberCount; ++i) {
+            Subscriber& sub = g_subscribers[i];
+            if (sub.periodMs == 0 || (int32_t)(now - sub.nextTickMs) < 0) continue;
+            sub.nextTickMs += sub.periodMs;
+            if ((int32_t)(now - sub.nextTickMs) >= 0) sub.nextTickMs = now + sub.periodMs;
+            sub.handler({APP_EVENT_TICK, NULL});
+        }
+    }
+
+    uint32_t msUntilDispatch() {
+        if (g_events && uxQueueMessagesWaiting(g_events) > 0) return 0;
+
+        uint32_t now = millis();
+        uint32_t next = UINT32_MAX;
+        for (size_t i = 0; i < g_subscriberCount; ++i) {
+            const Subscriber& sub = g_subscribers[i];
+            if (sub.periodMs == 0) continue;
+            int32_t left = (int32_t)(sub.nextTickMs - now);
+            if (left <= 0) return 0;
+            if ((uint32_t)left < next) next = left;
+        }
+        return next;
     }
 
     const std::vector<const App*>& getApps() {
@@ -1,10 +1,31 @@
 #pragma once
 
 #include "ui/common/types.h"
+#include <stdint.h>
 #include <vector>
 
 class WebServer;
 
+// App events (publish / subscribe). Apps subscribe once to what they care
+// about and are called from loop() only when it happens, instead of being
+// polled on every pass.
+enum AppEventType : uint8_t {
+    APP_EVENT_TICK,          // subscriber's own period (subscribeTick)
+    APP_EVENT_NETWORK_UP,    // STA got an IP
+    APP_EVENT_NETWORK_DOWN,  // STA lost its AP
+    APP_EVENT_TIME_SYNCED,   // SNTP set the clock
+    APP_EVENT_COUNT
+};
+
+#define APP_EVENT_BIT(type) (1u << (type))
+
+struct AppEvent {
+    AppEventType type;
+    const char* source; // publisher, may be NULL
+};
+
+typedef void (*AppEventHandler)(const AppEvent& event);
+
 namespace AppRegistry {
     // Register an app to the system. Should be called before setupAll().
     void registerApp(const App* app);
@@ -17,8 +38,24 @@ namespace AppRegistry {
     // but internally it casts to WebServer*.
     void registerAllRoutes(void* serverPtr);
 
-    // Call poll() on all registered apps.
-    void pollAll();
+    // Call `handler` from loop() for the events in `mask` (APP_EVENT_BIT
+    // bits). Setup time only (setup(), App::setup, ui_init). False when the
+    // subscriber table is full.
+    bool subscribe(uint32_t mask, AppEventHandler handler);
+
+    // Call `handler` with APP_EVENT_TICK every `periodMs` (setup time only)
+    bool subscribeTick(uint32_t periodMs, AppEventHandler handler);
+
+    // Queue an event for its subscribers. Any task (WiFi / SNTP callbacks);
+    // `source` must outlive the event (a literal).
+    void publish(AppEventType type, const char* source = nullptr);
+
+    // Deliver queued events and due ticks. Call from loop().
+    void dispatch();
+
+    // Milliseconds until dispatch() has work: 0 with events queued, else the
+    // next tick (UINT32_MAX: no tick subscribers)
+    uint32_t msUntilDispatch();
 
     // Get the list of all registered apps (for UI carousel)
     const std::vector<const App*>& getApps();
@@ -1,4 +1,5 @@
 #include "rss.h"
+#include "app/registry.h"
 #include "app/ui/ui_internal.h"
 #include "app/ui/common/types.h"
 #include "app/ui/common/components.h"
@@ -17,23 +18,55 @@ static uint8_t s_prevIndex = 0;
 static unsigned long s_lastFetch = 0;
 static const unsigned long FETCH_INTERVAL = 300000; // 5 minutes
 static RSSFeed s_feed;
+static RSSFeed s_fetched; // filled by the fetch job, swapped in when it is done
 
 // Viewing mode state
 static bool s_viewingArticle = false;
-static int16_t s_componentIndex = 0; // Current starting component index for pagination
-static std::vector<EpdComponent> s_currentArticleComponents;
+static size_t s_screen = 0;       // Current e-paper screen of the article
+static EpdPage s_article;         // Whole article, split into screens by the layout pass
+static EpdLayout s_articleLayout;
 // static String s_currentArticleTitle; // Unused warning
 
-static void fetch_data() {
-    if (oled_isAvailable()) oled_showToast("Fetching NYT...", 1000);
-    if (RSSService::getInstance().fetchNYT(s_feed, 30)) {
-        if (oled_isAvailable()) oled_showToast("News Updated", 800);
+// App worker
+static bool fetch_work(void*) {
+    s_fetched = RSSFeed();
+    return RSSService::getInstance().fetchNYT(s_fetched, 30);
+}
+
+// Position of the item with `link` in the current feed (titles for items
+// without a link), or -1
+static int find_item(const String& link, const String& title) {
+    for (size_t i = 0; i < s_feed.items.size(); ++i) {
+        const RSSItem& item = s_feed.items[i];
+        if (link.isEmpty() ? item.title == title : item.link == link) return (int)i;
+    }
+    return -1;
+}
+
+// UI task. `background` is set for the refreshes started by app events.
+static void fetch_done(bool ok, void* background) {
+    if (ok) {
+        // Stay on the headline being shown: the new feed may be reordered
+        String link, title;
+        if (s_index < s_feed.items.size()) {
+            link = s_feed.items[s_index].link;
+            title = s_feed.items[s_index].title;
+        }
+        std::swap(s_feed, s_fetched);
+        int index = find_item(link, title);
+        s_index = s_prevIndex = index < 0 ? 0 : (uint8_t)index;
+        if (oled_isAvailable() && !background) oled_showToast("News Updated", 800);
     } else {
-        if (oled_isAvailable()) oled_showToast("Fetch Failed", 1500);
+        if (oled_isAvailable() && !background) oled_showToast("Fetch Failed", 1500);
     }
+    s_fetched = RSSFeed();
     s_lastFetch = millis();
 }
 
+static void fetch_data() {
+    ui_runAsync("Fetching NYT...", fetch_work, fetch_done, NULL);
+}
+
 static void render_news_item(uint8_t index, int16_t x, int16_t y) {
     if (index < s_feed.items.size()) {
         const auto& item = s_feed.items[index];
@@ -45,19 +78,14 @@ static void render_news_item(uint8_t index, int16_t x, int16_t y) {
 
 static void view_render(int16_t x_offset, int16_t y_offset) {
     if (s_viewingArticle) {
-        int maxComponents = 24; 
-        int pageNum = (s_componentIndex / maxComponents) + 1;
-        int totalPages = (s_currentArticleComponents.size() + maxComponents - 1) / maxComponents;
-        if (totalPages < 1) totalPages = 1;
-        
         char buf[32];
-        snprintf(buf, sizeof(buf), "Page %d/%d", pageNum, totalPages);
+        snprintf(buf, sizeof(buf), "Page %u/%u", (unsigned)s_screen + 1, (unsigned)s_articleLayout.screens());
         oled_drawBigText(buf, x_offset, y_offset, false, true);
         return;
     }
     
     if (s_feed.items.size() == 0) {
-        oled_drawBigText("No Data", x_offset, y_offset, false, true);
+        oled_drawBigText(ui_isLoading() ? "Loading" : "No Data", x_offset, y_offset, false, true);
         return;
     }
 
@@ -69,50 +97,19 @@ static void view_render(int16_t x_offset, int16_t y_offset) {
     }
 }
 
-static void add_wrapped_text(const String& content, const String& prefix = "") {
-    String fullText = prefix + content;
-    int pos = 0;
-    while (pos < fullText.length()) {
-        int chunkSize = min(18, (int)(fullText.length() - pos));
-        if (pos + chunkSize < fullText.length()) {
-            int lastSpace = fullText.lastIndexOf(' ', pos + chunkSize);
-            if (lastSpace > pos) chunkSize = lastSpace - pos;
-        }
-        String chunk = fullText.substring(pos, pos + chunkSize);
-        chunk.trim();
-        if (chunk.length() > 0) {
-            s_currentArticleComponents.push_back({EPD_COMP_ROW, chunk, "", 0, GxEPD_BLACK});
-        }
-        pos += chunkSize;
-        if (pos < fullText.length() && fullText[pos] == ' ') pos++;
-    }
-}
-
 static void prepare_article_components(const RSSItem& item) {
-    s_currentArticleComponents.clear();
+    s_article = EpdPage();
+    s_articleLayout = EpdLayout();
     // s_currentArticleTitle = item.title;
     
-    // 1. Title
+    // 1. Title (wrapped by the layout pass, like the body)
     String cleanTitle = item.title;
-    int pos = 0;
-    while (pos < cleanTitle.length()) {
-        int chunkSize = min(18, (int)(cleanTitle.length() - pos));
-        if (pos + chunkSize < cleanTitle.length()) {
-            int lastSpace = cleanTitle.lastIndexOf(' ', pos + chunkSize);
-            if (lastSpace > pos) chunkSize = lastSpace - pos;
-        }
-        String chunk = cleanTitle.substring(pos, pos + chunkSize);
-        chunk.trim();
-        if (chunk.length() > 0) {
-            s_currentArticleComponents.push_back({EPD_COMP_HEADER, chunk, "", 0, GxEPD_BLACK});
-        }
-        pos += chunkSize;
-        if (pos < cleanTitle.length() && cleanTitle[pos] == ' ') pos++;
-    }
+    cleanTitle.trim();
+    if (!cleanTitle.isEmpty()) epd_page_addParagraph(s_article, cleanTitle, GxEPD_BLACK);
     
     // 2. Author
     if (!item.author.isEmpty()) {
-        add_wrapped_text(item.author); 
+        epd_page_addParagraph(s_article, item.author, GxEPD_BLACK);
     }
     
     // 3. Description
@@ -137,42 +134,32 @@ static void prepare_article_components(const RSSItem& item) {
         cleanDesc.trim();
         
         if (cleanDesc.length() > 0) {
-            s_currentArticleComponents.push_back({EPD_COMP_SEPARATOR, "", "", 0, 0});
-            add_wrapped_text(cleanDesc);
+            s_article.components.push_back({EPD_COMP_SEPARATOR, "", "", 0, 0});
+            epd_page_addParagraph(s_article, cleanDesc, GxEPD_BLACK);
         }
     }
     
     // 4. Date
     if (!item.pubDate.isEmpty()) {
-        s_currentArticleComponents.push_back({EPD_COMP_ROW, "---", "", 0, GxEPD_BLACK});
-        add_wrapped_text(item.pubDate);
+        s_article.components.push_back({EPD_COMP_ROW, "---", "", 0, GxEPD_BLACK});
+        epd_page_addParagraph(s_article, item.pubDate, GxEPD_BLACK);
     }
+
+    epd_layout_paginate(s_article, s_articleLayout);
 }
 
-static void render_article_with_offset(int16_t startIdx) {
+static void render_article_screen(size_t screen) {
     if (epd_isBusy()) {
         if (oled_isAvailable()) oled_showToast("EPD busy", 1000);
         return;
     }
 
-    EpdPage page;
-    page.title = ""; 
-    int maxComponents = 24; 
-    int total = s_currentArticleComponents.size();
-    int endIdx = min(total, (int)startIdx + maxComponents);
-    
-    for (int i = startIdx; i < endIdx; i++) {
-        page.components.push_back(s_currentArticleComponents[i]);
-    }
-    
     if (oled_isAvailable()) {
         char buf[32];
-        int pageNum = (startIdx / maxComponents) + 1;
-        int totalPages = (total + maxComponents - 1) / maxComponents;
-        snprintf(buf, sizeof(buf), "Page %d/%d", pageNum, totalPages);
+        snprintf(buf, sizeof(buf), "Page %u/%u", (unsigned)screen + 1, (unsigned)s_articleLayout.screens());
         oled_showToast(buf, 800);
     }
-    epd_displayPage(page);
+    epd_displayPageScreen(s_article, s_articleLayout, screen);
 }
 
 static void view_next(void) {
@@ -181,10 +168,9 @@ static void view_next(void) {
             if (oled_isAvailable()) oled_showToast("Wait...", 500);
             return;
         }
-        int maxComponents = 24;
-        if (s_componentIndex + maxComponents < s_currentArticleComponents.size()) {
-            s_componentIndex += maxComponents;
-            render_article_with_offset(s_componentIndex);
+        if (s_screen + 1 < s_articleLayout.screens()) {
+            s_screen++;
+            render_article_screen(s_screen);
         } else {
              if (oled_isAvailable()) oled_showToast("End of article", 800);
         }
@@ -203,10 +189,9 @@ static void view_prev(void) {
             if (oled_isAvailable()) oled_showToast("Wait...", 500);
             return;
         }
-        int maxComponents = 24;
-        if (s_componentIndex > 0) {
-            s_componentIndex = max(0, s_componentIndex - maxComponents);
-            render_article_with_offset(s_componentIndex);
+        if (s_screen > 0) {
+            s_screen--;
+            render_article_screen(s_screen);
         } else {
              if (oled_isAvailable()) oled_showToast("Start of article", 800);
         }
@@ -221,15 +206,15 @@ static void view_prev(void) {
 
 static void view_select(void) {
     if (s_viewingArticle) {
-        render_article_with_offset(s_componentIndex); // Refresh
+        render_article_screen(s_screen); // Refresh
         return;
     }
     
     if (s_index < s_feed.items.size()) {
         s_viewingArticle = true;
-        s_componentIndex = 0; // Reset to top
+        s_screen = 0; // Reset to top
         prepare_article_components(s_feed.items[s_index]);
-        render_article_with_offset(0);
+        render_article_screen(0);
         if (oled_isAvailable()) oled_showToast("Reading mode", 1000);
     } else {
         fetch_data();
@@ -239,8 +224,9 @@ static void view_select(void) {
 static void view_back(void) {
     if (s_viewingArticle) {
         s_viewingArticle = false;
-        s_componentIndex = 0;
-        s_currentArticleComponents.clear();
+        s_screen = 0;
+        s_article = EpdPage();
+        s_articleLayout = EpdLayout();
         if (oled_isAvailable()) oled_showToast("Back to list", 800);
         ui_redraw();
         return;
@@ -248,13 +234,13 @@ static void view_back(void) {
     ui_setView(NULL);
 }
 
-static float view_get_progress(void) {
+static q16_t view_get_progress(void) {
     if (s_viewingArticle) {
-        if (s_currentArticleComponents.size() == 0) return 0.0f;
-        return (float)s_componentIndex / (float)s_currentArticleComponents.size();
+        if (s_articleLayout.screens() <= 1) return 0;
+        return q16_div((int32_t)s_screen, (int32_t)s_articleLayout.screens() - 1);
     }
-    if (s_feed.items.size() == 0) return 0.0f;
-    return (float)(s_index + 1) / (float)s_feed.items.size();
+    if (s_feed.items.size() == 0) return 0;
+    return q16_div(s_index + 1, (int32_t)s_feed.items.size());
 }
 
 static void view_poll(void) {}
@@ -280,22 +266,40 @@ static void app_renderPreview(int16_t x, int16_t y) {
 static void app_select(void) {
     s_index = 0;
     s_viewingArticle = false;
-    s_componentIndex = 0;
+    s_screen = 0;
     ui_setView(&VIEW_NYT);
     if (s_feed.items.size() == 0) {
         fetch_data();
     }
 }
 
-static void app_poll(void) {
-    // maybe auto fetch?
+// App events (loop task): while the view is open, refresh every
+// FETCH_INTERVAL and when the network comes back
+static bool s_online = false;
+static bool s_background = true; // fetch_done() ctx
+
+static void refresh_shown(void) {
+    if (s_online && ui_getView() == &VIEW_NYT) ui_runAsync(NULL, fetch_work, fetch_done, &s_background);
+}
+
+static void on_network(const AppEvent& event) {
+    s_online = event.type == APP_EVENT_NETWORK_UP;
+    refresh_shown();
+}
+
+static void on_tick(const AppEvent&) {
+    refresh_shown();
+}
+
+static void app_setup(void) {
+    AppRegistry::subscribe(APP_EVENT_BIT(APP_EVENT_NETWORK_UP) | APP_EVENT_BIT(APP_EVENT_NETWORK_DOWN), on_network);
+    AppRegistry::subscribeTick(FETCH_INTERVAL, on_tick);
 }
 
 const App APP_RSS = {
     .name = "NY Times",
     .renderPreview = app_renderPreview,
     .onSelect = app_select,
-    .setup = nullptr,
-    .registerRoutes = nullptr,
-    .poll = app_poll
+    .setup = app_setup,
+    .registerRoutes = nullptr
 };
@@ -6,12 +6,36 @@
 #include "server.h"
 #include "config.h"
 #include "app/registry.h"
+#include "app/power/power.h"
 #include "utils/logger/logger.h"
 #include <WebServer.h>
 
 static WebServer server(WEB_SERVER_PORT);
+static uint32_t s_lastPollUs = 0;  // end of the last handleClient() pass
+static uint32_t s_lastRequestMs = 0;
+static bool s_clientOpen = false;  // a request is being read or kept alive
+
+// Registered before every route: WebServer asks each handler canHandle() once
+// a request is parsed, so the first one sees every request right before its
+// route runs. It records how long the request may have waited since the
+// previous poll (the idle delay plus the rest of loop()) and never claims it.
+class LatencyProbe : public RequestHandler {
+public:
+  // Arduino-ESP32 2.x takes the URI by value, 3.x by const reference
+  bool canHandle(HTTPMethod method, String uri) { return _probe(method, uri); }
+  bool canHandle(HTTPMethod method, const String &uri) { return _probe(method, uri); }
+
+private:
+  static bool _probe(HTTPMethod, const String &) {
+    power_noteHttpLatency(micros() - s_lastPollUs);
+    s_lastRequestMs = millis();
+    return false;
+  }
+};
 
 void server_init() {
+  server.addHandler(new LatencyProbe());
+
   // Register generic not found handler
   server.onNotFound([]() {
     server.send(404, "text/plain", "Not found");
@@ -21,9 +45,17 @@ void server_init() {
   AppRegistry::registerAllRoutes(&server);
 
   server.begin();
+  s_lastPollUs = micros();
   logger_log("HTTP server started");
 }
 
 void server_handleClient() {
   server.handleClient();
+  s_clientOpen = server.client().connected();
+  s_lastPollUs = micros();
+}
+
+uint32_t server_msUntilPoll() {
+  if (s_clientOpen || millis() - s_lastRequestMs < POWER_NET_ACTIVE_MS) return POWER_NET_POLL_MS;
+  return POWER_NET_IDLE_POLL_MS;
 }
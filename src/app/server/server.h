@@ -21,4 +21,9 @@
 void server_init();
 
 // Must be called frequently from the main `loop()` to handle incoming requests.
-void server_handleClient();
\ No newline at end of file
+void server_handleClient();
+
+// Milliseconds until the next server_handleClient() is due (idle governor):
+// POWER_NET_POLL_MS while a client is open or was served in the last
+// POWER_NET_ACTIVE_MS, POWER_NET_IDLE_POLL_MS otherwise.
+uint32_t server_msUntilPoll();
\ No newline at end of file
@@ -60,8 +60,8 @@ static void view_back(void) {
     ui_setView(NULL);
 }
 
-static float view_get_progress(void) {
-    return (float)(s_index + 1) / (float)SET_COUNT;
+static q16_t view_get_progress(void) {
+    return q16_div(s_index + 1, SET_COUNT);
 }
 
 const View VIEW_SETTINGS_MAIN = {
@@ -89,6 +89,5 @@ const App APP_SETTINGS = {
     .renderPreview = app_renderPreview,
     .onSelect = app_select,
     .setup = nullptr,
-    .registerRoutes = nullptr,
-    .poll = nullptr
+    .registerRoutes = nullptr
 };
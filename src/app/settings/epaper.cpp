@@ -3,10 +3,11 @@
 #include "drivers/epaper/display.h"
 #include "drivers/oled/oled.h"
 #include "app/ui/ui_internal.h"
+#include "app/power/power.h"
 #include <stdio.h>
 #include <Arduino.h>
 
-enum EpdItem : uint8_t { EPD_PARTIAL = 0, EPD_FULL_CLEAN, EPD_COUNT };
+enum EpdItem : uint8_t { EPD_PARTIAL = 0, EPD_DEEP_SLEEP, EPD_FULL_CLEAN, EPD_COUNT };
 static uint8_t s_index = 0;
 static uint8_t s_prevIndex = 0;
 
@@ -15,6 +16,9 @@ static void render_item(uint8_t index, int16_t x, int16_t y) {
     case EPD_PARTIAL:
       comp_toggle("partial rendering", epd_getPartialEnabled(), x, y);
       break;
+    case EPD_DEEP_SLEEP:
+      comp_toggle("deep sleep", power_getSleepEnabled(), x, y);
+      break;
     case EPD_FULL_CLEAN:
       oled_drawBigText("Full clean", x, y, false, true);
       break;
@@ -49,6 +53,9 @@ static void view_select(void) {
       epd_setPartialEnabled(!cur);
       break;
     }
+    case EPD_DEEP_SLEEP:
+      power_setSleepEnabled(!power_getSleepEnabled());
+      break;
     case EPD_FULL_CLEAN: {
       if (!epd_forceClear_async()) {
         if (oled_isAvailable()) oled_showStatus("EPD busy");
@@ -63,8 +70,8 @@ static void view_back(void) {
     ui_setView(&VIEW_SETTINGS_MAIN);
 }
 
-static float view_get_progress(void) {
-    return (float)(s_index + 1) / (float)EPD_COUNT;
+static q16_t view_get_progress(void) {
+    return q16_div(s_index + 1, EPD_COUNT);
 }
 
 const View VIEW_SETTINGS_EPAPER = {
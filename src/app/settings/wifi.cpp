@@ -50,8 +50,8 @@ static void view_back(void) {
     ui_setView(&VIEW_SETTINGS_MAIN);
 }
 
-static float view_get_progress(void) {
-    return (float)(s_index + 1) / (float)WIFI_COUNT;
+static q16_t view_get_progress(void) {
+    return q16_div(s_index + 1, WIFI_COUNT);
 }
 
 const View VIEW_SETTINGS_WIFI = {
@@ -2,6 +2,7 @@
 
 #include <stdint.h>
 #include <Arduino.h>
+#include "utils/anim.h"
 
 struct View {
   const char *title;
@@ -11,7 +12,7 @@ struct View {
   void (*onSelect)(void);
   void (*onBack)(void);
   void (*poll)(void);
-  float (*getScrollProgress)(void);
+  q16_t (*getScrollProgress)(void);    // 0..Q16_ONE (utils/anim.h)
 };
 
 // Represents an App in the main menu carousel
@@ -33,6 +34,6 @@ struct App {
     // Takes a pointer to the WebServer (void* to avoid circular dependency)
     void (*registerRoutes)(void* serverPtr);
 
-    // Optional: called periodically (e.g. for background updates)
-    void (*poll)(void);
+    // Background work is event driven: subscribe in setup() to the events
+    // it needs (AppRegistry::subscribe / subscribeTick in app/registry.h)
 };
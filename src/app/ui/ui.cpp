@@ -3,6 +3,19 @@
  *
  * Refactored UI using a registry of apps.
  * Supports a Carousel of Apps and entering them.
+ *
+ * The UI runs in its own task: it samples the buttons, takes input events
+ * from a queue (dispatched to the views on this task), steps the animations
+ * on a fixed UI_TICK_MS clock and, when something marked damage (see
+ * ui_invalidate), renders a frame and flushes the OLED. loop() only runs the
+ * current view's poll (ui_poll) and the app events: NTP starts on
+ * NETWORK_UP, the wallpaper follows TIME_SYNCED and the date overlay is
+ * checked on a one-minute tick. State shared with other tasks
+ * (apps calling ui_setView, HTTP handlers) is guarded by s_uiMutex.
+ *
+ * Slow work of the views (fetches, opening a book) goes to the app worker
+ * task through ui_runAsync(); its completion comes back through the input
+ * queue, so it is handled on the UI task in order with the buttons.
  */
 
 #include "ui.h"
@@ -12,28 +25,80 @@
 #include "app/controls/controls.h"
 #include "app/wifi/wifi.h"
 #include "drivers/epaper/display.h"
+#include "app/power/power.h"
+
+#include "config.h"
+#include "utils/anim.h"
+#include "utils/task_stats.h"
 
 #include <Arduino.h>
+#include <esp_sntp.h>
 #include <time.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+// Frame tick while something moves (50 Hz). Idle, the task sleeps until a
+// toast or the clock needs a frame; button edges (controls edge callback),
+// input from other tasks and ui_invalidate() wake it straight away.
+#define UI_TICK_MS 20
+#define UI_EVENT_QUEUE_DEPTH 8
+// App worker: HTTPS requests (TLS) and EPUB parsing run on it
+#define UI_JOB_STACK 8192
+// Loading toast: held while the job runs, slides out when it is done
+#define UI_JOB_TOAST_MS 60000
+#define UI_JOB_TOAST_EXIT_MS 250
+
+// UI_EVENT_WAKE only cuts the UI task's sleep short (damage from another task)
+enum UiEvent : uint8_t { UI_EVENT_NEXT, UI_EVENT_PREV, UI_EVENT_SELECT, UI_EVENT_BACK, UI_EVENT_WAKE, UI_EVENT_JOB_DONE };
+
+static QueueHandle_t s_events = NULL;
+static SemaphoreHandle_t s_uiMutex = NULL; // recursive: views re-enter ui_setView / ui_redraw
+static TaskHandle_t s_uiTaskHandle = NULL;
+
+// The app job in flight (ui_runAsync)
+struct UiJob {
+  const char *label;
+  UiJobWork work;
+  UiJobDone done;
+  void *ctx;
+  bool ok;
+};
+static UiJob s_job;
+static bool s_jobBusy = false;             // submitted, done() not run yet
+static QueueHandle_t s_jobQueue = NULL;    // to the worker
+static TaskHandle_t s_jobTaskHandle = NULL;
+static uint32_t s_lastFrameUs = 0;
+static bool s_moving = false;              // last tick animated something (under s_uiMutex)
+static volatile uint32_t s_edgeUs = 0;     // first button edge / wake not handled yet (0 = none)
+
+// Damage (UiDamage bits) collected for the next frame; none = no OLED work
+static uint8_t s_damage = UI_DAMAGE_VIEW;
+// Home clock as last drawn: minute and WiFi state
+static uint32_t s_clockMinute = 0;
+static bool s_clockWifi = false;
+
+#define LOCK_UI()   if (s_uiMutex) xSemaphoreTakeRecursive(s_uiMutex, portMAX_DELAY)
+#define UNLOCK_UI() if (s_uiMutex) xSemaphoreGiveRecursive(s_uiMutex)
 
 // Current state
 static size_t s_appIndex = 0;           // Index in the app registry (Carousel)
 static const View *s_currentView = NULL; // If non-NULL, we are "inside" an app loop
 static bool s_timeConfigured = false;
 static bool s_initialDateShown = false;
-
-// Physics constants (Unified for snappier feel)
-static constexpr float ANIM_K = 2.0f;   // Higher stiffness
-static constexpr float ANIM_D = 0.28f;  // More damping (settles faster)
-
-// Animation state
-static float s_animOffset = 0.0f;  // 0.0 = centered, 1.0 = incoming from bottom, -1.0 = incoming from top
-static float s_animVelocity = 0.0f;
-static float s_hAnimOffset = 0.0f; // 0.0 = carousel, 1.0 = in-app
-static float s_hAnimVelocity = 0.0f;
-static float s_hAnimTarget = 0.0f;
-static float s_progress = 0.0f; // Smoothed vertical progress
-static float s_progressOpacity = 0.0f; // 0.0 to 1.0
+static int s_shownYday = -1;             // Day of year currently shown in the EPD date overlay
+static bool s_subscribed = false;
+
+// Physics constants (Unified for snappier feel), per ANIM_STEP_US step
+static constexpr q16_t ANIM_K = Q16_CONST(2.0);   // Higher stiffness
+static constexpr q16_t ANIM_D = Q16_CONST(0.28);  // More damping (settles faster)
+
+// Animation state (Q16, see utils/anim.h)
+static anim_prop_t s_vAnim;           // 0 = centered, 1 = incoming from bottom, -1 = incoming from top
+static anim_prop_t s_hAnim;           // 0 = carousel, 1 = in-app
+static anim_prop_t s_progress;        // Smoothed vertical progress
+static anim_prop_t s_progressOpacity; // 0 to 1
 static uint32_t s_lastInputTime = 0;
 static size_t s_prevAppIndex = 0;
 static const View *s_lastView = NULL; // For exit transition
@@ -64,10 +129,14 @@ static void ui_renderAppPreview(size_t index, int16_t x_offset, int16_t y_offset
     }
 }
 
-// Helpers
-void ui_redraw(void) {
+// Whole frame: carousel / view, scroll bar, toast. Overlays are drawn over
+// the content, so any damage re-composes everything; oled_display() then
+// sends only the columns that changed.
+static void _render(void) {
   // Horizontal translation logic
-  int16_t h_px = (int16_t)(s_hAnimOffset * 128.0f);
+  const q16_t hOffset = s_hAnim.value;
+  const q16_t vOffset = s_vAnim.value;
+  int16_t h_px = q16_mulInt(hOffset, 128);
 
   oled_clearBuffer();
 
@@ -75,21 +144,21 @@ void ui_redraw(void) {
   // but for now let's just allow the UI to remain fully active as requested.
 
   // Draw Carousel if visible
-  if (s_hAnimOffset < 0.99f) {
+  if (hOffset < Q16_CONST(0.99)) {
       int16_t carousel_x = -h_px;
-      if (abs(s_animOffset) < 0.01f) {
+      if (abs(vOffset) < Q16_CONST(0.01)) {
           ui_renderAppPreview(s_appIndex, carousel_x, 0);
       } else {
-          int16_t offset_y_px = (int16_t)(s_animOffset * 64.0f);
+          int16_t offset_y_px = q16_mulInt(vOffset, 64);
           ui_renderAppPreview(s_appIndex, carousel_x, offset_y_px);
           ui_renderAppPreview(s_prevAppIndex, carousel_x, offset_y_px > 0 ? offset_y_px - 64 : offset_y_px + 64);
       }
   }
 
   // Draw View if visible
-  if (s_hAnimOffset > 0.01f) {
+  if (hOffset > Q16_CONST(0.01)) {
       int16_t view_x = 128 - h_px;
-      int16_t view_y = (int16_t)(s_animOffset * 64.0f);
+      int16_t view_y = q16_mulInt(vOffset, 64);
       const View* v = s_currentView ? s_currentView : s_lastView;
       if (v) {
           if (v->render) v->render(view_x, view_y);
@@ -98,15 +167,15 @@ void ui_redraw(void) {
   }
 
   // Draw Vertical Scroll Progress (1px bar on the left)
-  if (s_progress > 0.001f && s_progressOpacity > 0.001f) {
-      if (s_progressOpacity >= 0.99f) {
-          oled_drawScrollProgress(s_progress);
+  if (s_progress.value > Q16_CONST(0.001) && s_progressOpacity.value > Q16_CONST(0.001)) {
+      if (s_progressOpacity.value >= Q16_CONST(0.99)) {
+          oled_drawScrollProgress(s_progress.value);
       } else {
           // Subtle fade by drawing dots (dithering style) if low opacity 
           // but for simplicity on OLED we just draw if > 0.5 or similar,
           // OR we just draw it normally if we want it crisp.
           // Let's draw it normally for now as requested "line".
-          oled_drawScrollProgress(s_progress);
+          oled_drawScrollProgress(s_progress.value);
       }
   }
   
@@ -114,38 +183,69 @@ void ui_redraw(void) {
   oled_display();
 }
 
+// Helpers
+void ui_invalidate(uint8_t damage) {
+  LOCK_UI();
+  bool wake = s_damage == 0 && s_events && xTaskGetCurrentTaskHandle() != s_uiTaskHandle;
+  s_damage |= damage;
+  UNLOCK_UI();
+
+  if (wake) {
+    UiEvent e = UI_EVENT_WAKE;
+    xQueueSend(s_events, &e, 0);
+  }
+}
+
+void ui_redraw(void) {
+  ui_invalidate(UI_DAMAGE_VIEW);
+}
+
 void ui_setView(const View* view) {
-    if (view == s_currentView) return;
+    LOCK_UI();
+    if (view == s_currentView) {
+        UNLOCK_UI();
+        return;
+    }
 
     if (view != NULL) {
         // Entering App: target progress 1.0
-        s_hAnimTarget = 1.0f;
+        anim_setTarget(&s_hAnim, Q16_ONE);
         s_lastView = NULL;
     } else {
         // Exiting App: target progress 0.0
-        s_hAnimTarget = 0.0f;
+        anim_setTarget(&s_hAnim, 0);
         s_lastView = s_currentView;
     }
 
     // Reset vertical animation on view change
-    s_animOffset = 0.0f;
-    s_animVelocity = 0.0f;
+    anim_reset(&s_vAnim, 0);
 
     s_currentView = view;
-    ui_redraw();
+    epd_setSourceTag(view ? view->title : "ui");
+    ui_invalidate(UI_DAMAGE_VIEW);
+    UNLOCK_UI();
+}
+
+const View* ui_getView(void) {
+    LOCK_UI();
+    const View* view = s_currentView;
+    UNLOCK_UI();
+    return view;
 }
 
 void ui_triggerVerticalAnimation(bool up) {
-    s_animOffset = up ? 1.0f : -1.0f;
-    s_animVelocity = 0.0f;
+    LOCK_UI();
+    anim_set(&s_vAnim, up ? Q16_ONE : -Q16_ONE);
     // Faster feedback for navigation
     oled_showToast(NULL, 400, up ? TOAST_BOTTOM : TOAST_TOP, up ? TOAST_ICON_DOWN : TOAST_ICON_UP);
-    ui_redraw();
+    ui_invalidate(UI_DAMAGE_MOTION | UI_DAMAGE_OVERLAY);
+    UNLOCK_UI();
 }
 
-// Navigation Callbacks
-void ui_next(void) {
+// Navigation handlers (UI task, lock held)
+static void _next(void) {
     s_lastInputTime = millis();
+    power_noteActivity();
     // If inside a view, delegate
     if (s_currentView) {
         if (s_currentView->onNext) s_currentView->onNext();
@@ -161,8 +261,9 @@ void ui_next(void) {
     }
 }
 
-void ui_prev(void) {
+static void _prev(void) {
     s_lastInputTime = millis();
+    power_noteActivity();
     // If inside a view, delegate
     if (s_currentView) {
         if (s_currentView->onPrev) s_currentView->onPrev();
@@ -178,8 +279,9 @@ void ui_prev(void) {
     }
 }
 
-void ui_select(void) {
+static void _select(void) {
     s_lastInputTime = millis();
+    power_noteActivity();
     // If inside a view, delegate
     if (s_currentView) {
         if (s_currentView->onSelect) s_currentView->onSelect();
@@ -190,12 +292,14 @@ void ui_select(void) {
     const auto& apps = AppRegistry::getApps();
     size_t count = apps.size();
     if (s_appIndex < count && apps[s_appIndex]->onSelect) {
+        epd_setSourceTag(apps[s_appIndex]->name);
         apps[s_appIndex]->onSelect();
     }
 }
 
-void ui_back(void) {
+static void _back(void) {
     s_lastInputTime = millis();
+    power_noteActivity();
     // If inside a view, delegate
     if (s_currentView) {
         if (s_currentView->onBack) {
@@ -204,142 +308,366 @@ void ui_back(void) {
         }
         // Default back: exit to carousel
         s_currentView = NULL;
-        ui_redraw();
+        epd_setSourceTag("ui");
+        ui_invalidate(UI_DAMAGE_VIEW);
         return;
     }
 
     // Carousel: Reset to Home (App 0) if not already there
     if (s_appIndex != 0) {
         s_appIndex = 0;
-        ui_redraw();
+        ui_invalidate(UI_DAMAGE_VIEW);
     }
 }
 
-// Initialization and Polling
-void ui_init(void) {
-  controls_setUseDefaultActions(false);
-  controls_setPrevCallback(ui_prev);
-  controls_setNextCallback(ui_next);
-  controls_setConfirmCallback(ui_select);
-  controls_setConfirmLongCallback(ui_back);
-
-  s_currentView = NULL;
-  s_lastView = NULL;
-  s_timeConfigured = false;
-  s_initialDateShown = false;
-  s_animOffset = 0.0f;
-  s_animVelocity = 0.0f;
-  s_hAnimOffset = 0.0f;
-  s_hAnimVelocity = 0.0f;
-  s_prevAppIndex = 0;
-  s_progress = 0.0f;
-  s_progressOpacity = 0.0f;
-  s_lastInputTime = 0;
-
-  oled_setMenuMode(true);
-  ui_redraw();
+// The worker finished s_job: hand the result to the view (UI task, lock held)
+static void _finishJob(void) {
+  UiJob job = s_job;
+  s_jobBusy = false; // done() may start the next job
+  power_noteActivity();
+  if (job.label) oled_showToast(job.label, UI_JOB_TOAST_EXIT_MS);
+  if (job.done) job.done(job.ok, job.ctx);
+  ui_invalidate(UI_DAMAGE_VIEW | UI_DAMAGE_OVERLAY);
 }
 
-void ui_poll(void) {
-  bool needsRedraw = false;
+static void _dispatch(UiEvent e) {
+  switch (e) {
+    case UI_EVENT_NEXT: _next(); break;
+    case UI_EVENT_PREV: _prev(); break;
+    case UI_EVENT_SELECT: _select(); break;
+    case UI_EVENT_BACK: _back(); break;
+    case UI_EVENT_WAKE: break;
+    case UI_EVENT_JOB_DONE: _finishJob(); break;
+  }
+}
 
-  // NTP Sync Logic
-  if (wifi_isConnected() && !s_timeConfigured) {
-    configTime(0, 0, "pool.ntp.org", "time.google.com");
-    s_timeConfigured = true;
+// Input from any task (buttons, HTTP) is handled in order on the UI task
+static void _post(UiEvent e) {
+  if (!s_events) {
+    _dispatch(e);
+    return;
   }
+  if (xQueueSend(s_events, &e, 0) != pdTRUE) Serial.println("ui: input queue full, event dropped");
+}
 
-  // Once time is valid, show wallpaper (with date) or just date on E-Paper (once)
-  if (s_timeConfigured && !s_initialDateShown) {
-      time_t now = time(nullptr);
-      if (now > 1600000000) {
-          epd_displayWallpaper(now);
-          s_initialDateShown = true;
-      }
+static void app_job_task(void *pvParameters) {
+  UiJob *job;
+  for (;;) {
+    if (xQueueReceive(s_jobQueue, &job, portMAX_DELAY) != pdTRUE) continue;
+    uint32_t t0 = micros();
+    job->ok = job->work ? job->work(job->ctx) : true;
+    task_stats_add(TASK_STAT_APP, micros() - t0);
+
+    // Must not be dropped: wait for room in the input queue
+    UiEvent e = UI_EVENT_JOB_DONE;
+    xQueueSend(s_events, &e, portMAX_DELAY);
   }
+}
 
-  // Handle Carousel Animation (Vertical)
-  if (abs(s_animOffset) > 0.001f || abs(s_animVelocity) > 0.001f) {
-      float force = -ANIM_K * s_animOffset;
-      s_animVelocity += force;
-      s_animVelocity *= ANIM_D;
-      s_animOffset += s_animVelocity;
-      if (abs(s_animOffset) < 0.005f && abs(s_animVelocity) < 0.005f) {
-          s_animOffset = 0.0f;
-          s_animVelocity = 0.0f;
-      }
-      needsRedraw = true;
+bool ui_runAsync(const char *label, UiJobWork work, UiJobDone done, void *ctx) {
+  LOCK_UI();
+  if (s_jobBusy) {
+    UNLOCK_UI();
+    if (label) oled_showToast("Busy...", 800);
+    return false;
   }
 
-  // Handle Horizontal Transition (App Enter/Exit)
-  if (abs(s_hAnimOffset - s_hAnimTarget) > 0.001f || abs(s_hAnimVelocity) > 0.001f) {
-      float force = -ANIM_K * (s_hAnimOffset - s_hAnimTarget);
-      s_hAnimVelocity += force;
-      s_hAnimVelocity *= ANIM_D;
-      s_hAnimOffset += s_hAnimVelocity;
-
-      if (abs(s_hAnimOffset - s_hAnimTarget) < 0.005f && abs(s_hAnimVelocity) < 0.005f) {
-          s_hAnimOffset = s_hAnimTarget;
-          s_hAnimVelocity = 0.0f;
-          if (s_hAnimTarget == 0.0f) s_lastView = NULL;
-      }
-      needsRedraw = true;
+  // Before ui_init() (boot / resume path): nothing to keep responsive
+  if (!s_jobQueue) {
+    UNLOCK_UI();
+    bool ok = work ? work(ctx) : true;
+    if (done) done(ok, ctx);
+    return true;
   }
 
-  // Handle Progress Animation
-  float target_p = 0.0f;
-  if (s_hAnimOffset > 0.5f) {
+  s_job = {label, work, done, ctx, false};
+  s_jobBusy = true;
+  power_noteActivity();
+  if (label) oled_showToast(label, UI_JOB_TOAST_MS);
+  UiJob *job = &s_job;
+  xQueueSend(s_jobQueue, &job, portMAX_DELAY); // depth 1 and idle: never waits
+  ui_invalidate(UI_DAMAGE_VIEW | UI_DAMAGE_OVERLAY);
+  UNLOCK_UI();
+  return true;
+}
+
+// Toasts and scrolling text, then the home clock's next minute
+static uint32_t _msUntilTimedFrame(void) {
+  uint32_t left = oled_msUntilUpdate();
+  time_t now = time(nullptr);
+  uint32_t minute = now > 1600000000 ? (uint32_t)(60 - now % 60) * 1000 : 60000 - millis() % 60000;
+  return minute < left ? minute : left;
+}
+
+uint32_t ui_msUntilNextFrame(void) {
+  LOCK_UI();
+  bool busy = s_moving || s_damage || s_jobBusy;
+  UNLOCK_UI();
+  if (busy || !controls_isIdle()) return 0;
+  return _msUntilTimedFrame();
+}
+
+bool ui_isLoading(void) {
+  LOCK_UI();
+  bool busy = s_jobBusy;
+  UNLOCK_UI();
+  return busy;
+}
+
+void ui_next(void) { _post(UI_EVENT_NEXT); }
+void ui_prev(void) { _post(UI_EVENT_PREV); }
+void ui_select(void) { _post(UI_EVENT_SELECT); }
+void ui_back(void) { _post(UI_EVENT_BACK); }
+
+// Advance the springs and fades by the time since the last frame. Returns
+// the damage.
+static uint8_t _stepAnimations(void) {
+  // Scroll indicator: target position, shown for a second after input
+  q16_t target_p = 0;
+  if (s_hAnim.value > Q16_ONE / 2) {
       // In-App progress
       const View* v = s_currentView ? s_currentView : s_lastView;
       if (v && v->getScrollProgress) target_p = v->getScrollProgress();
   } else {
       // Carousel progress (Skip Home at index 0)
       size_t count = AppRegistry::getApps().size();
-      if (count > 1) {
-          if (s_appIndex == 0) target_p = 0.0f;
-          else target_p = (float)s_appIndex / (float)(count - 1);
-      }
+      if (count > 1 && s_appIndex != 0) target_p = q16_div(s_appIndex, count - 1);
   }
+  anim_setTarget(&s_progress, target_p);
+  anim_setTarget(&s_progressOpacity, (millis() - s_lastInputTime < 1000) ? Q16_ONE : 0);
 
-  if (abs(s_progress - target_p) > 0.001f) {
-      s_progress += (target_p - s_progress) * 0.4f;
-      needsRedraw = true;
-  }
+  const q16_t v = s_vAnim.value, h = s_hAnim.value;
+  const q16_t p = s_progress.value, o = s_progressOpacity.value;
 
-  // Handle Scrollbar Visibility (Fades after 1 second)
-  float target_opacity = (millis() - s_lastInputTime < 1000) ? 1.0f : 0.0f;
-  if (abs(s_progressOpacity - target_opacity) > 0.001f) {
-      s_progressOpacity += (target_opacity - s_progressOpacity) * 0.2f;
-      if (abs(s_progressOpacity - target_opacity) < 0.01f) s_progressOpacity = target_opacity;
-      needsRedraw = true;
-  }
+  uint32_t now = micros();
+  anim_step(now - s_lastFrameUs);
+  s_lastFrameUs = now;
+
+  // Exit transition finished
+  if (!anim_isMoving(&s_hAnim) && s_hAnim.target == 0) s_lastView = NULL;
 
-  // Handle Hold Progress (Back action feedback)
-  float holdP = controls_getConfirmHoldProgress();
-  if (holdP > 0.01f) {
+  uint8_t damage = 0;
+  if (s_vAnim.value != v || s_hAnim.value != h) damage |= UI_DAMAGE_MOTION;
+  if (s_progress.value != p || s_progressOpacity.value != o) damage |= UI_DAMAGE_PROGRESS;
+  return damage;
+}
+
+// Damage the home clock when its minute or the WiFi icon changed (while the
+// carousel shows it)
+static uint8_t _clockDamage(void) {
+  if (s_hAnim.value >= Q16_CONST(0.99) || (s_appIndex != 0 && s_prevAppIndex != 0)) return 0;
+
+  time_t now = time(nullptr);
+  uint32_t minute = now > 1600000000 ? (uint32_t)(now / 60) : millis() / 60000;
+  bool wifi = wifi_isConnected();
+  if (minute == s_clockMinute && wifi == s_clockWifi) return 0;
+  s_clockMinute = minute;
+  s_clockWifi = wifi;
+  return UI_DAMAGE_CLOCK;
+}
+
+// GPIO interrupt: wake the UI task for the edge, once per tick
+static void IRAM_ATTR _onButtonEdge(void) {
+  if (s_edgeUs != 0 || s_events == NULL) return;
+  s_edgeUs = micros() | 1;
+  UiEvent e = UI_EVENT_WAKE;
+  BaseType_t woken = pdFALSE;
+  xQueueSendFromISR(s_events, &e, &woken);
+  portYIELD_FROM_ISR(woken);
+}
+
+// Loop task, after a button ended a light sleep (its edge was not captured)
+static void _onPowerWake(uint32_t wakeUs) {
+  controls_resync();
+  if (s_edgeUs == 0) s_edgeUs = wakeUs | 1;
+  UiEvent e = UI_EVENT_WAKE;
+  xQueueSend(s_events, &e, 0);
+}
+
+// One frame: input, animation steps for the time elapsed, redraw. Returns
+// true while something is moving.
+static bool _tick(void) {
+  // Button edges since the last frame; the callbacks post to the queue
+  uint32_t edgeUs = s_edgeUs;
+  s_edgeUs = 0;
+  controls_poll();
+
+  LOCK_UI();
+  UiEvent e;
+  while (xQueueReceive(s_events, &e, 0) == pdTRUE) _dispatch(e);
+
+  // Stepped against real time (utils/anim): a late frame catches up
+  // instead of slowing the motion down
+  uint8_t moved = _stepAnimations();
+
+  // Handle Hold Progress (Back action feedback, drawn by the OLED driver)
+  q16_t holdP = controls_getConfirmHoldProgress();
+  if (holdP > Q16_ONE / 100) {
       oled_showHoldToast(TOAST_BOTTOM, TOAST_ICON_BACK, holdP);
-      needsRedraw = true;
+      moved |= UI_DAMAGE_OVERLAY;
   }
 
-  // Handle Toast lifecycle redraws
-  if (oled_poll()) {
-    needsRedraw = true;
+  // Toast slide / expiry and scrolling text (animated by the OLED driver)
+  if (oled_poll()) moved |= UI_DAMAGE_OVERLAY;
+
+  s_damage |= moved | _clockDamage();
+  if (s_damage) {
+    s_damage = 0;
+    _render();
   }
+  s_moving = moved != 0;
+  UNLOCK_UI();
+
+  // Wake latency: edge to the frame that handled it
+  if (edgeUs) power_noteWakeLatency(micros() - edgeUs);
+  return moved != 0;
+}
 
-  if (needsRedraw) {
-    ui_redraw();
+static void ui_task(void *pvParameters) {
+  for (;;) {
+    uint32_t t0 = micros();
+    bool moving = _tick();
+    uint32_t spentUs = micros() - t0;
+    task_stats_add(TASK_STAT_UI, spentUs);
+
+    // Sleep out the tick while something moves or a button settles,
+    // otherwise until the next timed frame; an input event or damage from
+    // another task wakes us early
+    LOCK_UI();
+    bool damaged = s_damage != 0;
+    UNLOCK_UI();
+    uint32_t waitMs;
+    if (moving || damaged || !controls_isIdle()) {
+      uint32_t spentMs = spentUs / 1000;
+      waitMs = spentMs < UI_TICK_MS ? UI_TICK_MS - spentMs : 0;
+    } else {
+      waitMs = _msUntilTimedFrame();
+      if (waitMs == 0) waitMs = UI_TICK_MS;
+    }
+    UiEvent e;
+    xQueuePeek(s_events, &e, waitMs == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(waitMs));
   }
+}
 
-  // Poll current View or App
-  if (s_currentView) {
-      if (s_currentView->poll) s_currentView->poll();
-  } else {
-      const auto& apps = AppRegistry::getApps();
-      size_t count = apps.size();
-      if (s_appIndex < count && apps[s_appIndex]->poll) {
-          apps[s_appIndex]->poll();
+// App events (delivered on the loop task by AppRegistry::dispatch)
+static void _onTimeSync(struct timeval *tv) {
+  AppRegistry::publish(APP_EVENT_TIME_SYNCED, "sntp");
+}
+
+static void _onAppEvent(const AppEvent& event) {
+  switch (event.type) {
+    case APP_EVENT_NETWORK_DOWN:
+      ui_invalidate(UI_DAMAGE_CLOCK); // WiFi icon
+      break;
+
+    case APP_EVENT_NETWORK_UP:
+      ui_invalidate(UI_DAMAGE_CLOCK);
+      if (!s_timeConfigured) {
+        sntp_set_time_sync_notification_cb(_onTimeSync);
+        configTime(0, 0, "pool.ntp.org", "time.google.com");
+        s_timeConfigured = true;
       }
+      break;
+
+    case APP_EVENT_TIME_SYNCED: {
+      // Show wallpaper (with date) or just date on E-Paper (once)
+      time_t now = time(nullptr);
+      if (s_initialDateShown || now <= 1600000000) break;
+      epd_displayWallpaper(now);
+      s_initialDateShown = true;
+      struct tm tm;
+      localtime_r(&now, &tm);
+      s_shownYday = tm.tm_yday;
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+// Roll the date overlay over at midnight (overlay-only partial refresh)
+static void _onMinute(const AppEvent& event) {
+  if (!s_initialDateShown) return;
+  time_t now = time(nullptr);
+  struct tm tm;
+  localtime_r(&now, &tm);
+  if (tm.tm_yday != s_shownYday) {
+    epd_displayDate(now);
+    s_shownYday = tm.tm_yday;
+  }
+}
+
+// Initialization and Polling
+void ui_init(void) {
+  if (s_uiMutex == NULL) s_uiMutex = xSemaphoreCreateRecursiveMutex();
+  if (s_events == NULL) s_events = xQueueCreate(UI_EVENT_QUEUE_DEPTH, sizeof(UiEvent));
+  if (s_jobQueue == NULL) s_jobQueue = xQueueCreate(1, sizeof(UiJob *));
+
+  controls_setUseDefaultActions(false);
+  controls_setPrevCallback(ui_prev);
+  controls_setNextCallback(ui_next);
+  controls_setConfirmCallback(ui_select);
+  controls_setConfirmLongCallback(ui_back);
+
+  if (!s_subscribed) {
+    AppRegistry::subscribe(APP_EVENT_BIT(APP_EVENT_NETWORK_UP) | APP_EVENT_BIT(APP_EVENT_NETWORK_DOWN) |
+                           APP_EVENT_BIT(APP_EVENT_TIME_SYNCED), _onAppEvent);
+    AppRegistry::subscribeTick(60000, _onMinute);
+    controls_setEdgeCallback(_onButtonEdge);
+    power_setWakeCallback(_onPowerWake);
+    s_subscribed = true;
   }
+
+  LOCK_UI();
+  s_currentView = NULL;
+  s_lastView = NULL;
+  s_timeConfigured = false;
+  s_initialDateShown = false;
+  s_shownYday = -1;
+  anim_spring(&s_vAnim, ANIM_K, ANIM_D, Q16_CONST(0.005));
+  anim_spring(&s_hAnim, ANIM_K, ANIM_D, Q16_CONST(0.005));
+  anim_approach(&s_progress, Q16_CONST(0.4), Q16_CONST(0.001));
+  anim_approach(&s_progressOpacity, Q16_CONST(0.2), Q16_CONST(0.01));
+  anim_register(&s_vAnim);
+  anim_register(&s_hAnim);
+  anim_register(&s_progress);
+  anim_register(&s_progressOpacity);
+  s_prevAppIndex = 0;
+  s_lastInputTime = 0;
+  s_lastFrameUs = micros();
+
+  oled_setMenuMode(true);
+  _render();
+  UNLOCK_UI();
+
+  if (s_uiTaskHandle == NULL) {
+    if (UI_TASK_CORE < 0) xTaskCreate(ui_task, "ui_task", 8192, NULL, UI_TASK_PRIORITY, &s_uiTaskHandle);
+    else xTaskCreatePinnedToCore(ui_task, "ui_task", 8192, NULL, UI_TASK_PRIORITY, &s_uiTaskHandle, UI_TASK_CORE);
+  }
+  if (s_jobTaskHandle == NULL) {
+    if (APP_TASK_CORE < 0) xTaskCreate(app_job_task, "app_jobs", UI_JOB_STACK, NULL, APP_TASK_PRIORITY, &s_jobTaskHandle);
+    else xTaskCreatePinnedToCore(app_job_task, "app_jobs", UI_JOB_STACK, NULL, APP_TASK_PRIORITY, &s_jobTaskHandle, APP_TASK_CORE);
+  }
+}
+
+void ui_restoreApp(size_t index, const View* view) {
+  LOCK_UI();
+  if (index < AppRegistry::getApps().size()) s_appIndex = index;
+  s_prevAppIndex = s_appIndex;
+  s_currentView = view;
+  s_lastView = NULL;
+  anim_reset(&s_hAnim, view ? Q16_ONE : 0);
+  epd_setSourceTag(view ? view->title : "ui");
+  ui_invalidate(UI_DAMAGE_VIEW);
+  UNLOCK_UI();
+}
+
+void ui_poll(void) {
+  // Apps get events instead (AppRegistry::dispatch); only an open view polls
+  LOCK_UI();
+  if (s_currentView && s_currentView->poll) s_currentView->poll();
+  UNLOCK_UI();
 }
 
 // Introspection for Web UI
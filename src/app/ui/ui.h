@@ -24,12 +24,17 @@
 extern "C" {
 #endif
 
-// Initialize the UI: register button callbacks and show the initial menu.
+// Initialize the UI: register button callbacks, show the initial menu and
+// start the UI task (buttons, animations, OLED frames).
 void ui_init(void);
 
-// UI poll: call frequently (e.g. from loop) to update clock and WiFi status
+// UI poll: call frequently from loop() for the poll of the current view.
+// Apps and the clock / date run on app events (AppRegistry::dispatch).
 void ui_poll(void);
 
+// Navigation input. Safe from any task: the event is queued and handled in
+// order on the UI task.
+
 // Scroll to next menu item (short Next press)
 void ui_next(void);
 
@@ -46,6 +51,10 @@ void ui_back(void);
 struct View; // Forward decl
 void ui_setView(const View* view);
 
+// Jump to an app (carousel index) and optionally one of its views, without
+// the enter animation. Used to restore the UI after a deep-sleep wake.
+void ui_restoreApp(size_t index, const View* view);
+
 // Trigger vertical animation (transition effect)
 void ui_triggerVerticalAnimation(bool up);
 
@@ -55,6 +64,10 @@ int ui_getIndex(void);
 // Returns true if the UI is currently in the Text App screen
 bool ui_isInApp(void);
 
+// Milliseconds until the UI needs a frame again (0 while anything moves, a
+// button is down or a job runs): a deadline for the idle governor
+uint32_t ui_msUntilNextFrame(void);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
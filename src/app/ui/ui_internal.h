@@ -9,12 +9,44 @@ extern "C" {
 // Passing NULL returns to the main app carousel.
 void ui_setView(const View* view);
 
-// Request a redraw of the current screen
+// What changed since the last frame. The UI task renders and flushes a frame
+// only when something was marked; the bits say which source it was.
+enum UiDamage {
+  UI_DAMAGE_VIEW = 1 << 0,     // carousel entry / view contents
+  UI_DAMAGE_MOTION = 1 << 1,   // carousel / view springs
+  UI_DAMAGE_PROGRESS = 1 << 2, // scroll indicator
+  UI_DAMAGE_OVERLAY = 1 << 3,  // toasts, hold bar, scrolling text
+  UI_DAMAGE_CLOCK = 1 << 4     // home clock / WiFi icon
+};
+
+// Mark damage; the next UI frame (at most one tick away) redraws. Any task.
+void ui_invalidate(uint8_t damage);
+
+// Request a redraw of the current screen (ui_invalidate(UI_DAMAGE_VIEW)).
+// Several requests within a frame are drawn once.
 void ui_redraw(void);
 
 // Trigger a vertical animation (for submenus or carousel)
 void ui_triggerVerticalAnimation(bool up);
 
+// Current view (NULL in the carousel)
+const View* ui_getView(void);
+
+// Background work for views, so network / file I/O does not stall buttons,
+// animations and the HTTP server. `work` runs on the app worker task and
+// must only touch its own staging state (not what render() reads); `done`
+// then runs on the UI task with work's result and may update the view,
+// draw and switch views. While the job runs the UI shows `label` as a
+// loading toast. One job at a time: returns false (and shows "Busy") when
+// another is in flight. Background jobs (`label` NULL) show nothing, not
+// even "Busy". Callable from the loop task (app event handlers) too.
+typedef bool (*UiJobWork)(void* ctx);
+typedef void (*UiJobDone)(bool ok, void* ctx);
+bool ui_runAsync(const char* label, UiJobWork work, UiJobDone done, void* ctx);
+
+// True from ui_runAsync() until its done() has run
+bool ui_isLoading(void);
+
 #ifdef __cplusplus
 }
 #endif
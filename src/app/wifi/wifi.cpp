@@ -7,16 +7,41 @@
  *  - Connect in STA (client) mode using credentials from `secrets.h`.
  *  - Fall back to starting a soft-AP if STA connection fails.
  *  - Provide small helpers for retrieving the active IP and connection status.
+ *  - Publish APP_EVENT_NETWORK_UP / _DOWN (app/registry.h) as the STA link
+ *    comes and goes.
  */
 
 #include "wifi.h"
 #include "config.h"
 #include "secrets.h"
 
+#include "app/registry.h"
+
 #include <Arduino.h>
 #include <WiFi.h>
 
+static volatile bool s_staUp = false;
+
+// WiFi event task: disconnects repeat while reconnecting, report the edge only
+static void onWiFiEvent(arduino_event_id_t event) {
+  if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+    s_staUp = true;
+    AppRegistry::publish(APP_EVENT_NETWORK_UP, "wifi");
+  } else if (s_staUp) {
+    s_staUp = false;
+    AppRegistry::publish(APP_EVENT_NETWORK_DOWN, "wifi");
+  }
+}
+
 void connectWiFi() {
+  static bool hooked = false;
+  if (!hooked) {
+    WiFi.onEvent(onWiFiEvent, ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    WiFi.onEvent(onWiFiEvent, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+    WiFi.onEvent(onWiFiEvent, ARDUINO_EVENT_WIFI_STA_LOST_IP);
+    hooked = true;
+  }
+
   Serial.print("Connecting to WiFi SSID: ");
   Serial.println(WIFI_SSID);
 
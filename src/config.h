@@ -11,6 +11,14 @@
 
 #include <Arduino.h>
 
+// E-paper frame buffer rows (EPD_FB_ROWS, set per board below):
+//  - EPD_FB_FULL: whole frame per layer. Fastest; the wallpaper stays cached
+//    and partial jobs draw over what is on screen.
+//  - N rows: paged. Each job is redrawn once per page of N rows (twice for
+//    updates that write both controller buffers). Partial jobs repaint their
+//    window on white. Can be changed at runtime, see epd_setFramebufferRows().
+constexpr uint16_t EPD_FB_FULL = 0;
+
 #ifdef BOARD_SEEED_XIAO_ESP32C6
 // SPI pins (explicitly set to ensure consistent SPI.begin(...) usage)
 // Seeed Studio XIAO ESP32C6 Pinout
@@ -32,7 +40,30 @@ constexpr uint8_t OLED_I2C_ADDR = 0x3C;
 // Input Controls
 constexpr uint8_t PIN_BUTTON_PREV    = 0;  // D0
 constexpr uint8_t PIN_BUTTON_NEXT    = 1;  // D1
-constexpr uint8_t PIN_BUTTON_CONFIRM = 20; // D9 (Repurposed MISO)
+constexpr uint8_t PIN_BUTTON_CONFIRM = 20; // D9 (Repurposed MISO), cannot wake from deep sleep
+
+// E-paper frame buffer: paged, 4 KB instead of 19 KB for the layer stack.
+// Paged layers keep no whole frame, so /api/epd/screenshot answers 409 on
+// this board until /api/epd/buffer switches to full frame and the panel is
+// redrawn (or set EPD_FB_FULL here).
+constexpr uint16_t EPD_FB_ROWS = 64;
+// Queued image payloads: one full "bw" frame plus change
+constexpr size_t EPD_JOB_ARENA_BYTES = 6 * 1024;
+
+// Task placement: single core, so only priorities apply. The EPD task shares
+// loop()'s priority (round robin, so rendering cannot starve the apps).
+constexpr int EPD_TASK_CORE = -1; // no affinity
+constexpr uint8_t EPD_TASK_PRIORITY = 1;
+// UI task (buttons, animations) above loop() and rendering: an HTTP request
+// or a page raster cannot delay a frame
+constexpr int UI_TASK_CORE = -1;
+constexpr uint8_t UI_TASK_PRIORITY = 2;
+// App worker (fetches, opening books) next to loop(), below the UI
+constexpr int APP_TASK_CORE = -1;
+constexpr uint8_t APP_TASK_PRIORITY = 1;
+
+// No standby frame buffer (page turns rasterize on demand)
+constexpr bool EPD_STANDBY_BUFFER = false;
 #elif defined(BOARD_SEEED_XIAO_ESP32S3)
 // Seeed Studio XIAO ESP32S3 Pinout
 constexpr uint8_t PIN_SCK  = D8;
@@ -54,6 +85,29 @@ constexpr uint8_t OLED_I2C_ADDR = 0x3C;
 constexpr uint8_t PIN_BUTTON_PREV    = D0;
 constexpr uint8_t PIN_BUTTON_NEXT    = D1;
 constexpr uint8_t PIN_BUTTON_CONFIRM = D9; // Repurposed MISO
+
+// E-paper frame buffer: full frame (enough RAM, keeps the wallpaper cached)
+constexpr uint16_t EPD_FB_ROWS = EPD_FB_FULL;
+// Queued image payloads: three full "bw" frames
+constexpr size_t EPD_JOB_ARENA_BYTES = 15 * 1024;
+
+// Task placement: rendering on core 0 (next to WiFi), leaving core 1
+// to the UI task and loop() (HTTP server, apps) so OLED animations keep their
+// frame rate while a page rasterizes
+constexpr int EPD_TASK_CORE = 0;
+constexpr uint8_t EPD_TASK_PRIORITY = 2;
+// UI task (buttons, animations) on core 1 above loop(), so an HTTP request
+// cannot delay a frame
+constexpr int UI_TASK_CORE = 1;
+constexpr uint8_t UI_TASK_PRIORITY = 2;
+// App worker (fetches, opening books) on core 1 next to loop(), below the
+// UI; the network stack itself runs on core 0
+constexpr int APP_TASK_CORE = 1;
+constexpr uint8_t APP_TASK_PRIORITY = 1;
+
+// Standby frame buffer (+4.6 KB): the next reader page is rasterized while
+// the current one is read, so a page turn is only the panel refresh
+constexpr bool EPD_STANDBY_BUFFER = true;
 #else
 #error "Board not supported or not defined!"
 #endif
@@ -64,6 +118,20 @@ constexpr uint16_t WEB_SERVER_PORT = 80;
 // Behavior flags (tweak for your panel / use-case)
 constexpr bool ENABLE_FORCE_CLEAR    = true; // run recovery clear at startup if true
 constexpr bool ENABLE_PARTIAL_UPDATE = false;  // attempt partial updates when supported
+constexpr bool ENABLE_DEEP_SLEEP     = false;  // sleep when idle, wake on the buttons (see app/power)
+
+// Deep sleep
+constexpr unsigned long POWER_IDLE_TIMEOUT_MS = 60000UL; // no input for this long -> deep sleep
+
+// Light sleep between loop() passes (see app/power)
+constexpr bool ENABLE_LIGHT_SLEEP = true;
+constexpr uint32_t POWER_LIGHT_SLEEP_MIN_MS = 20;    // shorter idle gaps are a plain task delay
+constexpr uint32_t POWER_LIGHT_SLEEP_MAX_MS = 60000; // wake at least this often
+constexpr uint32_t POWER_NET_POLL_MS = 5;            // HTTP polling while a client is served
+constexpr uint32_t POWER_NET_IDLE_POLL_MS = 100;     // ... and when none was for POWER_NET_ACTIVE_MS
+constexpr uint32_t POWER_NET_ACTIVE_MS = 1000;
+constexpr uint32_t POWER_WAKE_TARGET_US = 10000;     // button edge to handled frame
+constexpr uint32_t POWER_HTTP_TARGET_US = 150000;    // request ready to its handler (idle poll included)
 
 // Misc
 constexpr unsigned long WIFI_CONNECT_TIMEOUT_MS = 15000UL; // how long to wait for STA connect
\ No newline at end of file
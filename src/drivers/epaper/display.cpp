@@ -4,19 +4,31 @@
   Implementation of the e-paper display helper API.
   Refactored to use a background FreeRTOS task to ensure the system remains responsive
   during long E-Ink refresh cycles.
+
+  Rendering goes into persistent 1-bpp layers (see framebuffer.h) which are
+  composited band by band and written straight to the controller RAM. The
+  wallpaper stays cached in the background layer, so a date change only
+  recomposites the overlay rectangle and refreshes that window.
+  Text is drawn from pre-rasterized glyphs (see glyph_atlas.h).
 */
 
 #include "display.h"
+#include "framebuffer.h"
+#include "glyph_atlas.h"
+#include "gray4.h"
+#include "stats.h"
 #include "config.h"
 #include "utils/base64.h"
+#include "utils/rle.h"
+#include "utils/task_stats.h"
 #include "drivers/oled/oled.h"
 
 #include <SPI.h>
 #include <GxEPD2_BW.h>
-#include <U8g2_for_Adafruit_GFX.h>
 #include <LittleFS.h>
 
 #include <algorithm>
+#include <functional>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/queue.h>
@@ -30,7 +42,12 @@ enum epd_job_type_t {
   JOB_FORCE_CLEAR,
   JOB_DATE,
   JOB_HEADER,
-  JOB_PAGE
+  JOB_PAGE,
+  JOB_WALLPAPER,
+  JOB_GRAY,
+  JOB_BUFFER,
+  JOB_HIBERNATE,
+  JOB_STANDBY
 };
 
 #include "layout.h"
@@ -42,16 +59,55 @@ struct epd_job_t {
   bool forceFull;
   int width;
   int height;
-  std::vector<uint8_t> data;
+  const uint8_t *data;            // payload: job arena block or heapData
+  size_t dataLen;
+  std::vector<uint8_t> heapData;  // payloads the arena cannot take
   String format;
   String imageColor;
   time_t time;
   EpdPage page;
+  const char *source;   // tag of the queueing task (static string)
+  uint32_t enqueuedUs;
+  uint32_t enqueuedMs;
+};
+
+// Job slots: the queue depth plus the job the task is running. Slots are
+// reset in place and keep their String / vector capacity, so steady display
+// traffic does not allocate from the heap.
+#define EPD_JOB_QUEUE_DEPTH 5
+#define EPD_JOB_SLOTS (EPD_JOB_QUEUE_DEPTH + 1)
+static epd_job_t s_jobSlots[EPD_JOB_SLOTS];
+
+// Image payloads of queued jobs (EPD_JOB_ARENA_BYTES, see config.h). Blocks
+// are handed out round the ring in queue order and freed when their job is
+// done; a payload that does not fit falls back to the heap.
+struct epd_arena_hdr_t {
+  uint32_t size;   // block bytes including this header
+  uint32_t live;
 };
+alignas(4) static uint8_t s_arena[EPD_JOB_ARENA_BYTES];
+static size_t s_arenaHead = 0;
+static size_t s_arenaTail = 0;
+static size_t s_arenaUsed = 0;
+static volatile uint32_t s_heapPayloads = 0;
 
 // --- Hardware ---
-static GxEPD2_BW<GxEPD2_290_T94_V2, GxEPD2_290_T94_V2::HEIGHT> display(GxEPD2_290_T94_V2(PIN_CS, PIN_DC, PIN_RST, PIN_BUSY));
-static U8G2_FOR_ADAFRUIT_GFX s_u8g2_epd;
+// Bare panel driver: frames come from the layers (framebuffer.h), so the
+// GxEPD2_BW page buffer would be dead weight.
+static GxEPD2_290_T94_V2_G4 epd2(PIN_CS, PIN_DC, PIN_RST, PIN_BUSY);
+
+// Rows composited per controller write (band buffer lives in static RAM)
+#define EPD_BAND_ROWS 16
+static uint8_t s_band[(GxEPD2_290_T94_V2::WIDTH / 8) * EPD_BAND_ROWS];
+
+// /wallpaper.bin layout:
+//   legacy : [w:2 BE][h:2 BE][raw rows]
+//   v1     : 'W' 'P' [version = 1] [format] [w:2 BE][h:2 BE][data]
+#define WALLPAPER_PATH "/wallpaper.bin"
+#define WALLPAPER_VERSION 1
+#define WALLPAPER_RAW 0
+#define WALLPAPER_RLE 1
+#define WALLPAPER_MAX_ROW 64 // bytes per row (512 px)
 
 // --- State ---
 static String g_currentText = "Hello API";
@@ -59,76 +115,195 @@ static uint16_t g_currentColor = GxEPD_BLACK;
 static bool g_partialEnabled = ENABLE_PARTIAL_UPDATE;
 static volatile bool s_isBlockedByTask = false;
 
+// Source tags per queueing task (epd_setSourceTag), under s_tagMutex (not
+// s_stateMutex: that one is held for a whole render). The strings are
+// static, so a job keeps the pointer.
+#define EPD_SOURCE_TASKS 4
+struct EpdSourceTag {
+  TaskHandle_t task;
+  const char *tag;
+};
+static EpdSourceTag s_sourceTags[EPD_SOURCE_TASKS];
+static SemaphoreHandle_t s_tagMutex = NULL;
+
+// Timing of the job being executed (task only)
+static EpdJobStats s_jobStats;
+
+// Start of the job's current CPU stretch (task only). The task's load is
+// booked stretch by stretch: panel BUSY waits and delays block the task,
+// so they are not load, and a long refresh does not land in one window.
+static uint32_t s_cpuMarkUs = 0;
+
+static void _bookCpu(void) {
+  uint32_t now = micros();
+  task_stats_add(TASK_STAT_EPD, now - s_cpuMarkUs);
+  s_cpuMarkUs = now;
+}
+
+static void _resumeCpu(void) {
+  s_cpuMarkUs = micros();
+}
+
+// Delay the task without counting it as load
+static void _idleDelay(uint32_t ms) {
+  _bookCpu();
+  vTaskDelay(pdMS_TO_TICKS(ms));
+  _resumeCpu();
+}
+
+// Layer bookkeeping (task only, except s_bgDirty)
+static bool s_bgValid = false;            // background layer holds the wallpaper
+static volatile bool s_bgDirty = false;   // wallpaper file changed since it was cached
+static bool s_wallpaperShown = false;     // panel currently shows background + overlay
+
+// Paged mode: redraws the layers for the current page window (set for the
+// duration of one _present by the job being rendered)
+static std::function<void()> s_paintPage;
+
+// Standby page: drawn ahead of time into the standby canvas (task only)
+static EpdPage s_standbyPage;
+static bool s_standbyValid = false;
+static volatile bool s_standbyEnabled = false; // canvas allocated (mirrored for callers)
+
+// Layer stack size, mirrored for readers outside the task
+static volatile uint16_t s_fbRows = 0;
+static volatile size_t s_fbBytes = 0;
+
+// epd_setFramebufferRows() requests queued / applied, and the last outcome
+static volatile uint32_t s_bufferRequests = 0;
+static volatile uint32_t s_bufferApplied = 0;
+static volatile EpdBufferResult s_bufferResult = EPD_BUFFER_OK;
+
 // --- Task & Queue ---
 static TaskHandle_t s_epdTaskHandle = NULL;
 static QueueHandle_t s_jobQueue = NULL;
+static QueueHandle_t s_jobFree = NULL;
+static SemaphoreHandle_t s_arenaMutex = NULL;
 static SemaphoreHandle_t s_stateMutex = NULL;
 
+static void _releaseJob(epd_job_t *job);
+
 // Internal execution helpers (called from task)
 static void _exec_displayText(const epd_job_t &job);
 static void _exec_displayHeader(const epd_job_t &job);
 static void _exec_drawImage(const epd_job_t &job);
 static void _exec_displayPage(const epd_job_t &job);
+static void _exec_prepareStandby(const epd_job_t &job);
 static void _exec_clear(bool force);
+static void _exec_wallpaper(const epd_job_t &job, bool dateOnly);
+static void _exec_drawGray(const epd_job_t &job);
+static void _exec_setBuffer(const epd_job_t &job);
+
+static const char *_jobTypeName(epd_job_type_t type) {
+  switch (type) {
+    case JOB_TEXT: return "text";
+    case JOB_IMAGE: return "image";
+    case JOB_CLEAR: return "clear";
+    case JOB_FORCE_CLEAR: return "force_clear";
+    case JOB_DATE: return "date";
+    case JOB_HEADER: return "header";
+    case JOB_PAGE: return "page";
+    case JOB_WALLPAPER: return "wallpaper";
+    case JOB_GRAY: return "gray";
+    case JOB_BUFFER: return "buffer";
+    case JOB_HIBERNATE: return "hibernate";
+    case JOB_STANDBY: return "standby";
+  }
+  return "?";
+}
+
+// Run one job (task, state mutex held)
+static void _runJob(const epd_job_t &job) {
+  switch (job.type) {
+    case JOB_TEXT:
+      _exec_displayText(job);
+      break;
+    case JOB_IMAGE:
+      _exec_drawImage(job);
+      break;
+    case JOB_CLEAR:
+      _exec_clear(false);
+      break;
+    case JOB_FORCE_CLEAR:
+      _exec_clear(true);
+      break;
+    case JOB_DATE:
+      _exec_wallpaper(job, true);
+      break;
+    case JOB_WALLPAPER:
+      _exec_wallpaper(job, false);
+      break;
+    case JOB_HEADER:
+      _exec_displayHeader(job);
+      break;
+    case JOB_PAGE:
+      _exec_displayPage(job);
+      break;
+    case JOB_GRAY:
+      _exec_drawGray(job);
+      break;
+    case JOB_BUFFER:
+      _exec_setBuffer(job);
+      break;
+    case JOB_HIBERNATE:
+      // Panel off, controller RAM kept; the next write resets it
+      epd2.hibernate();
+      break;
+    case JOB_STANDBY:
+      _exec_prepareStandby(job);
+      break;
+  }
+}
 
 // Background task worker
 static void epd_worker_task(void *pvParameters) {
+  (void)pvParameters;
   Serial.println("EPD Task: started");
-  
+
   while (true) {
     epd_job_t *job = nullptr;
     // Wait for a job to arrive in the queue
     if (xQueueReceive(s_jobQueue, &job, portMAX_DELAY) == pdPASS && job != nullptr) {
       s_isBlockedByTask = true;
-      
-      switch (job->type) {
-        case JOB_TEXT:
-          _exec_displayText(*job);
-          break;
-        case JOB_IMAGE:
-          _exec_drawImage(*job);
-          break;
-        case JOB_CLEAR:
-          _exec_clear(false);
-          break;
-        case JOB_FORCE_CLEAR:
-          _exec_clear(true);
-          break;
-        case JOB_DATE:
-          // Display date in DD.MM format at bottom-right (same as wallpaper overlay)
-          {
-            struct tm tm;
-            localtime_r(&job->time, &tm);
-            char buf[16];
-            snprintf(buf, sizeof(buf), "%02d.%02d", tm.tm_mday, tm.tm_mon + 1);
-            
-            // Create image job with date text overlay (empty image, just date)
-            epd_job_t dateJob = *job;
-            dateJob.type = JOB_IMAGE;
-            dateJob.width = display.width();
-            dateJob.height = display.height();
-            dateJob.data.clear(); // Empty image data
-            dateJob.format = "empty"; // Special marker for empty image
-            dateJob.imageColor = "black";
-            dateJob.forceFull = true;
-            dateJob.text = String(buf);
-            _exec_drawImage(dateJob);
-          }
-          break;
-        case JOB_HEADER:
-          _exec_displayHeader(*job);
-          break;
-        case JOB_PAGE:
-          _exec_displayPage(*job);
-          break;
+
+      uint32_t startUs = micros();
+      s_cpuMarkUs = startUs;
+      memset(&s_jobStats, 0, sizeof(s_jobStats));
+      s_jobStats.type = _jobTypeName(job->type);
+      strncpy(s_jobStats.source, job->source, sizeof(s_jobStats.source) - 1);
+      s_jobStats.enqueuedMs = job->enqueuedMs;
+      s_jobStats.us[EPD_PHASE_QUEUE] = startUs - job->enqueuedUs;
+
+      // Layers change only while a job holds the state mutex (see epd_snapshot)
+      xSemaphoreTake(s_stateMutex, portMAX_DELAY);
+      // Without layers only a new buffer size or sleep can be applied
+      if (!epd_fb_isReady() && job->type != JOB_BUFFER && job->type != JOB_HIBERNATE) {
+        Serial.printf("EPD: no frame buffer, dropping %s job\n", s_jobStats.type);
+      } else {
+        _runJob(*job);
       }
-      
-      delete job;
+      xSemaphoreGive(s_stateMutex);
+
+      // Raster time is whatever was not spent talking to the panel
+      uint32_t totalUs = micros() - startUs;
+      s_jobStats.us[EPD_PHASE_TOTAL] = totalUs;
+      uint32_t ioUs = s_jobStats.us[EPD_PHASE_TRANSFER] + s_jobStats.us[EPD_PHASE_BUSY];
+      s_jobStats.us[EPD_PHASE_RASTER] = totalUs > ioUs ? totalUs - ioUs : 0;
+      epd_stats_record(s_jobStats);
+      _bookCpu();
+
+      _releaseJob(job);
       s_isBlockedByTask = false;
     }
   }
 }
 
+// Pinned to EPD_TASK_CORE on dual-core boards, left to the scheduler otherwise
+static void _createTask(TaskFunction_t fn, const char *name, uint32_t stack, UBaseType_t priority, TaskHandle_t *handle) {
+  if (EPD_TASK_CORE < 0) xTaskCreate(fn, name, stack, NULL, priority, handle);
+  else xTaskCreatePinnedToCore(fn, name, stack, NULL, priority, handle, EPD_TASK_CORE);
+}
+
 void epd_init() {
   // Initialize SPI
   SPI.begin(PIN_SCK, PIN_MISO, PIN_MOSI, PIN_CS);
@@ -140,168 +315,401 @@ void epd_init() {
   }
 
   // Init e-paper display hardware
-  display.init(115200, false, 50, false);
-  
-  // Init U8g2 helper
-  s_u8g2_epd.begin(display);
-  s_u8g2_epd.setFont(u8g2_font_profont29_tr);
-  s_u8g2_epd.setForegroundColor(GxEPD_BLACK);
-  s_u8g2_epd.setBackgroundColor(GxEPD_WHITE);
+  epd2.init(115200, false, 50, false);
+
+  // Layer buffers (background / content / overlay), full frame or paged per
+  // board; smaller pages when the heap is short
+  if (!epd_fb_init(epd2.WIDTH, epd2.HEIGHT, EPD_FB_ROWS)) {
+    Serial.println("EPD: failed to allocate layers, drawing jobs are refused");
+  } else if (epd_fb_rows() != (EPD_FB_ROWS == EPD_FB_FULL ? epd2.HEIGHT : EPD_FB_ROWS)) {
+    Serial.printf("EPD: not enough RAM for the frame buffer, using %u-row pages\n", (unsigned)epd_fb_rows());
+  }
+  s_standbyEnabled = EPD_STANDBY_BUFFER && epd_fb_setStandby(true);
+  s_fbRows = epd_fb_rows();
+  s_fbBytes = epd_fb_bytes();
+
+  // Rasterize the fonts once
+  if (!epd_atlas_init()) {
+    Serial.println("EPD: failed to build glyph atlas");
+  }
 
   // Sync state mutex
   s_stateMutex = xSemaphoreCreateMutex();
-  
-  // Create job queue (limit to 5 pending jobs to avoid memory exhaustion)
-  s_jobQueue = xQueueCreate(5, sizeof(epd_job_t *));
-  
-  // Start the background task
-  // Priority slightly lower than main loop to favor UI/Net responsiveness
-  xTaskCreate(epd_worker_task, "epd_task", 8192, NULL, 1, &s_epdTaskHandle);
+  if (s_tagMutex == NULL) s_tagMutex = xSemaphoreCreateMutex();
+  epd_stats_reset();
+
+  // Job queue (limited to avoid memory exhaustion) and its free slots
+  s_jobQueue = xQueueCreate(EPD_JOB_QUEUE_DEPTH, sizeof(epd_job_t *));
+  s_jobFree = xQueueCreate(EPD_JOB_SLOTS, sizeof(epd_job_t *));
+  for (int i = 0; i < EPD_JOB_SLOTS; ++i) {
+    epd_job_t *job = &s_jobSlots[i];
+    xQueueSend(s_jobFree, &job, 0);
+  }
+  s_arenaMutex = xSemaphoreCreateMutex();
+
+  // Placement per board (config.h)
+  _createTask(epd_worker_task, "epd_task", 8192, EPD_TASK_PRIORITY, &s_epdTaskHandle);
 
   if (oled_isAvailable()) {
     oled_showStatus("Ready");
   }
 }
 
+// --- Job slots ---
+
+static size_t _align4(size_t n) { return (n + 3) & ~(size_t)3; }
+
+// Reserve `n` bytes in the payload arena, or NULL when it is full
+static uint8_t *_arenaAlloc(size_t n) {
+  const size_t N = sizeof(s_arena);
+  const size_t need = _align4(n) + sizeof(epd_arena_hdr_t);
+  if (s_arenaMutex == NULL || need > N) return NULL;
+
+  xSemaphoreTake(s_arenaMutex, portMAX_DELAY);
+  if (s_arenaUsed == 0) s_arenaHead = s_arenaTail = 0;
+
+  // Free space: [head, N) + [0, tail) when head is ahead, else [head, tail)
+  size_t at = N;
+  if (s_arenaUsed == 0 || s_arenaHead > s_arenaTail) {
+    if (N - s_arenaHead >= need) {
+      at = s_arenaHead;
+    } else if (s_arenaTail >= need) {
+      // Wrap: the end of the ring becomes a dead block
+      if (N - s_arenaHead >= sizeof(epd_arena_hdr_t)) {
+        epd_arena_hdr_t *pad = (epd_arena_hdr_t *)&s_arena[s_arenaHead];
+        pad->size = N - s_arenaHead;
+        pad->live = 0;
+      }
+      s_arenaUsed += N - s_arenaHead;
+      at = 0;
+    }
+  } else if (s_arenaHead < s_arenaTail && s_arenaTail - s_arenaHead >= need) {
+    at = s_arenaHead;
+  }
+
+  uint8_t *block = NULL;
+  if (at < N) {
+    epd_arena_hdr_t *hdr = (epd_arena_hdr_t *)&s_arena[at];
+    hdr->size = need;
+    hdr->live = 1;
+    s_arenaHead = (at + need) % N;
+    s_arenaUsed += need;
+    block = (uint8_t *)(hdr + 1);
+  }
+  xSemaphoreGive(s_arenaMutex);
+  return block;
+}
+
+// Free a block; the tail moves over every freed block at the front of the ring
+static void _arenaFree(const uint8_t *block) {
+  const size_t N = sizeof(s_arena);
+  xSemaphoreTake(s_arenaMutex, portMAX_DELAY);
+  ((epd_arena_hdr_t *)block - 1)->live = 0;
+  while (s_arenaUsed > 0) {
+    if (N - s_arenaTail < sizeof(epd_arena_hdr_t)) { // padding too small for a header
+      s_arenaUsed -= N - s_arenaTail;
+      s_arenaTail = 0;
+      continue;
+    }
+    const epd_arena_hdr_t *hdr = (const epd_arena_hdr_t *)&s_arena[s_arenaTail];
+    if (hdr->live) break;
+    s_arenaUsed -= hdr->size;
+    s_arenaTail = (s_arenaTail + hdr->size) % N;
+  }
+  xSemaphoreGive(s_arenaMutex);
+}
+
+static bool _inArena(const uint8_t *p) {
+  return p >= s_arena && p < s_arena + sizeof(s_arena);
+}
+
+// Take a free slot, or NULL when every slot is queued or running
+static epd_job_t *_newJob(epd_job_type_t type) {
+  epd_job_t *job = NULL;
+  if (s_jobFree == NULL || xQueueReceive(s_jobFree, &job, 0) != pdPASS) {
+    Serial.println("EPD: Job queue full, skipping request");
+    return NULL;
+  }
+  job->type = type;
+  return job;
+}
+
+// Copy an image payload into the arena (heap when it does not fit)
+static void _setPayload(epd_job_t *job, const std::vector<uint8_t> &data) {
+  uint8_t *block = _arenaAlloc(data.size());
+  if (block) {
+    memcpy(block, data.data(), data.size());
+    job->data = block;
+  } else {
+    s_heapPayloads++;
+    job->heapData = data;
+    job->data = job->heapData.data();
+  }
+  job->dataLen = data.size();
+}
+
+// Reset a slot in place and give it back. Strings and the page keep their
+// buffers for the next job; heap payloads and shared page text are released.
+static void _releaseJob(epd_job_t *job) {
+  if (_inArena(job->data)) _arenaFree(job->data);
+  job->data = NULL;
+  job->dataLen = 0;
+  if (!job->heapData.empty()) std::vector<uint8_t>().swap(job->heapData);
+
+  job->text = "";
+  job->color = 0;
+  job->forceFull = false;
+  job->width = 0;
+  job->height = 0;
+  job->format = "";
+  job->imageColor = "";
+  job->time = 0;
+  job->page.title = "";
+  job->page.text.reset();
+  xQueueSend(s_jobFree, &job, 0);
+}
+
 // Queue a job safely
 static bool _queueJob(epd_job_t *job) {
   if (s_jobQueue == NULL || job == NULL) return false;
-  
+
+  job->source = epd_getSourceTag();
+  job->enqueuedUs = micros();
+  job->enqueuedMs = millis();
+
   // Try to send to queue. If full, we fail.
   // We use 0 wait time to avoid blocking the caller.
   if (xQueueSend(s_jobQueue, &job, 0) != pdPASS) {
     Serial.println("EPD: Job queue full, skipping request");
-    delete job;
+    _releaseJob(job);
     return false;
   }
   return true;
 }
 
+// Check dimensions against the payload for a given format ("bw"/"3c" raw, "rle" PackBits)
+static bool _isValidImage(int width, int height, const std::vector<uint8_t> &data, const char *format) {
+  if (width <= 0 || height <= 0 || width > 0xFFFF || height > 0xFFFF) return false;
+  const size_t bytesPerRow = (width + 7) / 8;
+
+  if (strcmp(format, "rle") == 0) {
+    std::vector<uint8_t> row(bytesPerRow);
+    rle_stream_t rs;
+    rle_stream_begin(&rs, row.data(), bytesPerRow, height, NULL, NULL);
+    return rle_stream_feed(&rs, data.data(), data.size()) && rle_stream_done(&rs);
+  }
+  if (strcmp(format, "bw") == 0 || strcmp(format, "3c") == 0) {
+    return data.size() >= bytesPerRow * height;
+  }
+  return false;
+}
+
+static bool _isGrayFormat(const char *format) {
+  return strcmp(format, "g4") == 0 || strcmp(format, "g8") == 0;
+}
+
+// "g4": 2 bpp packed (4 px per byte, MSB first), "g8": 1 byte of luminance per pixel
+static bool _isValidGray(int width, int height, const std::vector<uint8_t> &data, const char *format) {
+  if (width <= 0 || height <= 0) return false;
+  size_t bytesPerRow = (strcmp(format, "g8") == 0) ? width : (width + 3) / 4;
+  return data.size() >= bytesPerRow * height;
+}
+
 void epd_displayText(const String &txt, uint16_t color, bool forceFull) {
   if (txt.length() == 0) return;
-  
-  epd_job_t *job = new epd_job_t();
-  job->type = JOB_TEXT;
+
+  epd_job_t *job = _newJob(JOB_TEXT);
+  if (!job) return;
   job->text = txt;
   job->color = color;
   job->forceFull = forceFull;
-  
+
   _queueJob(job);
 }
 
 void epd_displayHeader(const String &txt) {
     if (txt.length() == 0) return;
-    epd_job_t *job = new epd_job_t();
-    job->type = JOB_HEADER;
+    epd_job_t *job = _newJob(JOB_HEADER);
+    if (!job) return;
     job->text = txt;
     _queueJob(job);
 }
 
 void epd_displayDate(time_t now) {
-  epd_job_t *job = new epd_job_t();
-  job->type = JOB_DATE;
+  epd_job_t *job = _newJob(JOB_DATE);
+  if (!job) return;
   job->time = now;
-  
+
   _queueJob(job);
 }
 
 void epd_displayWallpaper(time_t now) {
-  int width = 128;
-  int height = 296;
-  std::vector<uint8_t> data;
-  
-  // Check if custom wallpaper exists
-  if (LittleFS.exists("/wallpaper.bin")) {
-    File f = LittleFS.open("/wallpaper.bin", "r");
-    if (f) {
-      // Read header
-      uint8_t header[4];
-      if (f.read(header, 4) == 4) {
-        width = (header[0] << 8) | header[1];
-        height = (header[2] << 8) | header[3];
-        
-        // Read bitmap data
-        size_t dataSize = f.size() - 4;
-        data.resize(dataSize);
-        if (f.read(data.data(), dataSize) == dataSize) {
-          f.close();
-          goto display_wallpaper; // Successfully loaded custom wallpaper
-        }
-      }
-      f.close();
-    }
-  }
-  
-  // Generate default noisy wallpaper
-  {
-    int bytesPerRow = (width + 7) / 8;
-    size_t totalBytes = bytesPerRow * height;
-    data.resize(totalBytes);
-    
-    // Generate random noise pattern with fixed seed for consistency
-    randomSeed(42);
-    for (size_t i = 0; i < totalBytes; i++) {
-      data[i] = random(256);
-    }
-  }
-  
-display_wallpaper:
-  // Prepare date string in DD.MM format
-  struct tm tm;
-  localtime_r(&now, &tm);
-  char dateBuf[16];
-  snprintf(dateBuf, sizeof(dateBuf), "%02d.%02d", tm.tm_mday, tm.tm_mon + 1);
-  
-  // Queue a job to draw wallpaper + date
-  epd_job_t *job = new epd_job_t();
-  job->type = JOB_IMAGE;
-  job->width = width;
-  job->height = height;
-  job->data = data;
-  job->format = "bw";
-  job->imageColor = "black";
+  // The task loads /wallpaper.bin (or the default noise) only when its cache is stale
+  epd_job_t *job = _newJob(JOB_WALLPAPER);
+  if (!job) return;
+  job->time = now;
   job->forceFull = true;
-  job->text = String(dateBuf); // Store date in text field for overlay
-  
+
   _queueJob(job);
 }
 
+void epd_invalidateWallpaper(void) {
+  s_bgDirty = true;
+}
+
+bool epd_saveWallpaper(int width, int height, const std::vector<uint8_t> &data, const char *format) {
+  if (!_isValidImage(width, height, data, format)) return false;
+
+  const std::vector<uint8_t> *payload = &data;
+  size_t payloadSize = data.size();
+  uint8_t fileFormat = WALLPAPER_RLE;
+  std::vector<uint8_t> packed;
+
+  if (strcmp(format, "rle") != 0) {
+    // Raw uploads are compressed on the way to flash when that helps
+    payloadSize = (size_t)((width + 7) / 8) * height;
+    rle_encode(data.data(), payloadSize, packed);
+    if (packed.size() < payloadSize) {
+      payload = &packed;
+      payloadSize = packed.size();
+    } else {
+      fileFormat = WALLPAPER_RAW;
+    }
+  }
+
+  File f = LittleFS.open(WALLPAPER_PATH, "w");
+  if (!f) return false;
+
+  uint8_t header[8] = {
+    'W', 'P', WALLPAPER_VERSION, fileFormat,
+    (uint8_t)(width >> 8), (uint8_t)width,
+    (uint8_t)(height >> 8), (uint8_t)height
+  };
+  bool ok = f.write(header, sizeof(header)) == sizeof(header) &&
+            f.write(payload->data(), payloadSize) == payloadSize;
+  f.close();
+
+  epd_invalidateWallpaper();
+  return ok;
+}
+
 void epd_clear() {
-  epd_job_t *job = new epd_job_t();
-  job->type = JOB_CLEAR;
+  epd_job_t *job = _newJob(JOB_CLEAR);
+  if (!job) return;
   _queueJob(job);
 }
 
 void epd_forceClear() {
-  epd_job_t *job = new epd_job_t();
-  job->type = JOB_FORCE_CLEAR;
+  epd_job_t *job = _newJob(JOB_FORCE_CLEAR);
+  if (!job) return;
   _queueJob(job);
 }
 
 bool epd_forceClear_async() {
-  return _queueJob(new epd_job_t{JOB_FORCE_CLEAR});
+  return _queueJob(_newJob(JOB_FORCE_CLEAR));
 }
 
 bool epd_drawImageFromBitplanes(int width, int height, const std::vector<uint8_t> &data, const char *format, const char *color, bool forceFull) {
-  epd_job_t *job = new epd_job_t();
-  job->type = JOB_IMAGE;
+  bool gray = _isGrayFormat(format);
+  if (gray ? !_isValidGray(width, height, data, format) : !_isValidImage(width, height, data, format)) return false;
+
+  epd_job_t *job = _newJob(gray ? JOB_GRAY : JOB_IMAGE);
+  if (!job) return false;
   job->width = width;
   job->height = height;
-  job->data = data; // copies vector
-  job->format = String(format);
-  job->imageColor = String(color);
+  _setPayload(job, data);
+  job->format = format;
+  job->imageColor = color;
   job->forceFull = forceFull;
-  
+
   return _queueJob(job);
 }
 
-void epd_displayPage(const EpdPage& page) {
-    epd_job_t *job = new epd_job_t();
-    job->type = JOB_PAGE;
+void epd_displayPage(const EpdPage& page, bool forceFull) {
+    epd_job_t *job = _newJob(JOB_PAGE);
+    if (!job) return;
     job->page = page;
+    job->forceFull = forceFull;
     _queueJob(job);
 }
 
+bool epd_prepareStandby(const EpdPage& page) {
+  if (!s_standbyEnabled) return false;
+  epd_job_t *job = _newJob(JOB_STANDBY);
+  if (!job) return false;
+  job->page = page;
+  return _queueJob(job);
+}
+
+void epd_hibernate(void) {
+  epd_job_t *job = _newJob(JOB_HIBERNATE);
+  if (!job) return;
+  _queueJob(job);
+}
+
+bool epd_setFramebufferRows(uint16_t rows) {
+  epd_job_t *job = _newJob(JOB_BUFFER);
+  if (!job) return false;
+  job->width = rows;
+  if (!_queueJob(job)) return false;
+  s_bufferRequests++;
+  return true;
+}
+
+EpdBufferResult epd_getFramebufferResult(uint32_t timeoutMs) {
+  uint32_t start = millis();
+  while (s_bufferApplied != s_bufferRequests) {
+    if (millis() - start >= timeoutMs) return EPD_BUFFER_PENDING;
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+  return s_bufferResult;
+}
+
+void epd_getMemoryInfo(EpdMemoryInfo &info) {
+  info.rows = s_fbRows;
+  info.paged = s_fbRows < epd2.HEIGHT;
+  info.framebuffer = s_fbBytes;
+  info.atlas = epd_atlas_bytes();
+  info.bands = sizeof(s_band);
+  info.jobs = sizeof(s_jobSlots) + sizeof(s_arena);
+  info.heapPayloads = s_heapPayloads;
+}
+
+uint16_t epd_snapshotHeight(bool withOled) {
+  return epd2.HEIGHT + (withOled ? OLED_HEIGHT : 0);
+}
+
+EpdSnapshotResult epd_snapshot(epd_snapshot_row_cb cb, void *ctx, bool withOled, uint32_t timeoutMs) {
+  if (s_stateMutex == NULL || xSemaphoreTake(s_stateMutex, pdMS_TO_TICKS(timeoutMs)) != pdTRUE) {
+    return EPD_SNAPSHOT_BUSY;
+  }
+  if (epd_fb_isPaged()) {
+    xSemaphoreGive(s_stateMutex);
+    return EPD_SNAPSHOT_PAGED;
+  }
+
+  // Composited one row at a time: no frame-sized copy
+  const int16_t stride = (epd2.WIDTH + 7) / 8;
+  uint8_t row[(GxEPD2_290_T94_V2_G4::WIDTH + 7) / 8];
+  for (int16_t y = 0; y < (int16_t)epd2.HEIGHT; ++y) {
+    epd_fb_compose(y, 1, 0, stride, row, false);
+    cb(row, y, ctx);
+  }
+
+  if (withOled) {
+    uint8_t lit[OLED_WIDTH / 8];
+    for (int16_t y = 0; y < OLED_HEIGHT; ++y) {
+      oled_readRow(y, lit);
+      memset(row, 0xFF, stride);
+      for (int16_t i = 0; i < stride && i < (int16_t)sizeof(lit); ++i) row[i] = ~lit[i];
+      cb(row, epd2.HEIGHT + y, ctx);
+    }
+  }
+
+  xSemaphoreGive(s_stateMutex);
+  return EPD_SNAPSHOT_OK;
+}
+
 bool epd_isBusy() {
   if (s_jobQueue == NULL) return false;
   return s_isBlockedByTask || (uxQueueMessagesWaiting(s_jobQueue) > 0);
@@ -314,61 +722,229 @@ void epd_runBackgroundJobs() {
 
 // Internal State Access (Thread-safe-ish since we read from main which usually is the one setting it via queue)
 String epd_getCurrentText() { return g_currentText; }
-uint16_t epd_width() { return display.width(); }
-uint16_t epd_height() { return display.height(); }
-bool epd_hasPartialUpdate() { return display.epd2.hasPartialUpdate; }
+uint16_t epd_width() { return epd2.WIDTH; }
+uint16_t epd_height() { return epd2.HEIGHT; }
+bool epd_hasPartialUpdate() { return epd2.hasPartialUpdate; }
 void epd_setPartialEnabled(bool enabled) { g_partialEnabled = enabled; }
+void epd_setSourceTag(const char *tag) {
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  if (s_tagMutex) xSemaphoreTake(s_tagMutex, portMAX_DELAY);
+  EpdSourceTag *slot = NULL;
+  for (int i = 0; i < EPD_SOURCE_TASKS && !slot; ++i) {
+    // A slot is free until it has a tag (the sim's main thread has no handle)
+    if (s_sourceTags[i].task == self || s_sourceTags[i].tag == NULL) slot = &s_sourceTags[i];
+  }
+  if (slot) *slot = {self, tag ? tag : ""};
+  if (s_tagMutex) xSemaphoreGive(s_tagMutex);
+  if (!slot) Serial.println("EPD: no source tag slot left");
+}
+
+const char *epd_getSourceTag() {
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  const char *tag = "ui";
+  if (s_tagMutex) xSemaphoreTake(s_tagMutex, portMAX_DELAY);
+  for (int i = 0; i < EPD_SOURCE_TASKS; ++i) {
+    if (s_sourceTags[i].tag && s_sourceTags[i].task == self) tag = s_sourceTags[i].tag;
+  }
+  if (s_tagMutex) xSemaphoreGive(s_tagMutex);
+  return tag;
+}
 bool epd_getPartialEnabled() { return g_partialEnabled; }
 
+// --- Panel output (runs in task) ---
+
+// Composite the layers inside (x, y, w, h) and write them to the controller RAM.
+// In paged mode the window is walked page by page, repainting each page first.
+// - again: write to both controller buffers (keeps the next differential update clean)
+// Returns the time spent repainting pages (us).
+static uint32_t _writeWindow(int16_t x, int16_t y, int16_t w, int16_t h, bool again) {
+  const int16_t wBytes = w / 8;
+  const bool paged = epd_fb_isPaged();
+  const int16_t pageRows = paged ? epd_fb_rows() : h;
+  uint32_t paintUs = 0;
+
+  for (int16_t py = y; py < y + h; py += pageRows) {
+    int16_t pageEnd = std::min<int16_t>(y + h, py + pageRows);
+    if (paged) {
+      uint32_t t0 = micros();
+      epd_fb_setWindow(py);
+      if (s_paintPage) s_paintPage();
+      paintUs += micros() - t0;
+    }
+
+    for (int16_t yy = py; yy < pageEnd; yy += EPD_BAND_ROWS) {
+      int16_t rows = std::min<int16_t>(EPD_BAND_ROWS, pageEnd - yy);
+      epd_fb_compose(yy, rows, x / 8, wBytes, s_band, true);
+      if (again) epd2.writeImageAgain(s_band, x, yy, w, rows);
+      else epd2.writeImage(s_band, x, yy, w, rows);
+    }
+  }
+  return paintUs;
+}
+
+// Push a window of the composited layers to the panel and refresh it.
+// Falls back to a full refresh when the panel has no partial update.
+static void _present(int16_t x, int16_t y, int16_t w, int16_t h, bool partial) {
+  const int16_t W = epd2.WIDTH;
+  const int16_t H = epd2.HEIGHT;
+
+  if (!partial || !epd2.hasPartialUpdate) {
+    x = 0; y = 0; w = W; h = H;
+    partial = false;
+  }
+
+  // Controller RAM windows are byte aligned horizontally
+  int16_t x0 = std::max<int16_t>(0, x) & ~7;
+  int16_t x1 = std::min<int16_t>(W, (x + w + 7) & ~7);
+  int16_t y0 = std::max<int16_t>(0, y);
+  int16_t y1 = std::min<int16_t>(H, y + h);
+  if (x0 >= x1 || y0 >= y1) return;
+
+  // Repainting pages is raster work, not transfer
+  uint32_t t0 = micros();
+  uint32_t paintUs = _writeWindow(x0, y0, x1 - x0, y1 - y0, false);
+  uint32_t t1 = micros();
+  _bookCpu();
+  if (partial) epd2.refresh(x0, y0, x1 - x0, y1 - y0);
+  else epd2.refresh(false);
+  _resumeCpu();
+  uint32_t t2 = micros();
+  paintUs += _writeWindow(x0, y0, x1 - x0, y1 - y0, true);
+
+  s_jobStats.us[EPD_PHASE_TRANSFER] += (t1 - t0) + (micros() - t2) - paintUs;
+  s_jobStats.us[EPD_PHASE_BUSY] += t2 - t1;
+  s_jobStats.partial |= partial;
+}
+
+static void _presentFull(void) {
+  _present(0, 0, epd2.WIDTH, epd2.HEIGHT, false);
+}
+
+// Prepare CONTENT for a new job.
+// - keepScreen: draw on top of what is on the panel (partial jobs);
+//               otherwise start from a blank page. Paged layers do not keep
+//               the screen, so there partial jobs start blank too.
+static EpdCanvas &_beginContent(bool keepScreen) {
+  if (keepScreen && !epd_fb_isPaged()) {
+    epd_fb_flatten();
+  } else {
+    epd_fb_clear(EPD_LAYER_CONTENT);
+    epd_fb_setVisible(EPD_LAYER_BACKGROUND, false);
+    epd_fb_setVisible(EPD_LAYER_CONTENT, true);
+    epd_fb_setVisible(EPD_LAYER_OVERLAY, false);
+  }
+  s_wallpaperShown = false;
+  return epd_fb_layer(EPD_LAYER_CONTENT);
+}
+
+// Draw a job into CONTENT with `draw` and show the window (x, y, w, h).
+// Full frame: draws once. Paged: draws once per page while the window is written.
+static void _render(bool keepScreen, int16_t x, int16_t y, int16_t w, int16_t h, bool partial,
+                    const std::function<void(EpdCanvas &)> &draw) {
+  EpdCanvas &c = _beginContent(keepScreen);
+  if (!epd_fb_isPaged()) {
+    draw(c);
+    _present(x, y, w, h, partial);
+    return;
+  }
+
+  s_paintPage = [&]() {
+    epd_fb_clear(EPD_LAYER_CONTENT);
+    draw(c);
+  };
+  _present(x, y, w, h, partial);
+  s_paintPage = nullptr;
+}
+
+// Full refresh of a blank page filled with `color`
+static void _presentFilled(uint16_t color) {
+  _render(false, 0, 0, epd2.WIDTH, epd2.HEIGHT, false, [color](EpdCanvas &c) { c.fillScreen(color); });
+}
+
+// 4x4 Bayer thresholds for ordered dithering of "g8" sources
+static const uint8_t BAYER4[4][4] = {
+  { 0,  8,  2, 10},
+  {12,  4, 14,  6},
+  { 3, 11,  1,  9},
+  {15,  7, 13,  5},
+};
+
+// Gray levels (0 = white .. 3 = black) of panel row `py`, one byte per column.
+static void _grayRow(const epd_job_t &job, bool g8, int rx, int ry, int py, uint8_t *levels) {
+  const int W = epd2.WIDTH;
+  memset(levels, 0, W);
+
+  int y = py - ry;
+  if (y < 0 || y >= job.height) return;
+
+  int x0 = std::max(0, rx);
+  int x1 = std::min(W, rx + job.width);
+  if (g8) {
+    const uint8_t *src = &job.data[(size_t)y * job.width];
+    for (int px = x0; px < x1; ++px) {
+      int dark = 255 - src[px - rx];
+      int level = (dark * 3 + BAYER4[py & 3][px & 3] * 16 + 8) >> 8;
+      levels[px] = level > 3 ? 3 : level;
+    }
+  } else {
+    const uint8_t *src = &job.data[(size_t)y * ((job.width + 3) / 4)];
+    for (int px = x0; px < x1; ++px) {
+      int x = px - rx;
+      levels[px] = (src[x >> 2] >> (6 - 2 * (x & 3))) & 3;
+    }
+  }
+}
+
+// Destination for streamed image rows
+struct RowSink {
+  EpdCanvas *canvas;
+  int16_t x, y, w;
+};
+
+static void _sinkRow(const uint8_t *row, int y, void *ctx) {
+  RowSink *sink = (RowSink *)ctx;
+  sink->canvas->blit(row, (sink->w + 7) / 8, sink->x, sink->y + y, sink->w, 1);
+}
+
 // --- Implementation of rendering (runs in task) ---
 
 static void _exec_displayText(const epd_job_t &job) {
   g_currentText = job.text;
   if (oled_isAvailable()) oled_showStatus("Rendering...");
 
-  s_u8g2_epd.setFont(u8g2_font_profont29_tr);
-  s_u8g2_epd.setBackgroundColor(GxEPD_WHITE);
-  s_u8g2_epd.setForegroundColor(job.color);
+  bool usedPartial = g_partialEnabled && epd2.hasPartialUpdate && !job.forceFull;
+  const int16_t W = epd2.WIDTH;
+  const int16_t H = epd2.HEIGHT;
 
-  int16_t bw = s_u8g2_epd.getUTF8Width(job.text.c_str());
-  int16_t bh = s_u8g2_epd.getFontAscent() - s_u8g2_epd.getFontDescent();
+  EpdFont font = EPD_FONT_PROFONT29;
+  int16_t bw = epd_atlas_textWidth(font, job.text.c_str());
+  int16_t bh = epd_atlas_ascent(font) - epd_atlas_descent(font);
 
-  if ((int)bw > (int)(display.width() - 8)) {
-    s_u8g2_epd.setFont(u8g2_font_profont17_tr);
-    bw = s_u8g2_epd.getUTF8Width(job.text.c_str());
-    bh = s_u8g2_epd.getFontAscent() - s_u8g2_epd.getFontDescent();
+  if ((int)bw > (int)(W - 8)) {
+    font = EPD_FONT_PROFONT17;
+    bw = epd_atlas_textWidth(font, job.text.c_str());
+    bh = epd_atlas_ascent(font) - epd_atlas_descent(font);
   }
 
-  int16_t cx = (display.width() - bw) / 2;
-  int16_t cy = (display.height() / 2) + (s_u8g2_epd.getFontAscent() / 2);
+  int16_t cx = (W - bw) / 2;
+  int16_t cy = (H / 2) + (epd_atlas_ascent(font) / 2);
 
   const int pad = 4;
-  int16_t rx = ((display.width() - bw) / 2) - pad;
-  int16_t ry = ((display.height() - bh) / 2) - pad;
+  int16_t rx = ((W - bw) / 2) - pad;
+  int16_t ry = ((H - bh) / 2) - pad;
   uint16_t rw = bw + pad * 2;
   uint16_t rh = bh + pad * 2;
 
   // Clamp
   rx = std::max((int16_t)0, rx);
   ry = std::max((int16_t)0, ry);
-  rw = std::min((uint16_t)(display.width() - rx), rw);
-  rh = std::min((uint16_t)(display.height() - ry), rh);
-
-  bool usedPartial = false;
-  if (g_partialEnabled && display.epd2.hasPartialUpdate && !job.forceFull) {
-    usedPartial = true;
-    display.setPartialWindow(rx, ry, rw, rh);
-  } else {
-    display.setFullWindow();
-  }
+  rw = std::min((uint16_t)(W - rx), rw);
+  rh = std::min((uint16_t)(H - ry), rh);
 
-  display.firstPage();
-  do {
-    if (usedPartial) display.fillRect(rx, ry, rw, rh, GxEPD_WHITE);
-    else display.fillScreen(GxEPD_WHITE);
-    s_u8g2_epd.setCursor(cx, cy);
-    s_u8g2_epd.print(job.text);
-  } while (display.nextPage());
+  _render(usedPartial, rx, ry, rw, rh, usedPartial, [&](EpdCanvas &c) {
+    if (usedPartial) c.fillRect(rx, ry, rw, rh, GxEPD_WHITE);
+    epd_atlas_drawText(c, font, cx, cy, job.text.c_str(), job.color);
+  });
 
   if (oled_isAvailable()) oled_showStatus("Done");
 }
@@ -376,224 +952,421 @@ static void _exec_displayText(const epd_job_t &job) {
 static void _exec_displayHeader(const epd_job_t &job) {
   if (oled_isAvailable()) oled_showStatus("EPD Header...");
 
-  s_u8g2_epd.setFont(u8g2_font_profont17_tr);
-  s_u8g2_epd.setBackgroundColor(GxEPD_WHITE);
-  s_u8g2_epd.setForegroundColor(GxEPD_BLACK);
-
-  int16_t bh = s_u8g2_epd.getFontAscent() - s_u8g2_epd.getFontDescent();
-  uint16_t rw = display.width();
+  int16_t bh = epd_atlas_ascent(EPD_FONT_PROFONT17) - epd_atlas_descent(EPD_FONT_PROFONT17);
+  uint16_t rw = epd2.WIDTH;
   uint16_t rh = bh + 8;
 
-  display.setPartialWindow(0, 0, rw, rh);
-  display.firstPage();
-  do {
-    display.fillRect(0, 0, rw, rh, GxEPD_BLACK);
-    s_u8g2_epd.setForegroundColor(GxEPD_WHITE);
-    s_u8g2_epd.setCursor(8, s_u8g2_epd.getFontAscent() + 4);
-    s_u8g2_epd.print(job.text);
-  } while (display.nextPage());
+  _render(true, 0, 0, rw, rh, true, [&](EpdCanvas &c) {
+    c.fillRect(0, 0, rw, rh, GxEPD_BLACK);
+    epd_atlas_drawText(c, EPD_FONT_PROFONT17, 8, epd_atlas_ascent(EPD_FONT_PROFONT17) + 4, job.text.c_str(), GxEPD_WHITE);
+  });
 
   if (oled_isAvailable()) oled_showStatus("Done");
 }
 
-static void _exec_image_bw(int width, int height, const std::vector<uint8_t> &img, int rx, int ry, const char *color) {
-  int bytesPerRow = (width + 7) / 8;
-  uint16_t drawColor = GxEPD_BLACK;
+// 3c image handling removed as we are now BW only
+
+static void _exec_drawImage(const epd_job_t &job) {
+  if (oled_isAvailable()) oled_showStatus("Loading...");
 
-  for (int y = 0; y < height; ++y) {
-    int row = y * bytesPerRow;
-    for (int x = 0; x < width; ++x) {
-      int byteIndex = row + (x >> 3);
-      uint8_t b = img[byteIndex];
-      bool pixelOn = ((b >> (7 - (x & 7))) & 1);
-      if (pixelOn) display.drawPixel(rx + x, ry + y, drawColor);
+  const int bytesPerRow = (job.width + 7) / 8;
+  int rx = ((int)epd2.WIDTH - job.width) / 2;
+  int ry = ((int)epd2.HEIGHT - job.height) / 2;
+
+  bool usedPartial = g_partialEnabled && epd2.hasPartialUpdate && !job.forceFull;
+
+  _render(usedPartial, rx, ry, job.width, job.height, usedPartial, [&](EpdCanvas &c) {
+    // BW only: "3c" data is drawn from its first (black) plane
+    if (usedPartial) c.fillRect(rx, ry, job.width, job.height, GxEPD_WHITE);
+    if (job.format == "rle") {
+      // Decode straight into the canvas rows (rows outside a page are clipped)
+      static std::vector<uint8_t> row; // task only, keeps its capacity
+      row.assign(bytesPerRow, 0);
+      RowSink sink = {&c, (int16_t)rx, (int16_t)ry, (int16_t)job.width};
+      rle_stream_t rs;
+      rle_stream_begin(&rs, row.data(), bytesPerRow, job.height, _sinkRow, &sink);
+      rle_stream_feed(&rs, job.data, job.dataLen);
+    } else {
+      c.blit(job.data, bytesPerRow, rx, ry, job.width, job.height);
     }
+  });
+
+  if (oled_isAvailable()) oled_showStatus("Done");
+}
+
+// JOB_GRAY: full-screen 4-level refresh. With a full-frame buffer CONTENT keeps
+// the high bit (dark levels as ink) so later 1-bpp jobs compose on a close
+// approximation.
+static void _exec_drawGray(const epd_job_t &job) {
+  if (oled_isAvailable()) oled_showStatus("Gray...");
+
+  static uint8_t levels[GxEPD2_290_T94_V2_G4::WIDTH];
+  uint8_t bits[GxEPD2_290_T94_V2_G4::WIDTH / 8];
+
+  const bool g8 = (job.format == "g8");
+  const int W = epd2.WIDTH;
+  const int H = epd2.HEIGHT;
+  int rx = (W - job.width) / 2;
+  int ry = (H - job.height) / 2;
+
+  EpdCanvas &c = _beginContent(false);
+  const bool paged = epd_fb_isPaged();
+
+  uint32_t t0 = micros();
+  epd2.gray4Begin();
+  for (int plane = 0; plane < 2; ++plane) {
+    epd2.gray4StartPlane(plane == 1);
+    for (int py = 0; py < H; ++py) {
+      _grayRow(job, g8, rx, ry, py, levels);
+      memset(bits, 0, sizeof(bits));
+      for (int px = 0; px < W; ++px) {
+        if ((levels[px] >> plane) & 1) bits[px >> 3] |= 0x80 >> (px & 7);
+      }
+      if (plane == 1 && !paged) memcpy(&c.buffer()[py * c.stride()], bits, c.stride());
+      epd2.gray4WritePlane(bits, sizeof(bits));
+    }
+    epd2.gray4EndPlane();
   }
+  uint32_t t1 = micros();
+  _bookCpu();
+  epd2.gray4Refresh();
+  _resumeCpu();
+
+  // Level conversion is interleaved with the plane writes and counted as transfer
+  s_jobStats.us[EPD_PHASE_TRANSFER] += t1 - t0;
+  s_jobStats.us[EPD_PHASE_BUSY] += micros() - t1;
+
+  if (oled_isAvailable()) oled_showStatus("Done");
 }
 
-// 3c image handling removed as we are now BW only
+// Fill the background layer from /wallpaper.bin, or the default noise pattern.
+// Paged: fills the current window only (the file is read again per page).
+static void _loadWallpaper(void) {
+  EpdCanvas &bg = epd_fb_layer(EPD_LAYER_BACKGROUND);
+  bg.fillScreen(GxEPD_WHITE);
+  bool loaded = false;
+
+  if (LittleFS.exists(WALLPAPER_PATH)) {
+    File f = LittleFS.open(WALLPAPER_PATH, "r");
+    uint8_t header[8];
+    int width = 0;
+    int height = 0;
+    uint8_t format = WALLPAPER_RAW;
+
+    if (f && f.read(header, 4) == 4) {
+      if (header[0] == 'W' && header[1] == 'P') {
+        format = header[3];
+        if (header[2] == WALLPAPER_VERSION && f.read(header + 4, 4) == 4) {
+          width = (header[4] << 8) | header[5];
+          height = (header[6] << 8) | header[7];
+        }
+      } else {
+        // Legacy headerless file: raw rows after [w][h]
+        width = (header[0] << 8) | header[1];
+        height = (header[2] << 8) | header[3];
+      }
+    }
 
+    // Stream straight into the layer (no full-size temporary)
+    int bytesPerRow = (width + 7) / 8;
+    if (width > 0 && height > 0 && bytesPerRow <= WALLPAPER_MAX_ROW) {
+      uint8_t row[WALLPAPER_MAX_ROW];
+      RowSink sink = {&bg, (int16_t)((bg.width() - width) / 2), (int16_t)((bg.height() - height) / 2), (int16_t)width};
+
+      if (format == WALLPAPER_RLE) {
+        uint8_t chunk[256];
+        rle_stream_t rs;
+        rle_stream_begin(&rs, row, bytesPerRow, height, _sinkRow, &sink);
+        bool ok = true;
+        size_t n;
+        while (ok && (n = f.read(chunk, sizeof(chunk))) > 0) {
+          ok = rle_stream_feed(&rs, chunk, n);
+        }
+        loaded = ok && rle_stream_done(&rs);
+      } else if (format == WALLPAPER_RAW) {
+        int y = 0;
+        for (; y < height; ++y) {
+          if (f.read(row, bytesPerRow) != (size_t)bytesPerRow) break;
+          _sinkRow(row, y, &sink);
+        }
+        loaded = (y == height);
+      }
+    }
+    if (f) f.close();
+    if (!loaded) Serial.println("EPD: invalid wallpaper file, using default");
+  }
 
-static void _exec_drawImage(const epd_job_t &job) {
-  if (oled_isAvailable()) oled_showStatus("Loading...");
+  if (!loaded) {
+    // Default noisy wallpaper with fixed seed for consistency. A paged window
+    // skips the values of the rows above it, so every page matches.
+    uint8_t *buf = bg.buffer();
+    randomSeed(42);
+    for (size_t i = 0; i < (size_t)bg.windowY() * bg.stride(); i++) {
+      random(256);
+    }
+    for (size_t i = 0; i < bg.bytes(); i++) {
+      buf[i] = random(256);
+    }
+  }
+
+  s_bgValid = true;
+}
+
+// Render the DD.MM date into the overlay (bottom-right, on a white box).
+// Returns the overlay rectangle through x/y/w/h.
+static void _drawDateOverlay(time_t now, int16_t &x, int16_t &y, int16_t &w, int16_t &h) {
+  struct tm tm;
+  localtime_r(&now, &tm);
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%02d.%02d", tm.tm_mday, tm.tm_mon + 1);
+
+  EpdCanvas &ovl = epd_fb_layer(EPD_LAYER_OVERLAY);
+  epd_fb_clear(EPD_LAYER_OVERLAY);
+
+  int16_t tw = epd_atlas_textWidth(EPD_FONT_PROFONT17, buf);
+  int16_t th = epd_atlas_ascent(EPD_FONT_PROFONT17) - epd_atlas_descent(EPD_FONT_PROFONT17);
 
-  int rx = ((int)display.width() - job.width) / 2;
-  int ry = ((int)display.height() - job.height) / 2;
+  // Bottom-right position with small margin
+  int16_t text_x = ovl.width() - tw - 4;
+  int16_t text_y = ovl.height() - 4;
 
-  bool usedPartial = false;
-  if (g_partialEnabled && display.epd2.hasPartialUpdate && !job.forceFull) {
-    usedPartial = true;
-    display.setPartialWindow(rx, ry, job.width, job.height);
+  x = text_x - 2;
+  y = text_y - th - 2;
+  w = tw + 4;
+  h = th + 4;
+
+  // The mask makes the whole box opaque (white background behind the text)
+  epd_fb_overlayMask().fillRect(x, y, w, h, GxEPD_BLACK);
+  epd_atlas_drawText(ovl, EPD_FONT_PROFONT17, text_x, text_y, buf);
+}
+
+// JOB_WALLPAPER: show background + date overlay.
+// JOB_DATE (dateOnly): refresh just the overlay window when the wallpaper is on screen.
+static void _exec_wallpaper(const epd_job_t &job, bool dateOnly) {
+  const bool paged = epd_fb_isPaged();
+  bool reload = !s_bgValid || s_bgDirty;
+  if (!dateOnly && reload) {
+    if (oled_isAvailable()) oled_showStatus("Loading...");
+    s_bgDirty = false;
+    if (paged) s_bgValid = true; // streamed per page below
+    else _loadWallpaper();
+  }
+
+  int16_t x, y, w, h;
+  _drawDateOverlay(job.time, x, y, w, h);
+
+  if (paged) {
+    s_paintPage = [&]() {
+      int16_t ox, oy, ow, oh;
+      _loadWallpaper();
+      _drawDateOverlay(job.time, ox, oy, ow, oh);
+    };
+  }
+
+  if (dateOnly) {
+    // Nothing to refresh: the overlay is picked up next time the wallpaper is shown
+    if (s_wallpaperShown) _present(x, y, w, h, true);
+  } else if (s_wallpaperShown && !reload) {
+    _present(x, y, w, h, true);
   } else {
-    display.setFullWindow();
+    epd_fb_setVisible(EPD_LAYER_BACKGROUND, true);
+    epd_fb_setVisible(EPD_LAYER_CONTENT, false);
+    epd_fb_setVisible(EPD_LAYER_OVERLAY, true);
+    _presentFull();
+    s_wallpaperShown = true;
   }
+  s_paintPage = nullptr;
 
-  display.firstPage();
-  do {
-    if (usedPartial) display.fillRect(rx, ry, job.width, job.height, GxEPD_WHITE);
-    else display.fillScreen(GxEPD_WHITE);
+  if (!dateOnly && oled_isAvailable()) oled_showStatus("Done");
+}
 
-    // Only draw image if there's actual image data
-    if (job.format != "empty") {
-       // Always use BW handler, ignoring format/color args for now since we are BW only
-       _exec_image_bw(job.width, job.height, job.data, rx, ry, "black");
+// Word-wrap a paragraph component from `y` down, advancing `y`. Returns
+// false when it ran past the bottom of the panel (rest dropped).
+static bool _drawParagraph(EpdCanvas &c, const EpdPage &page, const EpdComponent &comp, int16_t &y) {
+    if (!page.text || comp.offset >= page.text->length()) return true;
+    const char *s = page.text->c_str() + comp.offset;
+    const size_t n = std::min<size_t>(comp.length, page.text->length() - comp.offset);
+    const int16_t width = epd_layout_paragraphWidth();
+    const int16_t pitch = epd_layout_paragraphPitch();
+    const int16_t ascent = epd_atlas_ascent(EPD_FONT_PROFONT12);
+    const uint16_t color = comp.color == 0 ? GxEPD_BLACK : comp.color;
+
+    size_t pos = 0;
+    while (pos < n) {
+        if (y + pitch > c.height()) return false;
+        size_t drawLen;
+        size_t used = epd_layout_nextLine(s + pos, n - pos, width, drawLen);
+        epd_atlas_drawText(c, EPD_FONT_PROFONT12, 2, y + ascent, s + pos, drawLen, color);
+        pos += used;
+        y += pitch;
     }
-    
-    // If text is present (date overlay for wallpaper), draw it at the bottom
-    if (job.text.length() > 0) {
-      s_u8g2_epd.setFont(u8g2_font_profont17_tr);
-      s_u8g2_epd.setForegroundColor(GxEPD_BLACK);
-      s_u8g2_epd.setBackgroundColor(GxEPD_WHITE);
-      
-      int16_t tw = s_u8g2_epd.getUTF8Width(job.text.c_str());
-      int16_t th = s_u8g2_epd.getFontAscent() - s_u8g2_epd.getFontDescent();
-      
-      // Bottom-right position with small margin
-      int16_t text_x = display.width() - tw - 4;
-      int16_t text_y = display.height() - 4;
-      
-      // Draw white background box for date
-      display.fillRect(text_x - 2, text_y - th - 2, tw + 4, th + 4, GxEPD_WHITE);
-      
-      // Draw text
-      s_u8g2_epd.setCursor(text_x, text_y);
-      s_u8g2_epd.print(job.text);
-    }
-  } while (display.nextPage());
-
-  if (oled_isAvailable()) oled_showStatus("Done");
+    if (n > 0) y += epd_layout_paragraphGap();
+    return true;
 }
 
-static void _exec_displayPage(const epd_job_t &job) {
-    if (oled_isAvailable()) oled_showStatus("EPD Layout...");
+// Lay out a page (title + components, top to bottom) on `c`
+// Vertical positions come from the layout pass (layout.cpp), so a screen
+// from epd_layout_paginate() always fits.
+static void _drawPage(EpdCanvas &c, const EpdPage &page) {
+    // 1. Draw Header
+    if (page.title.length() > 0) {
+        epd_atlas_drawText(c, EPD_FONT_PROFONT15_BOLD, 2, epd_atlas_ascent(EPD_FONT_PROFONT15_BOLD) + 4, page.title.c_str()); // X=2 aligned
+
+        int16_t ruleY = epd_atlas_ascent(EPD_FONT_PROFONT15_BOLD) + 8;
+        c.drawFastHLine(0, ruleY, c.width(), GxEPD_BLACK);
+        c.drawFastHLine(0, ruleY + 1, c.width(), GxEPD_BLACK); // Double line
+    }
+    int16_t currY = epd_layout_top(page);
 
-    display.setFullWindow();
-    display.firstPage();
-    do {
-        display.fillScreen(GxEPD_WHITE);
-        
-        int16_t currY = 0;
-        
-        // 1. Draw Header
-        if (job.page.title.length() > 0) {
-            s_u8g2_epd.setFont(u8g2_font_profont15_tr);
-            s_u8g2_epd.setFontMode(1); // Transparent mode
-            s_u8g2_epd.setForegroundColor(GxEPD_BLACK);
-            
-            // Normal
-            s_u8g2_epd.setCursor(2, s_u8g2_epd.getFontAscent() + 4); // X=2 aligned
-            s_u8g2_epd.print(job.page.title);
-            
-            // Bold (Offset +1)
-            s_u8g2_epd.setCursor(3, s_u8g2_epd.getFontAscent() + 4);
-            s_u8g2_epd.print(job.page.title);
-            
-            currY = s_u8g2_epd.getFontAscent() + 8;
-            display.drawFastHLine(0, currY, display.width(), GxEPD_BLACK);
-            display.drawFastHLine(0, currY + 1, display.width(), GxEPD_BLACK); // Double line
-            currY += 10; // Slightly reduced margin from 12->10
-        } else {
-            currY = 2; // Minimal top margin if no title
+    // 2. Draw Components
+    for (const auto& comp : page.components) {
+        if (comp.type == EPD_COMP_PARAGRAPH) {
+            if (!_drawParagraph(c, page, comp, currY)) break;
+            continue;
         }
 
-        // 2. Draw Components
-        for (const auto& comp : job.page.components) {
-            if (currY > display.height() - 12) break;
-
-            s_u8g2_epd.setFontMode(1);
-            
-            switch (comp.type) {
-                case EPD_COMP_HEADER:
-                    s_u8g2_epd.setFont(u8g2_font_profont15_tr);
-                    s_u8g2_epd.setForegroundColor(GxEPD_BLACK);
-                    
-                    // Draw Normal
-                    s_u8g2_epd.setCursor(2, currY + s_u8g2_epd.getFontAscent()); 
-                    s_u8g2_epd.print(comp.text1);
-                    
-                    // Draw Bold (Offset +1)
-                    s_u8g2_epd.setCursor(3, currY + s_u8g2_epd.getFontAscent()); 
-                    s_u8g2_epd.print(comp.text1);
-                    
-                    currY += (s_u8g2_epd.getFontAscent() - s_u8g2_epd.getFontDescent()) + 1;
-                    break;
-
-                case EPD_COMP_ROW:
-                    s_u8g2_epd.setFont(u8g2_font_profont15_tr);
-                    s_u8g2_epd.setForegroundColor(GxEPD_BLACK);
-                    
-                    // Label (Left)
-                    s_u8g2_epd.setCursor(2, currY + s_u8g2_epd.getFontAscent()); // X changed from 8 to 2
-                    s_u8g2_epd.print(comp.text1);
-                    
-                    // Value (Right)
-                    if (comp.text2.length() > 0) {
-                        s_u8g2_epd.setForegroundColor(comp.color == 0 ? GxEPD_BLACK : comp.color);
-                        int16_t valW = s_u8g2_epd.getUTF8Width(comp.text2.c_str());
-                        s_u8g2_epd.setCursor(display.width() - valW - 2, currY + s_u8g2_epd.getFontAscent()); // Right margin 2
-                        s_u8g2_epd.print(comp.text2);
+        EpdLayoutBox box = epd_layout_measure(page, comp);
+        if (currY + box.extent > c.height()) break;
+
+        switch (comp.type) {
+            case EPD_COMP_HEADER:
+                epd_atlas_drawText(c, EPD_FONT_PROFONT15_BOLD, 2, currY + epd_atlas_ascent(EPD_FONT_PROFONT15_BOLD), comp.text1.c_str());
+                break;
+
+            case EPD_COMP_ROW:
+                // Label (Left)
+                epd_atlas_drawText(c, EPD_FONT_PROFONT15, 2, currY + epd_atlas_ascent(EPD_FONT_PROFONT15), comp.text1.c_str()); // X changed from 8 to 2
+
+                // Value (Right)
+                if (comp.text2.length() > 0) {
+                    int16_t valW = epd_atlas_textWidth(EPD_FONT_PROFONT15, comp.text2.c_str());
+                    epd_atlas_drawText(c, EPD_FONT_PROFONT15, c.width() - valW - 2, currY + epd_atlas_ascent(EPD_FONT_PROFONT15), // Right margin 2
+                                       comp.text2.c_str(), comp.color == 0 ? GxEPD_BLACK : comp.color);
+                }
+                break;
+
+            case EPD_COMP_PROGRESS:
+                epd_atlas_drawText(c, EPD_FONT_PROFONT12, 2, currY + epd_atlas_ascent(EPD_FONT_PROFONT12), comp.text1.c_str()); // X changed from 8 to 2
+
+                {
+                    int16_t barW = c.width() - 100;
+                    int16_t barX = c.width() - barW - 30; // Adjusted for new spacing
+                    int16_t barY = currY + 2;
+                    int16_t barH = 8;
+                    c.drawRect(barX, barY, barW, barH, GxEPD_BLACK);
+                    int16_t fillW = (int16_t)((barW - 4) * (comp.value / 100.0f));
+                    if (fillW > 0) {
+                        c.fillRect(barX + 2, barY + 2, fillW, barH - 4, comp.color == 0 ? GxEPD_BLACK : comp.color);
                     }
-                    currY += 12;
-                    break;
-
-                case EPD_COMP_PROGRESS:
-                    s_u8g2_epd.setFont(u8g2_font_profont12_tr);
-                    s_u8g2_epd.setForegroundColor(GxEPD_BLACK);
-                    s_u8g2_epd.setCursor(2, currY + s_u8g2_epd.getFontAscent()); // X changed from 8 to 2
-                    s_u8g2_epd.print(comp.text1);
-                    
-                    {
-                        int16_t barW = display.width() - 100;
-                        int16_t barX = display.width() - barW - 30; // Adjusted for new spacing
-                        int16_t barY = currY + 2;
-                        int16_t barH = 8;
-                        display.drawRect(barX, barY, barW, barH, GxEPD_BLACK);
-                        int16_t fillW = (int16_t)((barW - 4) * (comp.value / 100.0f));
-                        if (fillW > 0) {
-                            display.fillRect(barX + 2, barY + 2, fillW, barH - 4, comp.color == 0 ? GxEPD_BLACK : comp.color);
-                        }
-                        
-                        // Percentage text
-                        s_u8g2_epd.setCursor(display.width() - 25, currY + s_u8g2_epd.getFontAscent()); // Adjusted margin
-                        s_u8g2_epd.print(comp.text2);
-                    }
-                    currY += 14;
-                    break;
-
-                case EPD_COMP_SEPARATOR:
-                    display.drawFastHLine(2, currY + 1, display.width() - 4, GxEPD_BLACK); // X=2, Width-4
-                    currY += 4;
-                    break;
-            }
+
+                    // Percentage text
+                    epd_atlas_drawText(c, EPD_FONT_PROFONT12, c.width() - 25, currY + epd_atlas_ascent(EPD_FONT_PROFONT12), comp.text2.c_str()); // Adjusted margin
+                }
+                break;
+
+            case EPD_COMP_SEPARATOR:
+                c.drawFastHLine(2, currY + 1, c.width() - 4, GxEPD_BLACK); // X=2, Width-4
+                break;
+
+            case EPD_COMP_PARAGRAPH:
+                break;
         }
-    } while (display.nextPage());
+        currY += box.advance;
+    }
+}
+
+// Same content as `b`? Paragraph text is compared by buffer: a buffer held
+// by a job is never modified (see EpdPage::text).
+static bool _samePage(const EpdPage &a, const EpdPage &b) {
+    if (a.title != b.title || a.text != b.text || a.components.size() != b.components.size()) return false;
+    for (size_t i = 0; i < a.components.size(); ++i) {
+        const EpdComponent &x = a.components[i];
+        const EpdComponent &y = b.components[i];
+        if (x.type != y.type || x.text1 != y.text1 || x.text2 != y.text2 || x.value != y.value ||
+            x.color != y.color || x.offset != y.offset || x.length != y.length) return false;
+    }
+    return true;
+}
+
+static void _exec_displayPage(const epd_job_t &job) {
+    if (oled_isAvailable()) oled_showStatus("EPD Layout...");
+
+    bool partial = !job.forceFull && g_partialEnabled;
+    if (s_standbyValid && epd_fb_standby() && !epd_fb_isPaged() && _samePage(s_standbyPage, job.page)) {
+        // Drawn ahead of time: swap it in, only the refresh is left
+        _beginContent(false);
+        epd_fb_swapStandby();
+        s_standbyValid = false;
+        s_standbyPage = EpdPage();
+        s_jobStats.standby = true;
+        _present(0, 0, epd2.WIDTH, epd2.HEIGHT, partial);
+    } else {
+        _render(false, 0, 0, epd2.WIDTH, epd2.HEIGHT, partial, [&](EpdCanvas &c) { _drawPage(c, job.page); });
+    }
 
     if (oled_isAvailable()) oled_showStatus("Done");
 }
 
+// JOB_STANDBY: draw a page into the standby canvas; the panel is not touched
+static void _exec_prepareStandby(const epd_job_t &job) {
+    EpdCanvas *c = epd_fb_standby();
+    if (!c) return;
+    c->fillScreen(GxEPD_WHITE);
+    _drawPage(*c, job.page);
+    s_standbyPage = job.page;
+    s_standbyValid = true;
+}
+
 static void _exec_clear(bool force) {
   if (oled_isAvailable()) oled_showStatus(force ? "Recovery..." : "Clearing...");
-  
+
   if (force) {
     const int cycles = 4;
     for (int i = 0; i < cycles; ++i) {
       if (oled_isAvailable()) oled_showProgress("Clearing", i + 1, cycles);
-      display.setFullWindow(); display.firstPage();
-      do { display.fillScreen(GxEPD_WHITE); } while (display.nextPage());
-      vTaskDelay(pdMS_TO_TICKS(400));
-      display.setFullWindow(); display.firstPage();
-      do { display.fillScreen(GxEPD_BLACK); } while (display.nextPage());
-      vTaskDelay(pdMS_TO_TICKS(400));
+      _presentFilled(GxEPD_WHITE);
+      _idleDelay(400);
+      _presentFilled(GxEPD_BLACK);
+      _idleDelay(400);
     }
-    display.setFullWindow(); display.firstPage();
-    do { display.fillScreen(GxEPD_WHITE); } while (display.nextPage());
-    vTaskDelay(pdMS_TO_TICKS(200));
+    _presentFilled(GxEPD_WHITE);
+    _idleDelay(200);
   } else {
-    display.setFullWindow();
-    display.firstPage();
-    do { display.fillScreen(GxEPD_WHITE); } while (display.nextPage());
+    _presentFilled(GxEPD_WHITE);
   }
-  
+
   if (oled_isAvailable()) oled_showStatus("Cleared");
 }
 
+// JOB_BUFFER: reallocate the layer stack with `job.width` rows per layer.
+// Contents are dropped, so nothing is cached and the next job starts blank.
+static void _exec_setBuffer(const epd_job_t &job) {
+  uint16_t rows = job.width;
+  if (rows != EPD_FB_FULL && rows < EPD_BAND_ROWS) rows = EPD_BAND_ROWS;
+  const uint16_t want = (rows == EPD_FB_FULL || rows > epd2.HEIGHT) ? epd2.HEIGHT : rows;
+  const uint16_t prev = epd_fb_rows();
+
+  // epd_fb_init() itself steps down to smaller pages when even this fails
+  bool ok = epd_fb_init(epd2.WIDTH, epd2.HEIGHT, want);
+  if (ok && epd_fb_rows() != want && prev > epd_fb_rows()) {
+    ok = epd_fb_init(epd2.WIDTH, epd2.HEIGHT, prev);
+  }
+  if (!ok) {
+    Serial.println("EPD: no RAM for any frame buffer, drawing jobs are refused");
+    s_bufferResult = EPD_BUFFER_NO_RAM;
+  } else if (epd_fb_rows() != want) {
+    Serial.printf("EPD: not enough RAM for %u rows, using %u\n", (unsigned)want, (unsigned)epd_fb_rows());
+    s_bufferResult = EPD_BUFFER_FALLBACK;
+  } else {
+    s_bufferResult = EPD_BUFFER_OK;
+  }
+  s_standbyEnabled = EPD_STANDBY_BUFFER && epd_fb_setStandby(true);
+  s_standbyValid = false;
+  s_standbyPage = EpdPage();
+  s_fbRows = epd_fb_rows();
+  s_fbBytes = epd_fb_bytes();
+  s_bgValid = false;
+  s_wallpaperShown = false;
+  Serial.printf("EPD: frame buffer %u rows (%u bytes)\n", (unsigned)s_fbRows, (unsigned)s_fbBytes);
+  s_bufferApplied++;
+}
@@ -13,9 +13,16 @@
  * Notes:
  *  - Image bitplanes are expected in row-major order, MSB-first per byte.
  *  - Supported image formats:
- *      - "bw" : single plane (black/white). bytes = ceil(width*height/8)
- *      - "3c" : DEPRECATED/IGNORED - treated as BW or will fail.
- *               originally: two planes concatenated: [black_plane][red_plane]
+ *      - "bw"  : single plane (black/white). bytes = ceil(width/8) * height
+ *      - "rle" : the "bw" plane compressed with PackBits (see utils/rle.h),
+ *                decoded row by row straight into the frame buffer
+ *      - "g4"  : 4-level grayscale, 2 bpp packed (4 px per byte, MSB first),
+ *                0 = white .. 3 = black. bytes = ceil(width/4) * height
+ *      - "g8"  : 8-bit luminance (0 = black, 255 = white), one byte per pixel;
+ *                ordered-dithered to 4 levels on the device
+ *      - "3c"  : DEPRECATED/IGNORED - treated as BW or will fail.
+ *                originally: two planes concatenated: [black_plane][red_plane]
+ *  - Gray images always use a full refresh with the panel's 4-gray waveform.
  */
 
 #include <Arduino.h>
@@ -44,12 +51,22 @@ void epd_forceClear(void);
 // display is not currently busy. Returns true if the job was scheduled.
 bool epd_forceClear_async(void);
 
-// Helper to display the date on theE-Paper (e.g. at startup)
+// Update the date overlay (DD.MM). Only the overlay window is refreshed, and
+// only while the wallpaper is on screen.
 void epd_displayDate(time_t now);
 
-// Display wallpaper with date overlay at bottom (DD.MM format)
+// Display wallpaper with date overlay at bottom (DD.MM format).
+// The wallpaper is cached in the background layer after the first load.
 void epd_displayWallpaper(time_t now);
 
+// Drop the cached wallpaper (call after /wallpaper.bin changes)
+void epd_invalidateWallpaper(void);
+
+// Store a wallpaper ("bw" or "rle" data) in /wallpaper.bin. Raw data is
+// PackBits-compressed on flash when that is smaller. Invalidates the cache.
+// Returns false on invalid inputs or write errors.
+bool epd_saveWallpaper(int width, int height, const std::vector<uint8_t> &data, const char *format = "bw");
+
 // Simple full white clear without the recovery black/white cycles
 void epd_clear(void);
 
@@ -64,6 +81,63 @@ uint16_t epd_height(void);
 void epd_setPartialEnabled(bool enabled);
 bool epd_getPartialEnabled(void);
 
+// Tag recorded with every job the calling task queues afterwards (e.g. the
+// active app on the UI task, "http" on the loop task), so /api/epd/stats can
+// attribute render times. `tag` must be a static string (literal, app name,
+// view title): jobs keep the pointer. Tasks that never set one queue as "ui".
+void epd_setSourceTag(const char *tag);
+const char *epd_getSourceTag(void);
+
+// Frame buffer footprint (bytes), for /status
+struct EpdMemoryInfo {
+  uint16_t rows;       // rows held per layer (panel height = full frame)
+  bool paged;          // rows < panel height: jobs are drawn page by page
+  size_t framebuffer;  // layer stack (background, content, overlay + mask)
+  size_t atlas;        // pre-rasterized glyphs
+  size_t bands;        // SPI band buffer
+  size_t jobs;         // job slots + image payload arena
+  uint32_t heapPayloads; // image payloads too big for the arena (heap copies)
+};
+void epd_getMemoryInfo(EpdMemoryInfo &info);
+
+// Screenshot of what the panel shows: the layer composite after the last job,
+// handed to `cb` one row at a time (ceil(width / 8) bytes, bit set = ink).
+// With `withOled` the OLED frame buffer follows as epd_snapshotHeight(true) -
+// epd_height() more rows of the same width (lit pixels white). The layers are
+// read in place with the EPD task locked out between jobs, so keep `cb`
+// short. Paged mode keeps no composite between jobs (image payloads are
+// streamed and gone once drawn, so the frame cannot be redrawn either):
+// switch to full frame (epd_setFramebufferRows(0)) and redraw first.
+enum EpdSnapshotResult {
+  EPD_SNAPSHOT_OK,
+  EPD_SNAPSHOT_BUSY,   // a job kept the frame buffer for longer than `timeoutMs`
+  EPD_SNAPSHOT_PAGED   // paged frame buffer: no frame to read
+};
+typedef void (*epd_snapshot_row_cb)(const uint8_t *row, int y, void *ctx);
+EpdSnapshotResult epd_snapshot(epd_snapshot_row_cb cb, void *ctx, bool withOled, uint32_t timeoutMs);
+uint16_t epd_snapshotHeight(bool withOled);
+
+// Switch the layer stack between full frame (rows = EPD_FB_FULL) and paged
+// mode with `rows` rows per page (see config.h). Applied by the EPD task
+// between jobs; the cached wallpaper is dropped. Falls back to the previous
+// size, then to smaller pages, when the RAM is not available. Returns false
+// if the queue is full.
+bool epd_setFramebufferRows(uint16_t rows);
+
+enum EpdBufferResult : uint8_t {
+  EPD_BUFFER_OK,        // the requested size is in use
+  EPD_BUFFER_FALLBACK,  // not enough RAM: a smaller size is in use (epd_getMemoryInfo)
+  EPD_BUFFER_NO_RAM,    // not even the smallest page fits: drawing jobs are refused
+  EPD_BUFFER_PENDING    // not applied within the timeout
+};
+// Outcome of the last epd_setFramebufferRows(), waiting up to `timeoutMs`
+// for the EPD task to apply it.
+EpdBufferResult epd_getFramebufferResult(uint32_t timeoutMs);
+
+// Put the panel controller to sleep (queued behind pending jobs). The image
+// and controller RAM are kept; the next job wakes it up again.
+void epd_hibernate(void);
+
 // Returns true if a long-running EPD job is in progress (force-clear, full update)
 bool epd_isBusy(void);
 
@@ -73,7 +147,7 @@ void epd_runBackgroundJobs(void);
 // Draw an image from packed bitplane data.
 // - `width`, `height` : image dimensions in pixels (must fit within display)
 // - `data` : packed bytes (see comment above for per-format layout)
-// - `format` : "bw" (default "bw")
+// - `format` : "bw", "rle", "g4" or "g8" (default "bw")
 // - `color` : for "bw" format, "black" (default "black")
 // - `forceFull` : force a full update (recommended for artifact-prone panels)
 // Returns true on success, false on invalid inputs (wrong size/format).
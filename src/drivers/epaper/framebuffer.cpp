@@ -0,0 +1,291 @@
+/*
+  framebuffer.cpp
+
+  Packed 1-bpp canvases and the layer stack used by the e-paper task.
+  See framebuffer.h for the pixel convention and compositing rules.
+*/
+
+#include "framebuffer.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <utility>
+
+// --- EpdCanvas ---
+
+// Combine `bits` into `dst` (restricted to `mask`) according to the blit mode
+inline void EpdCanvas::_apply(uint8_t &dst, uint8_t mask, uint8_t bits, BlitMode mode) {
+  switch (mode) {
+    case BLIT_COPY:  dst = (dst & ~mask) | bits; break;
+    case BLIT_SET:   dst |= bits; break;
+    case BLIT_CLEAR: dst &= ~bits; break;
+  }
+}
+
+EpdCanvas::EpdCanvas(uint16_t w, uint16_t h, uint16_t rows)
+  : Adafruit_GFX(w, h), _buffer(nullptr), _stride((w + 7) / 8),
+    _rows((rows == 0 || rows > h) ? h : rows), _y0(0) {}
+
+EpdCanvas::~EpdCanvas() {
+  free(_buffer);
+}
+
+bool EpdCanvas::begin() {
+  if (!_buffer) _buffer = (uint8_t *)calloc(bytes(), 1);
+  return _buffer != nullptr;
+}
+
+void EpdCanvas::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  y -= _y0;
+  if (!_buffer || x < 0 || y < 0 || x >= WIDTH || y >= _rows) return;
+  uint8_t *p = &_buffer[y * _stride + (x >> 3)];
+  uint8_t m = 0x80 >> (x & 7);
+  if (color == GxEPD_WHITE) *p &= ~m;
+  else *p |= m;
+}
+
+void EpdCanvas::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  fillRect(x, y, w, 1, color);
+}
+
+void EpdCanvas::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  fillRect(x, y, 1, h, color);
+}
+
+void EpdCanvas::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (!_buffer) return;
+  if (w < 0) { x += w + 1; w = -w; }
+  if (h < 0) { y += h + 1; h = -h; }
+
+  y -= _y0;
+  int16_t x0 = std::max<int16_t>(x, 0);
+  int16_t y0 = std::max<int16_t>(y, 0);
+  int16_t x1 = std::min<int16_t>(x + w, WIDTH);
+  int16_t y1 = std::min<int16_t>(y + h, _rows);
+  if (x0 >= x1 || y0 >= y1) return;
+
+  const bool ink = (color != GxEPD_WHITE);
+  const int b0 = x0 >> 3;
+  const int b1 = (x1 - 1) >> 3;
+  const uint8_t m0 = 0xFF >> (x0 & 7);
+  const uint8_t m1 = 0xFF << (7 - ((x1 - 1) & 7));
+
+  for (int16_t yy = y0; yy < y1; ++yy) {
+    uint8_t *row = &_buffer[yy * _stride];
+    if (b0 == b1) {
+      uint8_t m = m0 & m1;
+      row[b0] = ink ? (row[b0] | m) : (row[b0] & ~m);
+    } else {
+      row[b0] = ink ? (row[b0] | m0) : (row[b0] & ~m0);
+      if (b1 - b0 > 1) memset(&row[b0 + 1], ink ? 0xFF : 0x00, b1 - b0 - 1);
+      row[b1] = ink ? (row[b1] | m1) : (row[b1] & ~m1);
+    }
+  }
+}
+
+void EpdCanvas::fillScreen(uint16_t color) {
+  if (_buffer) memset(_buffer, color == GxEPD_WHITE ? 0x00 : 0xFF, bytes());
+}
+
+void EpdCanvas::blit(const uint8_t *src, uint16_t srcStride, int16_t x, int16_t y, int16_t w, int16_t h, bool opaque) {
+  _blit(src, srcStride, x, y, w, h, opaque ? BLIT_COPY : BLIT_SET);
+}
+
+void EpdCanvas::drawMask(const uint8_t *src, uint16_t srcStride, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  _blit(src, srcStride, x, y, w, h, color == GxEPD_WHITE ? BLIT_CLEAR : BLIT_SET);
+}
+
+void EpdCanvas::_blit(const uint8_t *src, uint16_t srcStride, int16_t x, int16_t y, int16_t w, int16_t h, BlitMode mode) {
+  if (!_buffer || !src || w <= 0 || h <= 0) return;
+
+  const int srcBytes = (w + 7) / 8;
+  const uint8_t lastMask = (w & 7) ? (uint8_t)(0xFF << (8 - (w & 7))) : 0xFF;
+  const int shift = x & 7;
+  const int baseByte = x >> 3; // arithmetic shift keeps negative x consistent
+
+  for (int16_t sy = 0; sy < h; ++sy) {
+    int16_t dy = y - _y0 + sy;
+    if (dy < 0) continue;
+    if (dy >= _rows) break;
+    uint8_t *row = &_buffer[dy * _stride];
+    const uint8_t *srow = &src[sy * srcStride];
+
+    for (int i = 0; i < srcBytes; ++i) {
+      uint8_t mask = (i == srcBytes - 1) ? lastMask : 0xFF;
+      uint8_t bits = srow[i] & mask;
+      if (!bits && mode != BLIT_COPY) continue;
+      int bx = baseByte + i;
+
+      // High part lands in byte bx, low part spills into bx + 1
+      if (bx >= 0 && bx < _stride) {
+        _apply(row[bx], mask >> shift, bits >> shift, mode);
+      }
+      if (shift && bx + 1 >= 0 && bx + 1 < _stride) {
+        _apply(row[bx + 1], (uint8_t)(mask << (8 - shift)), (uint8_t)(bits << (8 - shift)), mode);
+      }
+    }
+  }
+}
+
+// --- Layer stack ---
+
+static EpdCanvas *s_layers[EPD_LAYER_COUNT] = {nullptr, nullptr, nullptr};
+static EpdCanvas *s_overlayMask = nullptr;
+static EpdCanvas *s_standby = nullptr;
+static bool s_visible[EPD_LAYER_COUNT] = {false, true, false};
+
+static void _freeStack(void) {
+  for (int i = 0; i < EPD_LAYER_COUNT; ++i) {
+    delete s_layers[i];
+    s_layers[i] = nullptr;
+  }
+  delete s_overlayMask;
+  s_overlayMask = nullptr;
+}
+
+// New canvases for every layer; `alloc` also gives them storage
+static bool _newStack(uint16_t width, uint16_t height, uint16_t rows, bool alloc) {
+  bool ok = true;
+  for (int i = 0; i < EPD_LAYER_COUNT; ++i) {
+    s_layers[i] = new EpdCanvas(width, height, rows);
+    if (alloc) ok = s_layers[i]->begin() && ok;
+  }
+  s_overlayMask = new EpdCanvas(width, height, rows);
+  if (alloc) ok = s_overlayMask->begin() && ok;
+  return ok;
+}
+
+bool epd_fb_init(uint16_t width, uint16_t height, uint16_t rows) {
+  // Free the old stack first so switching modes never needs both at once
+  epd_fb_setStandby(false);
+  _freeStack();
+
+  if (rows == 0 || rows > height) rows = height;
+  while (true) {
+    if (_newStack(width, height, rows, true)) return true;
+    _freeStack();
+    if (rows <= EPD_FB_MIN_ROWS) break;
+    rows = std::max<uint16_t>(rows / 2, EPD_FB_MIN_ROWS);
+  }
+
+  // Keep storage-less canvases so layer references stay valid
+  _newStack(width, height, EPD_FB_MIN_ROWS, false);
+  return false;
+}
+
+bool epd_fb_isReady(void) {
+  for (int i = 0; i < EPD_LAYER_COUNT; ++i) {
+    if (!s_layers[i] || !s_layers[i]->buffer()) return false;
+  }
+  return s_overlayMask && s_overlayMask->buffer();
+}
+
+bool epd_fb_setStandby(bool enabled) {
+  if (!enabled || epd_fb_isPaged()) {
+    delete s_standby;
+    s_standby = nullptr;
+    return !enabled;
+  }
+  if (s_standby) return true;
+
+  const EpdCanvas &content = *s_layers[EPD_LAYER_CONTENT];
+  s_standby = new EpdCanvas(content.width(), content.height());
+  if (!s_standby->begin()) {
+    delete s_standby;
+    s_standby = nullptr;
+  }
+  return s_standby != nullptr;
+}
+
+EpdCanvas *epd_fb_standby(void) {
+  return s_standby;
+}
+
+void epd_fb_swapStandby(void) {
+  if (s_standby) std::swap(s_standby, s_layers[EPD_LAYER_CONTENT]);
+}
+
+uint16_t epd_fb_rows(void) {
+  return s_layers[EPD_LAYER_CONTENT] ? s_layers[EPD_LAYER_CONTENT]->rows() : 0;
+}
+
+bool epd_fb_isPaged(void) {
+  const EpdCanvas *c = s_layers[EPD_LAYER_CONTENT];
+  return c && c->rows() < c->height();
+}
+
+void epd_fb_setWindow(int16_t y) {
+  for (int i = 0; i < EPD_LAYER_COUNT; ++i) s_layers[i]->setWindow(y);
+  s_overlayMask->setWindow(y);
+}
+
+EpdCanvas &epd_fb_layer(EpdLayerId id) {
+  return *s_layers[id];
+}
+
+EpdCanvas &epd_fb_overlayMask(void) {
+  return *s_overlayMask;
+}
+
+void epd_fb_setVisible(EpdLayerId id, bool visible) {
+  s_visible[id] = visible;
+}
+
+bool epd_fb_isVisible(EpdLayerId id) {
+  return s_visible[id];
+}
+
+void epd_fb_clear(EpdLayerId id) {
+  s_layers[id]->fillScreen(GxEPD_WHITE);
+  if (id == EPD_LAYER_OVERLAY) s_overlayMask->fillScreen(GxEPD_WHITE);
+}
+
+void epd_fb_flatten(void) {
+  EpdCanvas &content = *s_layers[EPD_LAYER_CONTENT];
+  if (epd_fb_isPaged() || !epd_fb_isReady()) return;
+  if (s_visible[EPD_LAYER_CONTENT] && !s_visible[EPD_LAYER_OVERLAY]) return;
+
+  // Composing row by row in place is safe: each output row only reads the same row.
+  for (int16_t y = 0; y < content.height(); ++y) {
+    epd_fb_compose(y, 1, 0, content.stride(), &content.buffer()[y * content.stride()], false);
+  }
+  s_visible[EPD_LAYER_BACKGROUND] = false;
+  s_visible[EPD_LAYER_CONTENT] = true;
+  s_visible[EPD_LAYER_OVERLAY] = false;
+}
+
+void epd_fb_compose(int16_t y, int16_t rows, int16_t xByte, int16_t wBytes, uint8_t *out, bool controllerPolarity) {
+  if (!epd_fb_isReady()) {
+    memset(out, controllerPolarity ? 0xFF : 0x00, (size_t)rows * wBytes);
+    return;
+  }
+  const uint16_t stride = s_layers[EPD_LAYER_CONTENT]->stride();
+  y -= s_layers[EPD_LAYER_CONTENT]->windowY();
+  const uint8_t *bg = s_layers[EPD_LAYER_BACKGROUND]->buffer();
+  const uint8_t *content = s_layers[EPD_LAYER_CONTENT]->buffer();
+  const uint8_t *ovl = s_layers[EPD_LAYER_OVERLAY]->buffer();
+  const uint8_t *mask = s_overlayMask->buffer();
+
+  for (int16_t r = 0; r < rows; ++r) {
+    size_t base = (size_t)(y + r) * stride + xByte;
+    uint8_t *o = &out[r * wBytes];
+    for (int16_t b = 0; b < wBytes; ++b) {
+      size_t i = base + b;
+      uint8_t v = 0;
+      if (s_visible[EPD_LAYER_BACKGROUND]) v = bg[i];
+      if (s_visible[EPD_LAYER_CONTENT]) v = content[i];
+      if (s_visible[EPD_LAYER_OVERLAY]) v = (v & ~mask[i]) | (ovl[i] & mask[i]);
+      o[b] = controllerPolarity ? (uint8_t)~v : v;
+    }
+  }
+}
+
+size_t epd_fb_bytes(void) {
+  size_t total = 0;
+  for (int i = 0; i < EPD_LAYER_COUNT; ++i) {
+    if (s_layers[i]) total += s_layers[i]->bytes();
+  }
+  if (s_overlayMask) total += s_overlayMask->bytes();
+  if (s_standby) total += s_standby->bytes();
+  return total;
+}
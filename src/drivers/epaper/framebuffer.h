@@ -0,0 +1,139 @@
+#pragma once
+
+/*
+ * drivers/epaper/framebuffer.h
+ *
+ * Packed 1-bpp canvases and the named layer stack owned by the EPD task.
+ *
+ * Pixel convention (same as the "bw" image format):
+ *  - row-major, MSB-first per byte, stride = ceil(width / 8)
+ *  - bit set = ink (black), bit clear = paper (white)
+ *
+ * Layers are composited bottom to top when the panel is refreshed:
+ *  - BACKGROUND : wallpaper (opaque)
+ *  - CONTENT    : text / pages / images drawn by jobs (opaque, hides background)
+ *  - OVERLAY    : small items such as the date; only pixels covered by the
+ *                 overlay mask replace the layers below
+ *
+ * Layers hold either the whole frame or a window of `rows` rows (paged mode,
+ * least RAM). In paged mode the EPD task moves the window down the panel with
+ * epd_fb_setWindow() and redraws each page; drawing outside the window is
+ * clipped, so the same drawing code serves both modes.
+ *
+ * All functions are meant to be called from the EPD task only.
+ */
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <GxEPD2.h>
+#include <stdint.h>
+
+// Adafruit_GFX target backed by a packed 1-bpp buffer.
+// Colors follow GxEPD2: GxEPD_WHITE clears a pixel, any other color sets it.
+// Coordinates are always panel coordinates; the buffer holds rows
+// [windowY(), windowY() + rows()) of a w x h canvas (all of it by default).
+class EpdCanvas : public Adafruit_GFX {
+public:
+  EpdCanvas(uint16_t w, uint16_t h, uint16_t rows = 0);
+  ~EpdCanvas();
+
+  // Allocate (zeroed) pixel storage. Returns false when out of memory.
+  bool begin();
+
+  uint8_t *buffer() { return _buffer; }
+  const uint8_t *buffer() const { return _buffer; }
+  uint16_t stride() const { return _stride; }
+  size_t bytes() const { return (size_t)_stride * _rows; }
+
+  // Buffered rows and the panel row stored first in the buffer.
+  uint16_t rows() const { return _rows; }
+  int16_t windowY() const { return _y0; }
+  void setWindow(int16_t y) { _y0 = y; }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+
+  // Copy a packed bitmap (same convention, `srcStride` bytes per row) to (x, y).
+  // - opaque: source paper pixels clear the destination (otherwise only ink is ORed)
+  void blit(const uint8_t *src, uint16_t srcStride, int16_t x, int16_t y, int16_t w, int16_t h, bool opaque = true);
+
+  // Paint the set bits of a packed mask with `color`; clear bits leave the canvas untouched.
+  void drawMask(const uint8_t *src, uint16_t srcStride, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+private:
+  enum BlitMode { BLIT_COPY, BLIT_SET, BLIT_CLEAR };
+  static void _apply(uint8_t &dst, uint8_t mask, uint8_t bits, BlitMode mode);
+  void _blit(const uint8_t *src, uint16_t srcStride, int16_t x, int16_t y, int16_t w, int16_t h, BlitMode mode);
+
+  uint8_t *_buffer;
+  uint16_t _stride;
+  uint16_t _rows;
+  int16_t _y0;
+};
+
+enum EpdLayerId {
+  EPD_LAYER_BACKGROUND,
+  EPD_LAYER_CONTENT,
+  EPD_LAYER_OVERLAY,
+  EPD_LAYER_COUNT
+};
+
+// Smallest page epd_fb_init() falls back to
+#define EPD_FB_MIN_ROWS 16
+
+// Allocate all layers for a `width` x `height` panel, `rows` rows each
+// (0 or >= height: full frame). Replaces any previous layers, so their
+// contents are lost. When the RAM is short, halves the page down to
+// EPD_FB_MIN_ROWS (check epd_fb_rows() for the size in use). Returns false
+// when not even that fits: the layers then have no storage (see
+// epd_fb_isReady()).
+bool epd_fb_init(uint16_t width, uint16_t height, uint16_t rows = 0);
+
+// True when every layer has its storage. Without it drawing does nothing
+// and epd_fb_compose() emits paper.
+bool epd_fb_isReady(void);
+
+// Standby canvas: a second full-frame CONTENT that a job can draw ahead of
+// time and swap in later (epd_fb_swapStandby exchanges the buffers, no
+// copy). Full-frame mode only; epd_fb_init() drops it. Returns false when it
+// cannot be allocated.
+bool epd_fb_setStandby(bool enabled);
+EpdCanvas *epd_fb_standby(void);    // NULL when not allocated
+void epd_fb_swapStandby(void);
+
+// Rows held per layer, and whether that is less than the full frame.
+uint16_t epd_fb_rows(void);
+bool epd_fb_isPaged(void);
+
+// Paged mode: make all layers cover panel rows [y, y + epd_fb_rows()).
+// Layer contents are not moved: redraw (or clear) them afterwards.
+void epd_fb_setWindow(int16_t y);
+
+// Access a layer canvas (ink plane).
+EpdCanvas &epd_fb_layer(EpdLayerId id);
+
+// Coverage mask of the overlay layer: set bits mark pixels the overlay owns.
+EpdCanvas &epd_fb_overlayMask(void);
+
+// Layer visibility (hidden layers are skipped when compositing)
+void epd_fb_setVisible(EpdLayerId id, bool visible);
+bool epd_fb_isVisible(EpdLayerId id);
+
+// Clear a layer (and the overlay mask for EPD_LAYER_OVERLAY).
+void epd_fb_clear(EpdLayerId id);
+
+// Bake the current composite into CONTENT, then show CONTENT only.
+// Used before a job draws on top of whatever is on screen (e.g. partial text).
+// Full-frame mode only: a paged composite is not kept between jobs.
+void epd_fb_flatten(void);
+
+// Composite `rows` rows starting at `y`, bytes [xByte, xByte + wBytes) of each row,
+// into `out` (packed, wBytes per row). The rows must lie inside the current window.
+// - controllerPolarity: emit the panel RAM convention (bit set = white)
+void epd_fb_compose(int16_t y, int16_t rows, int16_t xByte, int16_t wBytes, uint8_t *out, bool controllerPolarity);
+
+// Total bytes held by the layer stack (for diagnostics).
+size_t epd_fb_bytes(void);
@@ -0,0 +1,187 @@
+/*
+  glyph_atlas.cpp
+
+  Captures the e-paper fonts into packed 1-bpp glyph bitmaps once at init,
+  then draws text as mask blits into an EpdCanvas.
+*/
+
+#include "glyph_atlas.h"
+
+#include <U8g2_for_Adafruit_GFX.h>
+#include <string.h>
+#include <vector>
+
+#define ATLAS_FIRST 0x20
+#define ATLAS_LAST 0x7E
+#define ATLAS_GLYPHS (ATLAS_LAST - ATLAS_FIRST + 1)
+
+// Scratch canvas used to capture one glyph (large enough for profont29)
+#define CAPTURE_W 48
+#define CAPTURE_H 48
+#define CAPTURE_X 8
+#define CAPTURE_BASELINE 36
+
+struct AtlasGlyph {
+  uint16_t offset;  // first byte in AtlasFont::bitmap
+  uint8_t w, h;     // bitmap size (0 for blank glyphs such as space)
+  int8_t x;         // left edge relative to the cursor
+  int8_t y;         // top edge relative to the baseline
+  uint8_t advance;  // cursor delta
+  uint8_t extent;   // width contributed when last in a string (U8g2 semantics)
+};
+
+struct AtlasFont {
+  const uint8_t *u8g2Font;
+  bool bold;
+  int8_t ascent;
+  int8_t descent;
+  AtlasGlyph glyphs[ATLAS_GLYPHS];
+  std::vector<uint8_t> bitmap;
+};
+
+static AtlasFont s_fonts[EPD_FONT_COUNT] = {
+  {u8g2_font_profont12_tr, false, 0, 0, {}, {}},
+  {u8g2_font_profont15_tr, false, 0, 0, {}, {}},
+  {u8g2_font_profont15_tr, true, 0, 0, {}, {}},
+  {u8g2_font_profont17_tr, false, 0, 0, {}, {}},
+  {u8g2_font_profont29_tr, false, 0, 0, {}, {}},
+};
+
+static inline bool _pixel(const EpdCanvas &c, int16_t x, int16_t y) {
+  if (x < 0 || x >= c.width()) return false;
+  return (c.buffer()[y * c.stride() + (x >> 3)] >> (7 - (x & 7))) & 1;
+}
+
+// Pixel of the captured glyph, smeared one pixel to the right for bold fonts
+static inline bool _glyphPixel(const EpdCanvas &c, int16_t x, int16_t y, bool bold) {
+  return _pixel(c, x, y) || (bold && _pixel(c, x - 1, y));
+}
+
+static void _captureFont(AtlasFont &f, U8G2_FOR_ADAFRUIT_GFX &u8g2, EpdCanvas &scratch) {
+  u8g2.setFont(f.u8g2Font);
+  u8g2.setFontMode(1);
+  u8g2.setForegroundColor(GxEPD_BLACK);
+  f.ascent = u8g2.getFontAscent();
+  f.descent = u8g2.getFontDescent();
+  f.bitmap.clear();
+
+  for (int ch = ATLAS_FIRST; ch <= ATLAS_LAST; ++ch) {
+    AtlasGlyph &g = f.glyphs[ch - ATLAS_FIRST];
+    char str[2] = {(char)ch, 0};
+
+    scratch.fillScreen(GxEPD_WHITE);
+    g.advance = u8g2.drawGlyph(CAPTURE_X, CAPTURE_BASELINE, ch);
+    g.extent = u8g2.getUTF8Width(str);
+
+    // Bounding box of the inked pixels
+    int16_t minX = CAPTURE_W, minY = CAPTURE_H, maxX = -1, maxY = -1;
+    for (int16_t y = 0; y < CAPTURE_H; ++y) {
+      for (int16_t x = 0; x < CAPTURE_W; ++x) {
+        if (!_glyphPixel(scratch, x, y, f.bold)) continue;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+      }
+    }
+
+    g.offset = f.bitmap.size();
+    if (maxX < 0) {
+      g.w = g.h = 0;
+      g.x = g.y = 0;
+      continue;
+    }
+    if (f.bold) g.extent += 1;
+
+    g.w = maxX - minX + 1;
+    g.h = maxY - minY + 1;
+    g.x = minX - CAPTURE_X;
+    g.y = minY - CAPTURE_BASELINE;
+
+    const int stride = (g.w + 7) / 8;
+    f.bitmap.resize(g.offset + stride * g.h, 0);
+    uint8_t *dst = &f.bitmap[g.offset];
+    for (int16_t y = 0; y < g.h; ++y) {
+      for (int16_t x = 0; x < g.w; ++x) {
+        if (_glyphPixel(scratch, minX + x, minY + y, f.bold)) {
+          dst[y * stride + (x >> 3)] |= 0x80 >> (x & 7);
+        }
+      }
+    }
+  }
+
+  f.bitmap.shrink_to_fit();
+}
+
+bool epd_atlas_init(void) {
+  EpdCanvas scratch(CAPTURE_W, CAPTURE_H);
+  if (!scratch.begin()) return false;
+
+  U8G2_FOR_ADAFRUIT_GFX u8g2;
+  u8g2.begin(scratch);
+
+  for (int i = 0; i < EPD_FONT_COUNT; ++i) {
+    _captureFont(s_fonts[i], u8g2, scratch);
+  }
+  return true;
+}
+
+int16_t epd_atlas_drawText(EpdCanvas &canvas, EpdFont font, int16_t x, int16_t y, const char *text, uint16_t color) {
+  if (!text) return x;
+  return epd_atlas_drawText(canvas, font, x, y, text, strlen(text), color);
+}
+
+int16_t epd_atlas_drawText(EpdCanvas &canvas, EpdFont font, int16_t x, int16_t y, const char *text, size_t len, uint16_t color) {
+  const AtlasFont &f = s_fonts[font];
+  if (!text || f.bitmap.empty()) return x;
+
+  for (const char *p = text; p < text + len; ++p) {
+    uint8_t ch = (uint8_t)*p;
+    if (ch < ATLAS_FIRST || ch > ATLAS_LAST) continue;
+    const AtlasGlyph &g = f.glyphs[ch - ATLAS_FIRST];
+    if (g.w) {
+      canvas.drawMask(&f.bitmap[g.offset], (g.w + 7) / 8, x + g.x, y + g.y, g.w, g.h, color);
+    }
+    x += g.advance;
+  }
+  return x;
+}
+
+int16_t epd_atlas_textWidth(EpdFont font, const char *text) {
+  const AtlasFont &f = s_fonts[font];
+  if (!text) return 0;
+
+  int16_t w = 0;
+  const AtlasGlyph *last = nullptr;
+  for (const char *p = text; *p; ++p) {
+    uint8_t ch = (uint8_t)*p;
+    if (ch < ATLAS_FIRST || ch > ATLAS_LAST) continue;
+    last = &f.glyphs[ch - ATLAS_FIRST];
+    w += last->advance;
+  }
+  // U8g2 counts the real pixel width of the last glyph instead of its advance
+  if (last) w += last->extent - last->advance;
+  return w;
+}
+
+uint8_t epd_atlas_advance(EpdFont font, char ch) {
+  uint8_t c = (uint8_t)ch;
+  if (c < ATLAS_FIRST || c > ATLAS_LAST) return 0;
+  return s_fonts[font].glyphs[c - ATLAS_FIRST].advance;
+}
+
+int8_t epd_atlas_ascent(EpdFont font) {
+  return s_fonts[font].ascent;
+}
+
+int8_t epd_atlas_descent(EpdFont font) {
+  return s_fonts[font].descent;
+}
+
+size_t epd_atlas_bytes(void) {
+  size_t total = 0;
+  for (int i = 0; i < EPD_FONT_COUNT; ++i) {
+    total += s_fonts[i].bitmap.size() + sizeof(s_fonts[i].glyphs);
+  }
+  return total;
+}
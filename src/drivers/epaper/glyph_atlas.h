@@ -0,0 +1,50 @@
+#pragma once
+
+/*
+ * drivers/epaper/glyph_atlas.h
+ *
+ * Pre-rasterized 1-bpp glyph atlas for e-paper text.
+ *
+ * The fonts used by the display task are rendered once through U8g2 at init
+ * and stored as packed bitmaps (same convention as framebuffer.h). Drawing
+ * text is then a sequence of byte-wide mask blits into an EpdCanvas instead
+ * of one drawPixel call per glyph pixel.
+ *
+ * Notes:
+ *  - Only printable ASCII (0x20..0x7E) is captured, matching the "_tr" fonts.
+ *    Other bytes (UTF-8 sequences) are skipped, as U8g2 does for missing glyphs.
+ *  - Metrics follow U8g2: y is the baseline, widths match getUTF8Width().
+ */
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "framebuffer.h"
+
+enum EpdFont {
+  EPD_FONT_PROFONT12,
+  EPD_FONT_PROFONT15,
+  EPD_FONT_PROFONT15_BOLD, // profont15 emboldened by 1 px
+  EPD_FONT_PROFONT17,
+  EPD_FONT_PROFONT29,
+  EPD_FONT_COUNT
+};
+
+// Rasterize all atlas fonts. Returns false when out of memory.
+bool epd_atlas_init(void);
+
+// Draw `text` with its baseline at (x, y). Returns the cursor x after the text.
+int16_t epd_atlas_drawText(EpdCanvas &canvas, EpdFont font, int16_t x, int16_t y, const char *text, uint16_t color = GxEPD_BLACK);
+// Same for the first `len` bytes of `text` (no terminator needed)
+int16_t epd_atlas_drawText(EpdCanvas &canvas, EpdFont font, int16_t x, int16_t y, const char *text, size_t len, uint16_t color);
+
+// Pixel width of `text` (same result as U8g2 getUTF8Width()).
+int16_t epd_atlas_textWidth(EpdFont font, const char *text);
+
+// Cursor advance of one character (0 for bytes outside the atlas)
+uint8_t epd_atlas_advance(EpdFont font, char ch);
+
+int8_t epd_atlas_ascent(EpdFont font);
+int8_t epd_atlas_descent(EpdFont font);
+
+// Bytes held by all atlases (for diagnostics).
+size_t epd_atlas_bytes(void);
@@ -0,0 +1,109 @@
+/*
+  gray4.cpp
+
+  4-level grayscale waveform for the SSD1680 2.9" panel (see gray4.h).
+*/
+
+#include "gray4.h"
+
+// 4-gray waveform (159 bytes): 153 bytes of LUT for 0x32, then the gate level
+// (0x3F), gate voltage (0x03), source voltages (0x04) and VCOM (0x2C).
+static const uint8_t LUT_GRAY4[159] = {
+  0x00, 0x60, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // VS L0 (white)
+  0x20, 0x60, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // VS L1
+  0x28, 0x60, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // VS L2
+  0x2A, 0x60, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // VS L3 (black)
+  0x00, 0x90, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // VS L4 (VCOM)
+  0x00, 0x02, 0x00, 0x05, 0x14, 0x00, 0x00, // TP, SR, RP of group 0
+  0x1E, 0x1E, 0x00, 0x00, 0x00, 0x00, 0x01, // group 1
+  0x00, 0x02, 0x00, 0x05, 0x14, 0x00, 0x00, // group 2
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // group 3
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // group 4
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // group 5
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // group 6
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // group 7
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // group 8
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // group 9
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // group 10
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // group 11
+  0x24, 0x22, 0x22, 0x22, 0x23, 0x32, 0x00, 0x00, 0x00, // FR, XON
+  0x22, 0x17, 0x41, 0xAE, 0x32, 0x28, // EOPT, VGH, VSH1, VSH2, VSL, VCOM
+};
+
+void GxEPD2_290_T94_V2_G4::gray4Begin() {
+  _reset();
+  _writeCommand(0x12); // SWRESET
+  _waitWhileBusy("gray4 reset", power_on_time);
+
+  _writeCommand(0x01); // driver output control
+  _writeData((HEIGHT - 1) % 256);
+  _writeData((HEIGHT - 1) / 256);
+  _writeData(0x00);
+  _writeCommand(0x11); // data entry mode: x+, y+
+  _writeData(0x03);
+  _writeCommand(0x44); // RAM x range (bytes)
+  _writeData(0x00);
+  _writeData(WIDTH / 8 - 1);
+  _writeCommand(0x45); // RAM y range
+  _writeData(0x00);
+  _writeData(0x00);
+  _writeData((HEIGHT - 1) % 256);
+  _writeData((HEIGHT - 1) / 256);
+  _writeCommand(0x3C); // border waveform
+  _writeData(0x04);
+  _writeCommand(0x21); // display update control: normal RAM use
+  _writeData(0x00);
+  _writeData(0x80);
+  _writeCommand(0x18); // internal temperature sensor
+  _writeData(0x80);
+  _waitWhileBusy("gray4 init", power_on_time);
+
+  _writeCommand(0x32);
+  _writeData(LUT_GRAY4, 153);
+  _waitWhileBusy("gray4 lut", power_on_time);
+  _writeCommand(0x3F);
+  _writeData(LUT_GRAY4[153]);
+  _writeCommand(0x03);
+  _writeData(LUT_GRAY4[154]);
+  _writeCommand(0x04);
+  _writeData(LUT_GRAY4[155]);
+  _writeData(LUT_GRAY4[156]);
+  _writeData(LUT_GRAY4[157]);
+  _writeCommand(0x2C);
+  _writeData(LUT_GRAY4[158]);
+
+  // The waveform no longer matches what GxEPD2 expects
+  _init_display_done = false;
+  _using_partial_mode = false;
+}
+
+void GxEPD2_290_T94_V2_G4::gray4StartPlane(bool highBit) {
+  _writeCommand(0x4E); // RAM x counter
+  _writeData(0x00);
+  _writeCommand(0x4F); // RAM y counter
+  _writeData(0x00);
+  _writeData(0x00);
+  _writeCommand(highBit ? 0x26 : 0x24);
+  _startTransfer();
+}
+
+void GxEPD2_290_T94_V2_G4::gray4WritePlane(const uint8_t *data, uint16_t n) {
+  for (uint16_t i = 0; i < n; ++i) _transfer(data[i]);
+}
+
+void GxEPD2_290_T94_V2_G4::gray4EndPlane() {
+  _endTransfer();
+}
+
+void GxEPD2_290_T94_V2_G4::gray4Refresh() {
+  _writeCommand(0x22);
+  _writeData(0xC7); // clock + analog on, display with the loaded LUT, power off
+  _writeCommand(0x20);
+  _waitWhileBusy("gray4 refresh", full_refresh_time);
+
+  // Next GxEPD2 call: hardware reset, clean RAM and a full refresh
+  _power_is_on = false;
+  _hibernating = true;
+  _initial_write = true;
+  _initial_refresh = true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+/*
+ * drivers/epaper/gray4.h
+ *
+ * GxEPD2_290_T94_V2 (SSD1680, 2.9" 128x296) with a native 4-level grayscale mode.
+ *
+ * Black/white operation is unchanged (all GxEPD2 methods still apply). A gray
+ * refresh loads a custom waveform LUT and uses both controller RAM planes:
+ *  - 0x24 holds the low bit of each pixel level, 0x26 the high bit
+ *  - level 0 = white ... level 3 = black
+ *
+ * After a gray refresh the controller is reset lazily: the next GxEPD2 call
+ * re-initializes it and performs a full refresh.
+ */
+
+#include <GxEPD2_BW.h>
+
+class GxEPD2_290_T94_V2_G4 : public GxEPD2_290_T94_V2 {
+public:
+  GxEPD2_290_T94_V2_G4(int16_t cs, int16_t dc, int16_t rst, int16_t busy)
+    : GxEPD2_290_T94_V2(cs, dc, rst, busy) {}
+
+  // Reset the controller, load the 4-gray LUT and set a full-screen RAM window.
+  void gray4Begin();
+
+  // Start streaming one bit plane (false: low bit / 0x24, true: high bit / 0x26).
+  // Rows are WIDTH / 8 bytes, top to bottom, bit set = bit of the level is 1.
+  void gray4StartPlane(bool highBit);
+  void gray4WritePlane(const uint8_t *data, uint16_t n);
+  void gray4EndPlane();
+
+  // Run the 4-gray update and mark the controller for re-initialization.
+  void gray4Refresh();
+};
@@ -0,0 +1,201 @@
+/*
+  layout.cpp
+
+  Layout pass for EpdPage (see layout.h). Runs on the caller's task: it only
+  reads the glyph atlas metrics, which are fixed after epd_init().
+*/
+
+#include "layout.h"
+#include "display.h"
+#include "glyph_atlas.h"
+#include <algorithm>
+
+#define PARAGRAPH_FONT EPD_FONT_PROFONT12
+#define PARAGRAPH_MARGIN 2 // left / right
+#define PARAGRAPH_GAP 4    // after the last line
+
+static int16_t _lineHeight(EpdFont font) {
+    return epd_atlas_ascent(font) - epd_atlas_descent(font);
+}
+
+void epd_page_addParagraph(EpdPage& page, const String& text, uint16_t color) {
+    // Copy on write: a queued job may still be reading the current buffer
+    if (!page.text) page.text = std::make_shared<String>();
+    else if (page.text.use_count() > 1) page.text = std::make_shared<String>(*page.text);
+
+    EpdComponent comp = {EPD_COMP_PARAGRAPH, "", "", 0, color};
+    comp.offset = page.text->length();
+    comp.length = text.length();
+    *page.text += text;
+    page.components.push_back(comp);
+}
+
+int16_t epd_layout_paragraphWidth(void) {
+    return epd_width() - 2 * PARAGRAPH_MARGIN;
+}
+
+int16_t epd_layout_paragraphPitch(void) {
+    return _lineHeight(PARAGRAPH_FONT);
+}
+
+int16_t epd_layout_paragraphGap(void) {
+    return PARAGRAPH_GAP;
+}
+
+size_t epd_layout_nextLine(const char* text, size_t n, int16_t width, size_t& drawLen) {
+    int16_t x = 0;
+    size_t lastSpace = 0; // 0 = no break opportunity yet
+
+    for (size_t i = 0; i < n; ++i) {
+        char ch = text[i];
+        if (ch == '\n') {
+            drawLen = i;
+            return i + 1;
+        }
+        int16_t adv = epd_atlas_advance(PARAGRAPH_FONT, ch);
+        if (x + adv > width && i > 0) {
+            size_t used;
+            if (lastSpace > 0) {
+                drawLen = lastSpace;
+                used = lastSpace + 1;
+            } else {
+                drawLen = i; // word wider than the line: hard break
+                used = i;
+            }
+            while (used < n && text[used] == ' ') used++;
+            return used;
+        }
+        if (ch == ' ') lastSpace = i;
+        x += adv;
+    }
+    drawLen = n;
+    return n;
+}
+
+// Span of a paragraph component, clamped to the page buffer
+static const char* _span(const EpdPage& page, const EpdComponent& comp, size_t& n) {
+    n = 0;
+    if (!page.text || comp.offset >= page.text->length()) return "";
+    n = std::min<size_t>(comp.length, page.text->length() - comp.offset);
+    return page.text->c_str() + comp.offset;
+}
+
+EpdLayoutBox epd_layout_measure(const EpdPage& page, const EpdComponent& comp) {
+    switch (comp.type) {
+        case EPD_COMP_HEADER:
+            return {(int16_t)(_lineHeight(EPD_FONT_PROFONT15_BOLD) + 1), _lineHeight(EPD_FONT_PROFONT15_BOLD)};
+        case EPD_COMP_ROW:
+            // Rows are packed on the profont12 pitch; descenders may touch the next row
+            return {_lineHeight(EPD_FONT_PROFONT12), _lineHeight(EPD_FONT_PROFONT15)};
+        case EPD_COMP_PROGRESS:
+            // Label / percentage in profont12, 8 px bar 2 px below the top
+            return {_lineHeight(EPD_FONT_PROFONT15), std::max<int16_t>(_lineHeight(EPD_FONT_PROFONT12), 10)};
+        case EPD_COMP_SEPARATOR:
+            return {4, 2};
+        case EPD_COMP_PARAGRAPH: {
+            size_t n, drawLen;
+            const char* s = _span(page, comp, n);
+            const int16_t width = epd_layout_paragraphWidth();
+            int16_t lines = 0;
+            for (size_t pos = 0; pos < n; ++lines) pos += epd_layout_nextLine(s + pos, n - pos, width, drawLen);
+            int16_t extent = lines * epd_layout_paragraphPitch();
+            return {(int16_t)(lines ? extent + PARAGRAPH_GAP : 0), extent};
+        }
+    }
+    return {0, 0};
+}
+
+int16_t epd_layout_top(const EpdPage& page) {
+    if (page.title.length() == 0) return 2;
+    // Title baseline, double rule, margin
+    return epd_atlas_ascent(EPD_FONT_PROFONT15_BOLD) + 8 + 10;
+}
+
+size_t epd_layout_paginate(const EpdPage& page, EpdLayout& layout) {
+    const int16_t bottom = epd_height();
+    if (layout.height == bottom && !layout.starts.empty()) return layout.screens();
+
+    layout.height = bottom;
+    layout.starts.assign(1, {0, 0});
+
+    const int16_t top = epd_layout_top(page);
+    const int16_t width = epd_layout_paragraphWidth();
+    const int16_t pitch = epd_layout_paragraphPitch();
+    int16_t y = top;
+    bool empty = true; // nothing placed on the current screen yet
+
+    for (size_t i = 0; i < page.components.size(); ++i) {
+        const EpdComponent& comp = page.components[i];
+
+        if (comp.type == EPD_COMP_PARAGRAPH) {
+            // Line by line, so a long paragraph continues on the next screen
+            size_t n, drawLen;
+            const char* s = _span(page, comp, n);
+            for (size_t pos = 0; pos < n;) {
+                if (y + pitch > bottom && !empty) {
+                    layout.starts.push_back({(uint16_t)i, (uint32_t)pos});
+                    y = top;
+                }
+                pos += epd_layout_nextLine(s + pos, n - pos, width, drawLen);
+                y += pitch;
+                empty = false;
+            }
+            if (n > 0) y += PARAGRAPH_GAP;
+            continue;
+        }
+
+        EpdLayoutBox box = epd_layout_measure(page, comp);
+        // Break before a component that does not fit (never leave a screen empty)
+        if (y + box.extent > bottom && !empty) {
+            layout.starts.push_back({(uint16_t)i, 0});
+            y = top;
+        }
+        y += box.advance;
+        empty = false;
+    }
+    return layout.screens();
+}
+
+void epd_layout_screen(const EpdPage& page, const EpdLayout& layout, size_t index, EpdPage& out) {
+    out.title = page.title;
+    out.text = page.text;
+    out.components.clear();
+
+    const size_t count = page.components.size();
+    if (layout.starts.empty()) {
+        out.components = page.components;
+        return;
+    }
+    if (index >= layout.starts.size()) index = layout.starts.size() - 1;
+
+    // A stale layout (page changed without a reset) must not index past the end
+    const EpdScreenStart start = layout.starts[index];
+    const bool hasNext = index + 1 < layout.starts.size();
+    const EpdScreenStart next = hasNext ? layout.starts[index + 1] : EpdScreenStart{(uint16_t)count, 0};
+    const size_t first = std::min<size_t>(start.component, count);
+    const size_t last = std::min<size_t>(next.component + (next.skip ? 1 : 0), count);
+
+    for (size_t k = first; k < last; ++k) {
+        EpdComponent comp = page.components[k];
+        if (comp.type == EPD_COMP_PARAGRAPH) {
+            uint32_t end = (k == next.component && next.skip) ? std::min(next.skip, comp.length) : comp.length;
+            uint32_t begin = std::min(k == first ? start.skip : 0, end);
+            comp.offset += begin;
+            comp.length = end - begin;
+        }
+        out.components.push_back(comp);
+    }
+}
+
+void epd_displayPageScreen(const EpdPage& page, EpdLayout& layout, size_t index, bool forceFull) {
+    epd_layout_paginate(page, layout);
+
+    EpdPage screen;
+    epd_layout_screen(page, layout, index, screen);
+    epd_displayPage(screen, forceFull);
+
+    if (index + 1 < layout.screens()) {
+        epd_layout_screen(page, layout, index + 1, screen);
+        epd_prepareStandby(screen);
+    }
+}
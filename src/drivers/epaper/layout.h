@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include <memory>
 #include <vector>
 #include <stdint.h>
 
@@ -8,7 +9,8 @@ enum EpdComponentType {
     EPD_COMP_HEADER,
     EPD_COMP_ROW,
     EPD_COMP_PROGRESS,
-    EPD_COMP_SEPARATOR
+    EPD_COMP_SEPARATOR,
+    EPD_COMP_PARAGRAPH  // text span of EpdPage::text, word-wrapped by the display task
 };
 
 struct EpdComponent {
@@ -17,13 +19,88 @@ struct EpdComponent {
     String text2;
     float value;
     uint16_t color;
+    uint32_t offset = 0;  // EPD_COMP_PARAGRAPH: span in EpdPage::text
+    uint32_t length = 0;
 };
 
 // A page is a collection of components to be rendered on the e-paper
 struct EpdPage {
     String title;
     std::vector<EpdComponent> components;
+    // Paragraph text, shared with the queued jobs instead of copied. Do not
+    // modify it once a job holds it (epd_page_addParagraph() copies then).
+    std::shared_ptr<String> text;
 };
 
-// API to queue a structured page for rendering
-void epd_displayPage(const EpdPage& page);
+// Append `text` to the page's buffer and a paragraph component spanning it
+void epd_page_addParagraph(EpdPage& page, const String& text, uint16_t color = 0);
+
+// API to queue a structured page for rendering. Pages use a full refresh
+// unless `forceFull` is false and partial updates are enabled. Components
+// that do not fit on the panel are dropped; use the layout pass below to
+// show long pages screen by screen.
+void epd_displayPage(const EpdPage& page, bool forceFull = true);
+
+// Draw `page` ahead of time into the standby frame buffer (queued; the panel
+// is not touched). A later epd_displayPage() with the same content swaps it
+// in, so only the refresh is left. Returns false without a standby buffer
+// (EPD_STANDBY_BUFFER, full-frame mode only) or when the queue is full.
+bool epd_prepareStandby(const EpdPage& page);
+
+// --- Layout ---
+//
+// Measures components with the glyph atlas metrics (the same numbers the
+// display task draws with) and splits a page into screens that fit the
+// panel. The title is repeated on every screen.
+
+// Vertical space of one component: `advance` moves to the next component,
+// `extent` is the height of its ink (what has to fit above the panel edge).
+// Paragraphs are wrapped to the panel width to count their lines.
+struct EpdLayoutBox {
+    int16_t advance;
+    int16_t extent;
+};
+
+EpdLayoutBox epd_layout_measure(const EpdPage& page, const EpdComponent& comp);
+
+// Paragraph line breaking: returns how many bytes of text[0..n) the next
+// line consumes and sets `drawLen` to the bytes to draw. Breaks at spaces
+// (or inside a word longer than `width`) and at '\n'.
+size_t epd_layout_nextLine(const char* text, size_t n, int16_t width, size_t& drawLen);
+
+// Paragraph metrics: text area width, line pitch, space after the last line
+int16_t epd_layout_paragraphWidth(void);
+int16_t epd_layout_paragraphPitch(void);
+int16_t epd_layout_paragraphGap(void);
+
+// y of the first component (below the title block, if any)
+int16_t epd_layout_top(const EpdPage& page);
+
+// First component of a screen. A paragraph split across screens continues
+// `skip` bytes into its span.
+struct EpdScreenStart {
+    uint16_t component;
+    uint32_t skip;
+};
+
+// Screen breaks of a page, computed once and kept by the caller. Reset it
+// (layout = EpdLayout()) whenever the page content changes.
+struct EpdLayout {
+    uint16_t height = 0;                 // panel height it was computed for (0 = not laid out)
+    std::vector<EpdScreenStart> starts;  // one entry per screen
+
+    size_t screens() const { return starts.size(); }
+};
+
+// Lay out `page` into `layout` unless it already holds a layout for the
+// current panel. Returns the number of screens (at least 1).
+size_t epd_layout_paginate(const EpdPage& page, EpdLayout& layout);
+
+// Build screen `index` (clamped to the last screen) as a page of its own:
+// the components on it, paragraph spans trimmed to the screen. The text
+// buffer is shared, not copied.
+void epd_layout_screen(const EpdPage& page, const EpdLayout& layout, size_t index, EpdPage& out);
+
+// Queue screen `index` of a paginated page, then prepare the following
+// screen in the standby buffer (if any) for the next page turn
+void epd_displayPageScreen(const EpdPage& page, EpdLayout& layout, size_t index, bool forceFull = true);
@@ -0,0 +1,101 @@
+/*
+  stats.cpp
+
+  Ring buffer and histograms for EPD job timings (see stats.h).
+*/
+
+#include "stats.h"
+
+#include <string.h>
+#include <algorithm>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+static EpdJobStats s_ring[EPD_STATS_RING];
+static size_t s_head = 0;   // next slot to write
+static size_t s_count = 0;  // valid entries
+static EpdStatsSummary s_summary;
+static SemaphoreHandle_t s_mutex = NULL;
+
+// The mutex is created on first use; epd_init() resets the stats before the task starts
+static bool _lock(void) {
+  if (s_mutex == NULL) s_mutex = xSemaphoreCreateMutex();
+  return s_mutex && xSemaphoreTake(s_mutex, pdMS_TO_TICKS(50)) == pdTRUE;
+}
+
+static void _unlock(void) {
+  xSemaphoreGive(s_mutex);
+}
+
+static int _bucket(uint32_t us) {
+  uint32_t ms = us / 1000;
+  int b = 0;
+  while (ms > 0 && b < EPD_STATS_BUCKETS - 1) {
+    ms >>= 1;
+    b++;
+  }
+  return b;
+}
+
+void epd_stats_record(const EpdJobStats &job) {
+  if (!_lock()) return;
+
+  s_ring[s_head] = job;
+  s_head = (s_head + 1) % EPD_STATS_RING;
+  if (s_count < EPD_STATS_RING) s_count++;
+
+  s_summary.jobs++;
+  EpdPhaseAggregate *agg = job.partial ? s_summary.partial : s_summary.full;
+  for (int p = 0; p < EPD_PHASE_COUNT; ++p) {
+    EpdPhaseAggregate &a = agg[p];
+    a.count++;
+    a.sumUs += job.us[p];
+    if (job.us[p] > a.maxUs) a.maxUs = job.us[p];
+    uint16_t &h = a.hist[_bucket(job.us[p])];
+    if (h < UINT16_MAX) h++;
+  }
+
+  _unlock();
+}
+
+size_t epd_stats_recent(EpdJobStats *out, size_t max) {
+  if (!_lock()) return 0;
+  size_t n = std::min(max, s_count);
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = s_ring[(s_head + EPD_STATS_RING - 1 - i) % EPD_STATS_RING];
+  }
+  _unlock();
+  return n;
+}
+
+void epd_stats_summary(EpdStatsSummary &out) {
+  if (!_lock()) {
+    memset(&out, 0, sizeof(out));
+    return;
+  }
+  out = s_summary;
+  _unlock();
+}
+
+void epd_stats_reset(void) {
+  if (!_lock()) return;
+  s_head = 0;
+  s_count = 0;
+  memset(&s_summary, 0, sizeof(s_summary));
+  _unlock();
+}
+
+const char *epd_stats_phaseName(EpdStatPhase phase) {
+  switch (phase) {
+    case EPD_PHASE_QUEUE: return "queue";
+    case EPD_PHASE_RASTER: return "raster";
+    case EPD_PHASE_TRANSFER: return "transfer";
+    case EPD_PHASE_BUSY: return "busy";
+    case EPD_PHASE_TOTAL: return "total";
+    default: return "?";
+  }
+}
+
+uint32_t epd_stats_bucketMs(int i) {
+  return i == 0 ? 0 : (1u << (i - 1));
+}
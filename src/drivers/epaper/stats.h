@@ -0,0 +1,71 @@
+#pragma once
+
+/*
+ * drivers/epaper/stats.h
+ *
+ * Per-job timing of the e-paper task.
+ *
+ * Every executed job records where its time went:
+ *  - QUEUE    : from epd_* call until the task picked the job up
+ *  - RASTER   : drawing into the layers (everything that is not I/O)
+ *  - TRANSFER : compositing + SPI writes to the controller RAM
+ *  - BUSY     : refresh commands and waiting on the BUSY pin
+ *  - TOTAL    : execution time (RASTER + TRANSFER + BUSY)
+ *
+ * The last EPD_STATS_RING jobs are kept in a ring buffer; aggregates with
+ * log2 millisecond histograms are kept separately for full and partial jobs.
+ * Records are written by the EPD task and read from HTTP handlers.
+ */
+
+#include <Arduino.h>
+#include <stdint.h>
+
+#define EPD_STATS_RING 32
+#define EPD_STATS_BUCKETS 13 // <1 ms, 1-2 ms, 2-4 ms, ... >= 2048 ms
+
+enum EpdStatPhase {
+  EPD_PHASE_QUEUE,
+  EPD_PHASE_RASTER,
+  EPD_PHASE_TRANSFER,
+  EPD_PHASE_BUSY,
+  EPD_PHASE_TOTAL,
+  EPD_PHASE_COUNT
+};
+
+struct EpdJobStats {
+  const char *type;          // job type name (static string)
+  char source[16];           // tag active when the job was queued
+  bool partial;              // refreshed with a partial window
+  bool standby;              // page swapped in from the standby buffer (no raster)
+  uint32_t enqueuedMs;       // millis() at enqueue
+  uint32_t us[EPD_PHASE_COUNT];
+};
+
+struct EpdPhaseAggregate {
+  uint32_t count;
+  uint64_t sumUs;
+  uint32_t maxUs;
+  uint16_t hist[EPD_STATS_BUCKETS];
+};
+
+struct EpdStatsSummary {
+  uint32_t jobs;
+  EpdPhaseAggregate full[EPD_PHASE_COUNT];
+  EpdPhaseAggregate partial[EPD_PHASE_COUNT];
+};
+
+// Store a finished job (called from the EPD task).
+void epd_stats_record(const EpdJobStats &job);
+
+// Copy up to `max` recent jobs, newest first. Returns the number copied.
+size_t epd_stats_recent(EpdJobStats *out, size_t max);
+
+// Copy the aggregates.
+void epd_stats_summary(EpdStatsSummary &out);
+
+void epd_stats_reset(void);
+
+const char *epd_stats_phaseName(EpdStatPhase phase);
+
+// Lower bound (ms) of histogram bucket `i` (0 for the first bucket).
+uint32_t epd_stats_bucketMs(int i);
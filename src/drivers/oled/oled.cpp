@@ -12,6 +12,10 @@
 #include <U8g2_for_Adafruit_GFX.h>
 
 #include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <vector>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 #include "utils/logger/logger.h"
@@ -31,16 +35,89 @@ static SemaphoreHandle_t s_oledMutex = NULL;
 #define LOCK_OLED()   if (s_oledMutex) xSemaphoreTake(s_oledMutex, portMAX_DELAY)
 #define UNLOCK_OLED() if (s_oledMutex) xSemaphoreGive(s_oledMutex)
 
+// Flush: bus clock while sending (and after, as Adafruit_SSD1306 does)
+#define OLED_I2C_CLOCK 400000UL
+#define OLED_I2C_CLOCK_IDLE 100000UL
+// Data bytes per I2C transaction, after the control byte
+#ifdef I2C_BUFFER_LENGTH
+#define OLED_I2C_CHUNK (I2C_BUFFER_LENGTH - 1)
+#else
+#define OLED_I2C_CHUNK 31
+#endif
+// Unchanged columns worth re-sending to save a new address window
+#define OLED_SEGMENT_GAP 8
+
+// What the panel RAM holds: flushes send only the columns that differ
+static uint8_t s_flushed[OLED_WIDTH * OLED_HEIGHT / 8];
+static bool s_flushedValid = false;
+
 // Toast state
 static String s_toast_msg;
 static uint32_t s_toast_until = 0;
 static uint32_t s_toast_start = 0;
 static ToastPos s_toast_pos = TOAST_BOTTOM;
 static ToastIcon s_toast_icon = TOAST_ICON_NONE;
-static float s_toast_progress = 0.0f; 
+static q16_t s_toast_progress = 0;
 static bool s_toast_manual = false;
 static bool s_needs_scroll_update = false;
 
+// Send columns [x0, x1] of one page (column and page address windows, then data)
+static void _sendSegment(uint8_t page, uint8_t x0, uint8_t x1, const uint8_t *buf) {
+  const uint8_t addr[] = {0x00, 0x21, x0, x1, 0x22, page, page};
+  Wire.beginTransmission(s_i2c_addr);
+  Wire.write(addr, sizeof(addr));
+  Wire.endTransmission();
+
+  for (int x = x0; x <= x1; x += OLED_I2C_CHUNK) {
+    int n = x1 - x + 1 < OLED_I2C_CHUNK ? x1 - x + 1 : OLED_I2C_CHUNK;
+    Wire.beginTransmission(s_i2c_addr);
+    Wire.write((uint8_t)0x40);
+    Wire.write(buf + x, n);
+    Wire.endTransmission();
+  }
+}
+
+// Replaces display(): diff the buffer against the last flush, page by page,
+// and send only the changed column runs. Call with the lock held.
+static void _flush(void) {
+  const uint8_t *buf = s_oled.getBuffer();
+  bool clockSet = false;
+
+  for (uint8_t page = 0; page < OLED_HEIGHT / 8; ++page) {
+    const uint8_t *cur = buf + page * OLED_WIDTH;
+    uint8_t *old = s_flushed + page * OLED_WIDTH;
+
+    int x = 0;
+    while (x < OLED_WIDTH) {
+      if (s_flushedValid && cur[x] == old[x]) {
+        x++;
+        continue;
+      }
+      // Run of changed columns; short unchanged gaps are sent along
+      int start = x, end = x, gap = 0;
+      for (++x; x < OLED_WIDTH && gap <= OLED_SEGMENT_GAP; ++x) {
+        if (s_flushedValid && cur[x] == old[x]) {
+          gap++;
+        } else {
+          end = x;
+          gap = 0;
+        }
+      }
+      x = end + 1;
+
+      if (!clockSet) {
+        Wire.setClock(OLED_I2C_CLOCK);
+        clockSet = true;
+      }
+      _sendSegment(page, start, end, cur);
+      memcpy(old + start, cur + start, end - start + 1);
+    }
+  }
+
+  if (clockSet) Wire.setClock(OLED_I2C_CLOCK_IDLE);
+  s_flushedValid = true;
+}
+
 void oled_setMenuMode(bool enable) {
   LOCK_OLED();
   s_menu_mode = enable;
@@ -71,8 +148,10 @@ void oled_init(uint8_t sda, uint8_t scl, uint8_t address) {
     return;
   }
 
+  // Panel RAM is undefined after power-up: the first flush sends everything
+  s_flushedValid = false;
   s_oled.clearDisplay();
-  s_oled.display();
+  _flush();
 
   s_u8g2.begin(s_oled);
   s_u8g2.setFont(u8g2_font_profont11_tr);
@@ -92,7 +171,7 @@ void oled_clear(void) {
   LOCK_OLED();
   if (s_available) {
     s_oled.clearDisplay();
-    s_oled.display();
+    _flush();
   }
   UNLOCK_OLED();
 }
@@ -106,7 +185,29 @@ void oled_clearBuffer(void) {
 
 void oled_display(void) {
   LOCK_OLED();
-  if (s_available) s_oled.display();
+  if (s_available) _flush();
+  UNLOCK_OLED();
+}
+
+void oled_setPower(bool on) {
+  LOCK_OLED();
+  if (s_available) s_oled.ssd1306_command(on ? SSD1306_DISPLAYON : SSD1306_DISPLAYOFF);
+  UNLOCK_OLED();
+}
+
+void oled_readRow(int16_t y, uint8_t *out) {
+  memset(out, 0, OLED_WIDTH / 8);
+  if (y < 0 || y >= OLED_HEIGHT) return;
+
+  LOCK_OLED();
+  if (s_available) {
+    // SSD1306 layout: one byte per column per 8-row page, LSB = top row
+    const uint8_t *page = s_oled.getBuffer() + (y / 8) * OLED_WIDTH;
+    const uint8_t bit = 1 << (y & 7);
+    for (int x = 0; x < OLED_WIDTH; ++x) {
+      if (page[x] & bit) out[x >> 3] |= 0x80 >> (x & 7);
+    }
+  }
   UNLOCK_OLED();
 }
 
@@ -125,7 +226,7 @@ static void _drawCenteredText(const char *msg, uint8_t textSize) {
 
   s_u8g2.setCursor(x, y);
   s_u8g2.print(msg);
-  s_oled.display();
+  _flush();
 }
 
 void oled_showStatus(const char *msg) {
@@ -160,7 +261,7 @@ void oled_showLines(const char *line1, const char *line2, int16_t x_offset, int1
   s_u8g2.setCursor(x2, y2);
   s_u8g2.print(line2);
 
-  if (update) s_oled.display();
+  if (update) _flush();
   UNLOCK_OLED();
 }
 
@@ -189,14 +290,11 @@ void oled_showWiFiIcon(bool connected) {
   int16_t y = (OLED_HEIGHT / 2) + 8 - 4; // center vertically
   
   s_u8g2.drawGlyph(x, y, connected ? 0x4F : 0x45); // Icon 15 if connected, 5 if not
-  s_oled.display();
+  _flush();
   UNLOCK_OLED();
 }
 
-void oled_drawHomeScreen(const char *time, bool wifiConnected, int16_t x_offset, int16_t y_offset, bool update) {
-  LOCK_OLED();
-  if (!s_available) { UNLOCK_OLED(); return; }
-  
+static bool _drawHomeScreen(const char *time, bool wifiConnected, int16_t x_offset, int16_t y_offset) {
   s_u8g2.setFont(u8g2_font_logisoso20_tf); 
   int16_t w = s_u8g2.getUTF8Width(time);
   int16_t x = (OLED_WIDTH - w) / 2 + x_offset;
@@ -210,215 +308,413 @@ void oled_drawHomeScreen(const char *time, bool wifiConnected, int16_t x_offset,
       s_u8g2.setFont(u8g2_font_open_iconic_www_1x_t);
       s_u8g2.drawGlyph(wx_base, wy_base, 0x4F); // Icon 15 (connected)
   } 
+  return true;
+}
 
-  if (update) s_oled.display();
-  UNLOCK_OLED();
+/* ---------- Text measurement cache ----------
+ * Big and scrolling text pick a font and a line split by measuring the
+ * uppercased text up to four times. The choice only depends on the text and
+ * the header flag, so it is kept in a small LRU keyed by a hash of the text:
+ * a marquee headline is measured on its first frame only. Lookups compare
+ * case-insensitively, as the layout is that of the uppercased text.
+ */
+#define OLED_MEASURE_SLOTS 8
+
+enum MeasureMode : uint8_t { MEASURE_BIG, MEASURE_BIG_HEADER, MEASURE_SCROLL };
+enum TextFit : uint8_t { FIT_ONE_BIG, FIT_TWO_BIG, FIT_TWO_MEDIUM, FIT_SCROLL };
+
+struct TextMeasure {
+  bool used = false;
+  uint32_t hash = 0;
+  MeasureMode mode;
+  uint32_t lastUse = 0;
+  TextFit fit;
+  String upper;          // whole text, uppercased
+  String line1, line2;   // two-line fits only
+  int16_t width = 0;     // whole text in logisoso20
+  int16_t w1 = 0, w2 = 0;
+};
+
+static TextMeasure s_measures[OLED_MEASURE_SLOTS];
+static uint32_t s_measureClock = 0;
+static uint32_t s_measureHits = 0, s_measureMisses = 0;
+static uint32_t s_spriteHits = 0, s_spriteMisses = 0;
+
+// FNV-1a over the uppercased text
+static uint32_t _textHash(const char *text, MeasureMode mode) {
+  uint32_t h = 2166136261u ^ mode;
+  for (; *text; ++text) {
+    h ^= (uint8_t)toupper((unsigned char)*text);
+    h *= 16777619u;
+  }
+  return h;
 }
 
-void oled_drawBigText(const char *text, int16_t x_offset, int16_t y_offset, bool update, bool hasHeader) {
-    LOCK_OLED();
-    if (!s_available) { UNLOCK_OLED(); return; }
-    
-    // Convert to uppercase
-    String upperText = String(text);
-    upperText.toUpperCase();
-    const char* text_ptr = upperText.c_str();
+// Strategy:
+// 1. Try single line BIG (Logisoso20)
+// 2. Try two lines BIG (Logisoso20) (IF height allows)
+// 3. Try two lines MEDIUM (Profont15)
+// 4. Fallback: Scroll single line BIG (Logisoso20)
+// Scrolling text only tries 1 and 4.
+static void _fitText(TextMeasure &m) {
+  s_u8g2.setFont(u8g2_font_logisoso20_tf);
+  m.width = s_u8g2.getUTF8Width(m.upper.c_str());
+  if (m.width <= OLED_WIDTH - 4) { m.fit = FIT_ONE_BIG; return; }
+  m.fit = FIT_SCROLL;
+  if (m.mode == MEASURE_SCROLL) return;
+
+  // Find best split point (space near middle)
+  const String &s = m.upper;
+  int len = s.length();
+  int mid = len / 2;
+  int split = -1;
+  for (int i = 0; i < len / 2; i++) {
+    if (mid - i >= 0 && s[mid - i] == ' ') { split = mid - i; break; }
+    if (mid + i < len && s[mid + i] == ' ') { split = mid + i; break; }
+  }
+  // No space? split in the middle (allow word split)
+  if (split == -1) split = mid;
+  m.line1 = s.substring(0, split);
+  m.line2 = s.substring(split);
+  if (m.line2.startsWith(" ")) m.line2 = m.line2.substring(1);
+
+  // 2. Two Lines BIG
+  // Only attempt if NO header strings attached (Header takes 12px, leaving 52px.
+  // Two lines of Logisoso20 (height ~20-24) is > 40px, plus spacing. Too tight/clips.)
+  if (m.mode == MEASURE_BIG) {
+    m.w1 = s_u8g2.getUTF8Width(m.line1.c_str());
+    m.w2 = s_u8g2.getUTF8Width(m.line2.c_str());
+    if (m.w1 <= OLED_WIDTH - 2 && m.w2 <= OLED_WIDTH - 2) {
+      // Visual top of line 1 at offset 0; shifted down if it is off screen,
+      // which must not push the baseline of line 2 off the bottom
+      int16_t top = (OLED_HEIGHT / 2) - 11 - s_u8g2.getFontAscent();
+      if (top >= 0 || (OLED_HEIGHT / 2) + 13 - top <= OLED_HEIGHT) {
+        m.fit = FIT_TWO_BIG;
+        return;
+      }
+    }
+  }
 
-    // Strategy:
-    // 1. Try single line BIG (Logisoso20)
-    // 2. Try two lines BIG (Logisoso20) (IF height allows)
-    // 3. Try two lines MEDIUM (Profont15)
-    // 4. Fallback: Scroll single line BIG (Logisoso20)
+  // 3. Two Lines MEDIUM
+  s_u8g2.setFont(u8g2_font_profont15_tr);
+  m.w1 = s_u8g2.getUTF8Width(m.line1.c_str());
+  m.w2 = s_u8g2.getUTF8Width(m.line2.c_str());
+  if (m.w1 <= OLED_WIDTH - 4 && m.w2 <= OLED_WIDTH - 4) {
+    m.fit = FIT_TWO_MEDIUM;
+    return;
+  }
+  m.line1 = m.line2 = String();
+}
 
-    bool done = false;
+static const TextMeasure &_measureText(const char *text, MeasureMode mode) {
+  const uint32_t hash = _textHash(text, mode);
+  TextMeasure *m = &s_measures[0];
+  for (TextMeasure &c : s_measures) {
+    if (c.used && c.hash == hash && c.mode == mode && strcasecmp(c.upper.c_str(), text) == 0) {
+      c.lastUse = ++s_measureClock;
+      s_measureHits++;
+      return c;
+    }
+  }
+  // Least recently used slot
+  for (TextMeasure &c : s_measures) {
+    if (!c.used) { m = &c; break; }
+    if (c.lastUse < m->lastUse) m = &c;
+  }
+  s_measureMisses++;
+  m->used = true;
+  m->hash = hash;
+  m->mode = mode;
+  m->lastUse = ++s_measureClock;
+  m->upper = text;
+  m->upper.toUpperCase();
+  m->line1 = m->line2 = String();
+  m->w1 = m->w2 = 0;
+  _fitText(*m);
+  return *m;
+}
 
-    // 1. Single Line BIG
-    s_u8g2.setFont(u8g2_font_logisoso20_tf); 
-    int16_t w = s_u8g2.getUTF8Width(text_ptr);
+static void _drawOneBig(const TextMeasure &m, int16_t x_offset, int16_t y_offset) {
+  s_u8g2.setFont(u8g2_font_logisoso20_tf);
+  int16_t h_asc = s_u8g2.getFontAscent();
+  int16_t x = (OLED_WIDTH - m.width) / 2 + x_offset;
+  int16_t y = (OLED_HEIGHT / 2) + (h_asc / 2) + y_offset;
+  if (y > -44 && y < OLED_HEIGHT + 44) {
+    s_u8g2.setCursor(x, y);
+    s_u8g2.print(m.upper);
+  }
+}
 
-    if (w <= OLED_WIDTH - 4) {
-        // Fits!
-        int16_t h_asc = s_u8g2.getFontAscent();
-        int16_t x = (OLED_WIDTH - w) / 2 + x_offset;
-        int16_t y = (OLED_HEIGHT / 2) + (h_asc / 2) + y_offset;
-        if (y > -44 && y < OLED_HEIGHT + 44) {
-            s_u8g2.setCursor(x, y);
-            s_u8g2.print(text_ptr);
-        }
-        done = true;
-    } 
-
-    // Split logic helper
-    String s = upperText;
-    int split = -1;
-    if (!done) {
-        int len = s.length();
-        int mid = len / 2;
-        // Find best split point (space near middle)
-        for(int i=0; i < len/2; i++) {
-            if(mid-i >= 0 && s[mid-i] == ' ') { split = mid-i; break; }
-            if(mid+i < len && s[mid+i] == ' ') { split = mid+i; break; }
-        }
-        // No space? split in the middle (allow word split)
-        if(split == -1) split = mid;
-    }
+// Scroll single line BIG. Higher divisor = slower.
+static void _drawMarquee(const TextMeasure &m, int16_t x_offset, int16_t y_offset, uint32_t msPerPx) {
+  s_u8g2.setFont(u8g2_font_logisoso20_tf);
+  // Use a consistent time base (modulus)
+  // Scroll width = text width + screen width + gap
+  int16_t gap = 48;
+  int16_t total_scroll_w = m.width + OLED_WIDTH + gap;
+  int16_t offset = (millis() / msPerPx) % total_scroll_w;
+
+  int16_t x = OLED_WIDTH - offset + x_offset;
+  int16_t y = (OLED_HEIGHT / 2) + (s_u8g2.getFontAscent() / 2) + y_offset;
+  s_u8g2.setCursor(x, y);
+  s_u8g2.print(m.upper);
 
-    // 2. Two Lines BIG
-    // Only attempt if NO header strings attached (Header takes 12px, leaving 52px. 
-    // Two lines of Logisoso20 (height ~20-24) is > 40px, plus spacing. Too tight/clips.)
-    if (!done && !hasHeader) {
+  // Request persistent updates
+  s_needs_scroll_update = true;
+}
+
+// Returns false when the text had to scroll (time dependent, not cacheable)
+static bool _drawBigText(const char *text, int16_t x_offset, int16_t y_offset, bool hasHeader) {
+    const TextMeasure &m = _measureText(text, hasHeader ? MEASURE_BIG_HEADER : MEASURE_BIG);
+
+    switch (m.fit) {
+    case FIT_ONE_BIG:
+        _drawOneBig(m, x_offset, y_offset);
+        return true;
+
+    case FIT_TWO_BIG: {
         s_u8g2.setFont(u8g2_font_logisoso20_tf);
-        String s1 = s.substring(0, split);
-        String s2 = s.substring(split);
-        if(s2.startsWith(" ")) s2 = s2.substring(1);
-
-        int16_t w1 = s_u8g2.getUTF8Width(s1.c_str());
-        int16_t w2 = s_u8g2.getUTF8Width(s2.c_str());
-
-        // Check horizontal fit
-        if (w1 <= OLED_WIDTH - 2 && w2 <= OLED_WIDTH - 2) {
-            int16_t h_asc = s_u8g2.getFontAscent(); // ~20
-            
-            // Calculate vertical positions
-            int16_t y_center = (OLED_HEIGHT / 2) + y_offset;
-            int16_t y1 = y_center - 11; 
-            int16_t y2 = y_center + 13; 
-            
-            // Check for header collision (Safe Top = 14 if header present)
-            int16_t safe_top = hasHeader ? 14 : 0;
-            // Visual top implies baseline y1 - h_asc
-            int16_t current_top = y1 - h_asc;
-            
-            bool fits_vertically = true;
-            
-            if (current_top < safe_top) {
-                // Determine shift needed
-                int16_t shift = safe_top - current_top;
-                y1 += shift;
-                y2 += shift;
-                // Verify bottom clearance (baseline of line 2)
-                if (y2 > OLED_HEIGHT) { // Strict: if baseline goes offscreen
-                     fits_vertically = false;
-                }
-            }
-
-            if (fits_vertically) {
-                if (y1 > -44 && y1 < OLED_HEIGHT + 44) {
-                    int16_t x1 = (OLED_WIDTH - w1) / 2 + x_offset;
-                    s_u8g2.setCursor(x1, y1 + (h_asc/2)); s_u8g2.print(s1); // Using h_asc/2 offset to approximate baseline from center? Wait, y1 was center-based. With explicit baseline y1?
-                    // Correction: Original implementation setCursor(x, y1 + h_asc/2).
-                    // y1 defined as "center - 11". If center is 32, y1=21. +10 = 31.
-                    // If we shifted y1, we assume logic holds.
-                }
-                if (y2 > -44 && y2 < OLED_HEIGHT + 44) {
-                    int16_t x2 = (OLED_WIDTH - w2) / 2 + x_offset;
-                    s_u8g2.setCursor(x2, y2 + (h_asc/2)); s_u8g2.print(s2);
-                }
-                done = true;
-            }
+        int16_t h_asc = s_u8g2.getFontAscent(); // ~20
+        int16_t y_center = (OLED_HEIGHT / 2) + y_offset;
+        int16_t y1 = y_center - 11;
+        int16_t y2 = y_center + 13;
+        // Keep the visual top (baseline y1 - h_asc) on screen
+        int16_t current_top = y1 - h_asc;
+        if (current_top < 0) {
+            y1 -= current_top;
+            y2 -= current_top;
         }
+        if (y1 > -44 && y1 < OLED_HEIGHT + 44) {
+            int16_t x1 = (OLED_WIDTH - m.w1) / 2 + x_offset;
+            s_u8g2.setCursor(x1, y1 + (h_asc/2)); s_u8g2.print(m.line1);
+        }
+        if (y2 > -44 && y2 < OLED_HEIGHT + 44) {
+            int16_t x2 = (OLED_WIDTH - m.w2) / 2 + x_offset;
+            s_u8g2.setCursor(x2, y2 + (h_asc/2)); s_u8g2.print(m.line2);
+        }
+        return true;
     }
 
-    // 3. Two Lines MEDIUM
-    if (!done) {
+    case FIT_TWO_MEDIUM: {
         s_u8g2.setFont(u8g2_font_profont15_tr);
-        String s1 = s.substring(0, split);
-        String s2 = s.substring(split);
-        if(s2.startsWith(" ")) s2 = s2.substring(1);
+        int16_t h_asc = s_u8g2.getFontAscent();
+        int16_t x1 = (OLED_WIDTH - m.w1) / 2 + x_offset;
+        int16_t x2 = (OLED_WIDTH - m.w2) / 2 + x_offset;
+        int16_t y1 = (OLED_HEIGHT / 2) - 3 + y_offset;
+        int16_t y2 = (OLED_HEIGHT / 2) + h_asc + y_offset;
 
-        int16_t w1 = s_u8g2.getUTF8Width(s1.c_str());
-        int16_t w2 = s_u8g2.getUTF8Width(s2.c_str());
-        
-        if (w1 <= OLED_WIDTH - 4 && w2 <= OLED_WIDTH - 4) {
-            // Fits on 2 lines!
-            int16_t h_asc = s_u8g2.getFontAscent();
-            int16_t x1 = (OLED_WIDTH - w1) / 2 + x_offset;
-            int16_t x2 = (OLED_WIDTH - w2) / 2 + x_offset;
-            int16_t y1 = (OLED_HEIGHT / 2) - 3 + y_offset;
-            int16_t y2 = (OLED_HEIGHT / 2) + h_asc + y_offset;
-
-            if (y1 > -44 && y1 < OLED_HEIGHT + 44) {
-                s_u8g2.setCursor(x1, y1); s_u8g2.print(s1);
-            }
-            if (y2 > -44 && y2 < OLED_HEIGHT + 44) {
-                s_u8g2.setCursor(x2, y2); s_u8g2.print(s2);
-            }
-            done = true;
+        if (y1 > -44 && y1 < OLED_HEIGHT + 44) {
+            s_u8g2.setCursor(x1, y1); s_u8g2.print(m.line1);
         }
+        if (y2 > -44 && y2 < OLED_HEIGHT + 44) {
+            s_u8g2.setCursor(x2, y2); s_u8g2.print(m.line2);
+        }
+        return true;
     }
 
-    if (!done) {
-        // 4. Scroll Single Line BIG
-        s_u8g2.setFont(u8g2_font_logisoso20_tf);
-        w = s_u8g2.getUTF8Width(text_ptr);
-        
-        // Calculate scroll offset
-        // Speed: 30px per second?
-        uint32_t now = millis();
-        // Use a consistent time base (modulus)
-        // Scroll width = text width + screen width + gap
-        int16_t gap = 48;
-        int16_t total_scroll_w = w + OLED_WIDTH + gap;
-        int16_t offset = (now / 8) % total_scroll_w; // Higher divisor = slower
-        
-        int16_t x = OLED_WIDTH - offset + x_offset;
-        int16_t y = (OLED_HEIGHT / 2) + (s_u8g2.getFontAscent() / 2) + y_offset;
-        
-        s_u8g2.setCursor(x, y);
-        s_u8g2.print(text_ptr);
-        
-        // Request persistent updates
-        s_needs_scroll_update = true;
+    case FIT_SCROLL:
+        break;
     }
+    _drawMarquee(m, x_offset, y_offset, 8);
+    return false;
+}
 
-    if (update) s_oled.display();
-    UNLOCK_OLED();
+// Returns false when the text had to scroll (time dependent, not cacheable)
+static bool _drawScrollingText(const char *text, int16_t x_offset, int16_t y_offset) {
+    const TextMeasure &m = _measureText(text, MEASURE_SCROLL);
+    if (m.fit == FIT_ONE_BIG) {
+        _drawOneBig(m, x_offset, y_offset);
+        return true;
+    }
+    // Speed: 30px per second approx
+    _drawMarquee(m, x_offset, y_offset, 15);
+    return false;
 }
 
-void oled_drawScrollingText(const char *text, int16_t x_offset, int16_t y_offset, bool update) {
-    LOCK_OLED();
-    if (!s_available) { UNLOCK_OLED(); return; }
-    
-    // Convert to uppercase
-    String upperText = String(text);
-    upperText.toUpperCase();
-    const char* text_ptr = upperText.c_str();
+/* ---------- Sprite cache ----------
+ * Text blocks that only move during transitions (carousel / list items, the
+ * home clock) are rendered once into an off-screen canvas, cropped to the
+ * pages and columns they use, and then OR-ed into the frame at the animated
+ * offset. The key is the content itself, so a changed title or minute is a
+ * new sprite and the old one ages out of the LRU.
+ */
+#define OLED_SPRITE_SLOTS 4
+// Rows rendered above and below the screen for glyphs that overhang it
+#define OLED_SPRITE_MARGIN 16
+#define OLED_SPRITE_CANVAS_H (OLED_HEIGHT + 2 * OLED_SPRITE_MARGIN)
+
+enum SpriteKind : uint8_t { SPRITE_BIG_TEXT, SPRITE_SCROLL_TEXT, SPRITE_HOME };
+
+struct OledSprite {
+  bool used = false;
+  bool cacheable = true;     // false: scrolling text, drawn directly
+  SpriteKind kind;
+  uint8_t flags;             // hasHeader / wifiConnected
+  String text;
+  uint32_t lastUse = 0;
+  uint8_t x0 = 0, width = 0; // column range
+  uint8_t p0 = 0, pages = 0; // canvas page range
+  std::vector<uint8_t> bits; // pages * width, SSD1306 page layout
+};
+
+// Off-screen target in the SSD1306 page layout. Screen coordinates: row 0
+// lands OLED_SPRITE_MARGIN rows down, so content is laid out exactly as at
+// offset 0 on the screen.
+class SpriteCanvas : public Adafruit_GFX {
+public:
+  SpriteCanvas() : Adafruit_GFX(OLED_WIDTH, OLED_SPRITE_CANVAS_H) {}
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    y += OLED_SPRITE_MARGIN;
+    if (x < 0 || x >= OLED_WIDTH || y < 0 || y >= OLED_SPRITE_CANVAS_H) return;
+    uint8_t &b = buf[x + (y / 8) * OLED_WIDTH];
+    uint8_t m = 1 << (y & 7);
+    if (color == SSD1306_INVERSE) b ^= m;
+    else if (color) b |= m;
+    else b &= ~m;
+  }
+  uint8_t buf[OLED_WIDTH * OLED_SPRITE_CANVAS_H / 8];
+};
+
+static SpriteCanvas s_canvas;
+static OledSprite s_sprites[OLED_SPRITE_SLOTS];
+static uint32_t s_spriteClock = 0;
+
+static bool _renderContent(SpriteKind kind, const char *text, uint8_t flags, int16_t x_offset, int16_t y_offset) {
+  switch (kind) {
+    case SPRITE_BIG_TEXT: return _drawBigText(text, x_offset, y_offset, flags);
+    case SPRITE_SCROLL_TEXT: return _drawScrollingText(text, x_offset, y_offset);
+    case SPRITE_HOME: return _drawHomeScreen(text, flags, x_offset, y_offset);
+  }
+  return false;
+}
+
+static void _u8g2Target(Adafruit_GFX &gfx) {
+  s_u8g2.begin(gfx);
+  s_u8g2.setForegroundColor(SSD1306_WHITE);
+  s_u8g2.setBackgroundColor(SSD1306_BLACK);
+}
 
-    s_u8g2.setFont(u8g2_font_logisoso20_tf); 
-    int16_t w = s_u8g2.getUTF8Width(text_ptr);
+static OledSprite *_spriteRender(SpriteKind kind, const char *text, uint8_t flags) {
+  // Least recently used slot
+  OledSprite *sp = &s_sprites[0];
+  for (OledSprite &c : s_sprites) {
+    if (!c.used) { sp = &c; break; }
+    if (c.lastUse < sp->lastUse) sp = &c;
+  }
 
-    if (w <= OLED_WIDTH - 4) {
-        // Fits!
-        int16_t h_asc = s_u8g2.getFontAscent();
-        int16_t x = (OLED_WIDTH - w) / 2 + x_offset;
-        int16_t y = (OLED_HEIGHT / 2) + (h_asc / 2) + y_offset;
-        if (y > -44 && y < OLED_HEIGHT + 44) {
-            s_u8g2.setCursor(x, y);
-            s_u8g2.print(text_ptr);
-        }
-    } else {
-        // Scroll Single Line BIG
-        // Calculate scroll offset
-        // Speed: 30px per second approx
-        uint32_t now = millis();
-        // Use a consistent time base (modulus)
-        // Scroll width = text width + screen width + gap
-        int16_t gap = 48;
-        int16_t total_scroll_w = w + OLED_WIDTH + gap;
-        int16_t offset = (now / 15) % total_scroll_w; // Higher divisor = slower. 8 was very fast?
-        
-        int16_t x = OLED_WIDTH - offset + x_offset;
-        int16_t y = (OLED_HEIGHT / 2) + (s_u8g2.getFontAscent() / 2) + y_offset;
-        
-        s_u8g2.setCursor(x, y);
-        s_u8g2.print(text_ptr);
-        
-        // Request persistent updates
-        s_needs_scroll_update = true;
+  memset(s_canvas.buf, 0, sizeof(s_canvas.buf));
+  _u8g2Target(s_canvas);
+  bool cacheable = _renderContent(kind, text, flags, 0, 0);
+  _u8g2Target(s_oled);
+
+  sp->used = true;
+  sp->kind = kind;
+  sp->flags = flags;
+  sp->text = text;
+  sp->cacheable = cacheable;
+  sp->pages = sp->width = 0;
+  sp->bits.clear();
+  if (!cacheable) return sp;
+
+  // Crop to the used pages / columns
+  int x0 = OLED_WIDTH, x1 = -1, p0 = OLED_SPRITE_CANVAS_H / 8, p1 = -1;
+  for (int p = 0; p < OLED_SPRITE_CANVAS_H / 8; ++p) {
+    for (int x = 0; x < OLED_WIDTH; ++x) {
+      if (!s_canvas.buf[p * OLED_WIDTH + x]) continue;
+      if (x < x0) x0 = x;
+      if (x > x1) x1 = x;
+      if (p < p0) p0 = p;
+      p1 = p;
     }
+  }
+  if (x1 < 0) return sp; // nothing drawn
+
+  sp->x0 = x0;
+  sp->width = x1 - x0 + 1;
+  sp->p0 = p0;
+  sp->pages = p1 - p0 + 1;
+  sp->bits.resize(sp->pages * sp->width);
+  for (int p = 0; p < sp->pages; ++p) {
+    memcpy(&sp->bits[p * sp->width], &s_canvas.buf[(p0 + p) * OLED_WIDTH + x0], sp->width);
+  }
+  return sp;
+}
 
-    if (update) s_oled.display();
-    UNLOCK_OLED();
+// OR the sprite into the frame buffer, shifted by (x_offset, y_offset)
+static void _spriteBlit(const OledSprite &sp, int16_t x_offset, int16_t y_offset) {
+  uint8_t *buf = s_oled.getBuffer();
+  // Screen row of the sprite's first page
+  const int top = sp.p0 * 8 - OLED_SPRITE_MARGIN + y_offset;
+  const int shift = ((top % 8) + 8) % 8;
+  const int page0 = (top - shift) / 8;
+
+  int x0 = sp.x0 + x_offset, c0 = 0, n = sp.width;
+  if (x0 < 0) { c0 = -x0; n -= c0; x0 = 0; }
+  if (x0 + n > OLED_WIDTH) n = OLED_WIDTH - x0;
+  if (n <= 0) return;
+
+  for (int p = 0; p < sp.pages; ++p) {
+    const uint8_t *src = &sp.bits[p * sp.width + c0];
+    const int dst = page0 + p;
+    if (dst >= 0 && dst < OLED_HEIGHT / 8) {
+      uint8_t *row = buf + dst * OLED_WIDTH + x0;
+      for (int i = 0; i < n; ++i) row[i] |= src[i] << shift;
+    }
+    if (shift && dst + 1 >= 0 && dst + 1 < OLED_HEIGHT / 8) {
+      uint8_t *row = buf + (dst + 1) * OLED_WIDTH + x0;
+      for (int i = 0; i < n; ++i) row[i] |= src[i] >> (8 - shift);
+    }
+  }
+}
+
+// Draw from the cache (rendering on a miss); direct draw for scrolling text
+static void _drawCached(SpriteKind kind, const char *text, uint8_t flags, int16_t x_offset, int16_t y_offset) {
+  OledSprite *sp = NULL;
+  for (OledSprite &c : s_sprites) {
+    if (c.used && c.kind == kind && c.flags == flags && c.text == text) { sp = &c; break; }
+  }
+  if (sp) s_spriteHits++;
+  else {
+    s_spriteMisses++;
+    sp = _spriteRender(kind, text, flags);
+  }
+  sp->lastUse = ++s_spriteClock;
+
+  if (sp->cacheable) _spriteBlit(*sp, x_offset, y_offset);
+  else _renderContent(kind, text, flags, x_offset, y_offset);
+}
+
+void oled_drawHomeScreen(const char *time, bool wifiConnected, int16_t x_offset, int16_t y_offset, bool update) {
+  LOCK_OLED();
+  if (!s_available) { UNLOCK_OLED(); return; }
+  _drawCached(SPRITE_HOME, time, wifiConnected, x_offset, y_offset);
+  if (update) _flush();
+  UNLOCK_OLED();
+}
+
+void oled_drawBigText(const char *text, int16_t x_offset, int16_t y_offset, bool update, bool hasHeader) {
+  LOCK_OLED();
+  if (!s_available) { UNLOCK_OLED(); return; }
+  _drawCached(SPRITE_BIG_TEXT, text, hasHeader, x_offset, y_offset);
+  if (update) _flush();
+  UNLOCK_OLED();
+}
+
+void oled_drawScrollingText(const char *text, int16_t x_offset, int16_t y_offset, bool update) {
+  LOCK_OLED();
+  if (!s_available) { UNLOCK_OLED(); return; }
+  _drawCached(SPRITE_SCROLL_TEXT, text, 0, x_offset, y_offset);
+  if (update) _flush();
+  UNLOCK_OLED();
+}
+
+void oled_getCacheStats(OledCacheStats &out) {
+  LOCK_OLED();
+  out.spriteHits = s_spriteHits;
+  out.spriteMisses = s_spriteMisses;
+  out.measureHits = s_measureHits;
+  out.measureMisses = s_measureMisses;
+  UNLOCK_OLED();
 }
 
 void oled_drawHeader(const char *title, int16_t x_offset, int16_t y_offset) {
@@ -442,14 +738,14 @@ void oled_drawHeader(const char *title, int16_t x_offset, int16_t y_offset) {
     UNLOCK_OLED();
 }
 
-void oled_drawScrollProgress(float progress) {
+void oled_drawScrollProgress(int32_t progress) {
     LOCK_OLED();
     if (!s_available) { UNLOCK_OLED(); return; }
     
-    if (progress < 0.0f) progress = 0.0f;
-    if (progress > 1.0f) progress = 1.0f;
+    if (progress < 0) progress = 0;
+    if (progress > 65536) progress = 65536;
 
-    int16_t h = (int16_t)(progress * (float)OLED_HEIGHT);
+    int16_t h = (int16_t)((progress * OLED_HEIGHT) >> 16);
     if (h > 0) {
         s_oled.fillRect(0, 0, 1, h, SSD1306_WHITE);
     }
@@ -572,7 +868,7 @@ void oled_drawText(const char *text, int16_t x, int16_t y) {
     UNLOCK_OLED();
 }
 
-void oled_showHoldToast(ToastPos pos, ToastIcon icon, float progress) {
+void oled_showHoldToast(ToastPos pos, ToastIcon icon, q16_t progress) {
     LOCK_OLED();
     s_toast_msg = "";
     s_toast_pos = pos;
@@ -594,17 +890,16 @@ void oled_drawActiveToast(void) {
   if (s_toast_manual) {
       // Manual toasts (e.g. hold-to-confirm progress)
       // Start slow and accelerate as progress completes (Ease-In)
-      float ease_p = 1.0f - (s_toast_progress * s_toast_progress);
-      offset_x = (int16_t)(ease_p * 128.0f);
+      q16_t eased = anim_ease(ANIM_EASE_IN_QUAD, s_toast_progress);
+      offset_x = (int16_t)q16_mulInt(Q16_ONE - eased, 128);
   } else {
       const uint32_t anim_dur = 250;
       uint32_t remaining = s_toast_until > now ? s_toast_until - now : 0;
       
       if (remaining < anim_dur) {
           // Exit animation: starts slow, accelerates to off-screen (Ease-In)
-          float t = 1.0f - ((float)remaining / anim_dur);
-          float p = t * t;
-          offset_y = (int16_t)(p * 24.0f);
+          q16_t t = Q16_ONE - q16_div((int32_t)remaining, (int32_t)anim_dur);
+          offset_y = (int16_t)q16_mulInt(anim_ease(ANIM_EASE_IN_QUAD, t), 24);
           if (s_toast_pos == TOAST_TOP) offset_y = -offset_y;
       }
   }
@@ -646,3 +941,21 @@ bool oled_poll(void) {
   return redraw; 
 }
 
+uint32_t oled_msUntilUpdate(void) {
+  LOCK_OLED();
+  uint32_t left = UINT32_MAX;
+  if (s_available) {
+    // Same timing as oled_poll()
+    const uint32_t anim_dur = 250;
+    uint32_t now = millis();
+    if (s_needs_scroll_update || s_toast_manual) {
+      left = 0;
+    } else if (s_toast_until > 0) {
+      if (now - s_toast_start < anim_dur || now + anim_dur >= s_toast_until) left = 0;
+      else left = s_toast_until - anim_dur - now;
+    }
+  }
+  UNLOCK_OLED();
+  return left;
+}
+
@@ -19,6 +19,7 @@
 
 #include <Arduino.h>
 #include <stdint.h>
+#include "utils/anim.h"
 
 
 
@@ -47,6 +48,21 @@ void oled_init(uint8_t sda = OLED_DEFAULT_SDA,
  */
 bool oled_isAvailable(void);
 
+/**
+ * oled_setPower
+ * Switch the panel on/off (charge pump and pixels). The buffer is kept;
+ * oled_init() also switches it back on.
+ */
+void oled_setPower(bool on);
+
+/**
+ * oled_readRow
+ * Copy row `y` of the frame buffer to `out` (OLED_WIDTH / 8 bytes, MSB first,
+ * bit set = lit pixel). This is the buffer being drawn, which matches the
+ * screen between frames. All clear when the OLED is not available.
+ */
+void oled_readRow(int16_t y, uint8_t *out);
+
 /**
  * oled_clear
  * Clear the screen (fill with white).
@@ -61,7 +77,9 @@ void oled_clearBuffer(void);
 
 /**
  * oled_display
- * Send the current buffer to the display.
+ * Send the current buffer to the display. Only the column runs that changed
+ * since the last flush are transferred, so a redraw that touches a toast or
+ * a progress bar costs a fraction of the full 1 KB.
  */
 void oled_display(void);
 
@@ -131,6 +149,18 @@ void oled_drawBigText(const char *text, int16_t x_offset = 0, int16_t y_offset =
  */
 void oled_drawScrollingText(const char *text, int16_t x_offset = 0, int16_t y_offset = 0, bool update = true);
 
+/**
+ * oled_getCacheStats
+ * Hit / miss counts (since boot) of the rendered text sprites and of the
+ * font / line-split measurements behind oled_drawBigText and
+ * oled_drawScrollingText, for /status.
+ */
+struct OledCacheStats {
+  uint32_t spriteHits, spriteMisses;
+  uint32_t measureHits, measureMisses;
+};
+void oled_getCacheStats(OledCacheStats &out);
+
 enum ToastPos { TOAST_TOP, TOAST_BOTTOM };
 enum ToastIcon { TOAST_ICON_NONE, TOAST_ICON_UP, TOAST_ICON_DOWN, TOAST_ICON_SELECT, TOAST_ICON_BACK };
 
@@ -165,19 +195,19 @@ void oled_drawHeader(const char *title, int16_t x_offset = 0, int16_t y_offset =
 /**
  * oled_drawScrollProgress
  * Draw a vertical progress bar on the left (2px wide).
- * - progress: 0.0 to 1.0
+ * - progress: 0 to 65536 (Q16 fixed point, 1.0 = 65536)
  */
-void oled_drawScrollProgress(float progress);
+void oled_drawScrollProgress(int32_t progress);
 
 /**
  * oled_showHoldToast
- * Show a toast that slides based on a manual progress value (0.0 to 1.0).
+ * Show a toast that slides based on a manual progress value (Q16, 0 to Q16_ONE).
  * Useful for long-press feedback.
  * - pos: vertical position
  * - icon: icon to show
- * - progress: 0.0 (off-screen) to 1.0 (fully in)
+ * - progress: 0 (off-screen) to Q16_ONE (fully in)
  */
-void oled_showHoldToast(ToastPos pos, ToastIcon icon, float progress);
+void oled_showHoldToast(ToastPos pos, ToastIcon icon, q16_t progress);
 
 /**
  * oled_drawActiveToast
@@ -192,3 +222,11 @@ void oled_drawActiveToast(void);
  * Returns true if the display needs a redraw because a toast changed state (e.g. vanished).
  */
 bool oled_poll(void);
+
+/**
+ * oled_msUntilUpdate
+ * Milliseconds until oled_poll() will next want a redraw: 0 while a toast
+ * slides or text scrolls, the time to the toast's exit otherwise, UINT32_MAX
+ * when nothing is pending. For callers that want to sleep until then.
+ */
+uint32_t oled_msUntilUpdate(void);
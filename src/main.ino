@@ -9,6 +9,8 @@
 #include "drivers/epaper/display.h"
 #include "app/wifi/wifi.h"
 #include "app/server/server.h"
+#include "app/power/power.h"
+#include "utils/task_stats.h"
 
 // Apps
 #include "app/registry.h"
@@ -26,9 +28,51 @@ extern const App APP_HA_LIST; // Defined in src/app/ha_list/app.cpp
 #include "app/controls/controls.h"
 #include "app/ui/ui.h"
 
+static bool s_networkUp = false;
+
+// WiFi + HTTP server. Deferred after a deep-sleep wake into the reader so
+// the page turn does not wait for the connection.
+static void startNetwork() {
+  connectWiFi();
+  server_init();
+  power_setRadioOn(true);
+  s_networkUp = true;
+}
+
+// Idle governor deadlines (see app/power)
+static uint32_t epdDeadline() {
+  return epd_isBusy() ? 0 : UINT32_MAX;
+}
+
+// HTTP clients are polled; the network comes up once the reader is left
+static uint32_t httpDeadline() {
+  if (s_networkUp) return server_msUntilPoll();
+  return EpubApp::isReading() ? UINT32_MAX : 0;
+}
+
+// Filled in right before deep sleep (see app/power)
+static void saveResumeState(PowerResumeState &state) {
+  state.appIndex = ui_getIndex();
+  state.view = POWER_VIEW_CAROUSEL;
+  EpubApp::saveResumeState(state);
+}
+
+// Restore the UI saved before sleeping; Prev / Next wakes turn the page
+static void resumeUi() {
+  const PowerResumeState &state = power_resumeState();
+  if (!EpubApp::resume(state)) {
+    ui_restoreApp(state.appIndex, NULL);
+    return;
+  }
+  int pin = power_wakePin();
+  if (pin == PIN_BUTTON_NEXT) ui_next();
+  else if (pin == PIN_BUTTON_PREV) ui_prev();
+}
+
 void setup() {
   Serial.begin(115200);
-  delay(100);
+  power_init();
+  if (!power_isResume()) delay(100);
 
   // Initialize controls (buttons): pins are defined in src/config.h
   controls_init(PIN_BUTTON_PREV, PIN_BUTTON_NEXT, PIN_BUTTON_CONFIRM);
@@ -36,9 +80,6 @@ void setup() {
   // Initialize display hardware
   epd_init();
 
-  // Connect to WiFi
-  connectWiFi();
-
   // Mount LittleFS
   if (LittleFS.begin()) {
     Serial.println("LittleFS mounted");
@@ -57,28 +98,43 @@ void setup() {
   // Run App Setups (e.g. Beszel init)
   AppRegistry::setupAll();
 
-  // Start HTTP server (will register routes from all apps)
-  server_init();
-
   // Initialize UI
   ui_init();
+  power_setSaveCallback(saveResumeState);
+  power_addDeadline(ui_msUntilNextFrame);
+  power_addDeadline(AppRegistry::msUntilDispatch);
+  power_addDeadline(epdDeadline);
+  power_addDeadline(httpDeadline);
+
+  // Connect to WiFi and start the HTTP server (routes from all apps), unless
+  // we woke up to turn a page
+  if (power_isResume()) resumeUi();
+  else startNetwork();
 
   Serial.println("Setup complete");
 }
 
 void loop() {
-  // Handle HTTP requests
-  server_handleClient();
+  uint32_t loopStart = micros();
 
-  // Poll buttons
-  controls_poll();
+  // Handle HTTP requests (network comes up once the reader is left after a wake)
+  if (s_networkUp) server_handleClient();
+  else if (!EpubApp::isReading()) startNetwork();
 
-  // Poll UI
+  // The current view's poll (buttons and animations run in the UI task)
   ui_poll();
-  
-  // Poll Apps (background tasks)
-  AppRegistry::pollAll();
+
+  // App events: network up / down, clock synced, timer ticks
+  AppRegistry::dispatch();
 
   // Run display jobs
   epd_runBackgroundJobs();
+
+  // Deep sleep once idle (if enabled)
+  power_poll();
+
+  task_stats_add(TASK_STAT_LOOP, micros() - loopStart);
+
+  // Nothing due: wait or light sleep until the next deadline
+  power_idle();
 }
@@ -0,0 +1,179 @@
+/*
+  sim_main.cpp
+
+  Entry point of the host simulator (`pio run -e native -t exec`).
+
+  Queues a fixed set of e-paper jobs through the normal epd_* API, waits for
+  the EPD task to run each one, then writes the resulting panel frame as
+  PNG + PBM and prints where the job's time went (see stats.h). The OLED is
+  dumped at the end.
+
+  Usage: program [output dir]   (default .pio/sim/out)
+  Environment:
+    SIM_TIMING=<scale>  model panel refresh / SPI time (1 = real durations)
+    SIM_FS_ROOT=<dir>   host directory used as LittleFS (wallpaper.bin)
+
+  Raster times are host CPU times: compare them between builds, not with
+  the device.
+*/
+
+#if defined(SIM_NATIVE) && !defined(PIO_UNIT_TESTING)
+
+#include <Arduino.h>
+#include <GxEPD2.h>
+#include <sim.h>
+#include <sys/stat.h>
+
+#include "drivers/epaper/display.h"
+#include "drivers/epaper/layout.h"
+#include "drivers/epaper/stats.h"
+#include "drivers/oled/oled.h"
+#include "utils/rle.h"
+
+static uint32_t _jobsDone(void) {
+  EpdStatsSummary s;
+  epd_stats_summary(s);
+  return s.jobs;
+}
+
+// Block until `count` jobs have finished (the queue alone can look idle
+// while the task is between receiving a job and flagging itself busy).
+static bool _waitJobs(uint32_t count, uint32_t timeoutMs = 60000) {
+  uint32_t start = millis();
+  while (_jobsDone() < count) {
+    if (millis() - start > timeoutMs) return false;
+    delay(1);
+  }
+  return true;
+}
+
+static void _dump(const char *dir, const char *name, const SimImage &img) {
+  char path[256];
+  snprintf(path, sizeof(path), "%s/%s.png", dir, name);
+  sim_writePng(path, img);
+  snprintf(path, sizeof(path), "%s/%s.pbm", dir, name);
+  sim_writePbm(path, img);
+}
+
+static void _printJob(const char *name) {
+  EpdJobStats job;
+  if (epd_stats_recent(&job, 1) == 0) return;
+  Serial.printf("%-16s %-10s %-7s", name, job.type, job.partial ? "partial" : "full");
+  for (int p = EPD_PHASE_QUEUE; p < EPD_PHASE_COUNT; ++p) {
+    Serial.printf(" %9.3f", job.us[p] / 1000.0);
+  }
+  Serial.println();
+}
+
+// 96x96 test card: border, diagonal and a filled circle
+static std::vector<uint8_t> _testCard(int w, int h) {
+  const int stride = (w + 7) / 8;
+  std::vector<uint8_t> data(stride * h, 0);
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      int dx = x - w / 2;
+      int dy = y - h / 2;
+      bool ink = x < 2 || y < 2 || x >= w - 2 || y >= h - 2 || x == y ||
+                 dx * dx + dy * dy <= (w / 4) * (w / 4);
+      if (ink) data[y * stride + x / 8] |= 0x80 >> (x & 7);
+    }
+  }
+  return data;
+}
+
+// Four vertical bands of increasing gray ("g4", 2 bpp)
+static std::vector<uint8_t> _grayBands(int w, int h) {
+  const int stride = (w + 3) / 4;
+  std::vector<uint8_t> data(stride * h, 0);
+  for (int y = 0; y < h; ++y) {
+    uint8_t level = (uint8_t)(y * 4 / h);
+    for (int x = 0; x < w; ++x) {
+      data[y * stride + x / 4] |= level << (6 - 2 * (x & 3));
+    }
+  }
+  return data;
+}
+
+static EpdPage _samplePage(void) {
+  EpdPage page;
+  page.title = "Server";
+  page.components.push_back({EPD_COMP_HEADER, "System", "", 0, 0});
+  page.components.push_back({EPD_COMP_ROW, "Uptime", "12d 4h", 0, 0});
+  page.components.push_back({EPD_COMP_ROW, "Load", "0.42", 0, 0});
+  page.components.push_back({EPD_COMP_SEPARATOR, "", "", 0, 0});
+  page.components.push_back({EPD_COMP_PROGRESS, "CPU", "37%", 37, 0});
+  page.components.push_back({EPD_COMP_PROGRESS, "MEM", "81%", 81, 0});
+  page.components.push_back({EPD_COMP_PROGRESS, "DISK", "55%", 55, 0});
+  return page;
+}
+
+int main(int argc, char **argv) {
+  const char *outDir = argc > 1 ? argv[1] : ".pio/sim/out";
+  mkdir(".pio", 0755);
+  mkdir(".pio/sim", 0755);
+  mkdir(outDir, 0755);
+
+  const char *timing = getenv("SIM_TIMING");
+  if (timing) sim_setTimingScale(atof(timing));
+
+  epd_init();
+  oled_setMenuMode(false);
+  epd_setSourceTag("sim");
+
+  Serial.printf("%-16s %-10s %-7s %9s %9s %9s %9s %9s  (ms)\n", "frame", "job", "refresh",
+                epd_stats_phaseName(EPD_PHASE_QUEUE), epd_stats_phaseName(EPD_PHASE_RASTER),
+                epd_stats_phaseName(EPD_PHASE_TRANSFER), epd_stats_phaseName(EPD_PHASE_BUSY),
+                epd_stats_phaseName(EPD_PHASE_TOTAL));
+
+  uint32_t jobs = 0;
+  auto step = [&](const char *name, bool queued) {
+    if (!queued) {
+      Serial.printf("%-16s rejected\n", name);
+      return;
+    }
+    if (!_waitJobs(++jobs)) {
+      Serial.printf("%-16s timed out\n", name);
+      exit(1);
+    }
+    _dump(outDir, name, sim_epd_frame());
+    _printJob(name);
+  };
+
+  epd_clear();
+  step("01_clear", true);
+
+  epd_displayText("Hello API", GxEPD_BLACK, true);
+  step("02_text", true);
+
+  epd_displayPage(_samplePage());
+  step("03_page", true);
+
+  std::vector<uint8_t> card = _testCard(96, 96);
+  step("04_image_bw", epd_drawImageFromBitplanes(96, 96, card, "bw", "black", true));
+
+  std::vector<uint8_t> packed;
+  rle_encode(card.data(), card.size(), packed);
+  step("05_image_rle", epd_drawImageFromBitplanes(96, 96, packed, "rle", "black", true));
+
+  step("06_gray", epd_drawImageFromBitplanes(128, 296, _grayBands(128, 296), "g4", "black", true));
+
+  time_t day = 1767225600; // 2026-01-01 00:00 UTC
+  epd_displayWallpaper(day);
+  step("07_wallpaper", true);
+
+  epd_displayDate(day + 86400);
+  step("08_date", true);
+
+  _dump(outDir, "oled_status", sim_oled_frame());
+  oled_setMenuMode(true);
+  oled_drawHomeScreen("12:34", true);
+  _dump(outDir, "oled_home", sim_oled_frame());
+
+  SimEpdCounters c = sim_epd_counters();
+  Serial.printf("\nrefreshes: %u full, %u partial, %u gray; %u bytes to controller RAM\n",
+                c.fullRefreshes, c.partialRefreshes, c.grayRefreshes, c.bytesWritten);
+  Serial.printf("frames written to %s\n", outDir);
+  return 0;
+}
+
+#endif // SIM_NATIVE && !PIO_UNIT_TESTING
@@ -0,0 +1,137 @@
+/*
+ * anim.cpp
+ *
+ * Q16 animation engine (see anim.h).
+ */
+
+#include "anim.h"
+
+#include <string.h>
+
+static anim_prop_t *s_props[ANIM_MAX_PROPS];
+static int s_count = 0;
+static uint32_t s_backlogUs = 0;
+
+static inline q16_t _abs(q16_t v) { return v < 0 ? -v : v; }
+
+void anim_spring(anim_prop_t *p, q16_t k, q16_t d, q16_t settle) {
+  memset(p, 0, sizeof(*p));
+  p->mode = ANIM_SPRING;
+  p->k = k;
+  p->d = d;
+  p->settle = settle;
+}
+
+void anim_approach(anim_prop_t *p, q16_t rate, q16_t settle) {
+  memset(p, 0, sizeof(*p));
+  p->mode = ANIM_APPROACH;
+  p->rate = rate;
+  p->settle = settle;
+}
+
+bool anim_register(anim_prop_t *p) {
+  for (int i = 0; i < s_count; ++i) {
+    if (s_props[i] == p) return true;
+  }
+  if (s_count >= ANIM_MAX_PROPS) return false;
+  s_props[s_count++] = p;
+  return true;
+}
+
+void anim_set(anim_prop_t *p, q16_t value) {
+  p->value = value;
+  p->velocity = 0;
+  if (p->mode == ANIM_TWEEN) p->elapsedUs = p->durationUs;
+}
+
+void anim_reset(anim_prop_t *p, q16_t value) {
+  p->target = value;
+  anim_set(p, value);
+}
+
+void anim_tween(anim_prop_t *p, q16_t target, uint32_t durationMs, anim_curve_t curve) {
+  p->mode = ANIM_TWEEN;
+  p->from = p->value;
+  p->target = target;
+  p->velocity = 0;
+  p->curve = curve;
+  p->durationUs = durationMs * 1000;
+  p->elapsedUs = 0;
+}
+
+q16_t anim_ease(anim_curve_t curve, q16_t t) {
+  if (t <= 0) return 0;
+  if (t >= Q16_ONE) return Q16_ONE;
+  const q16_t u = Q16_ONE - t;
+  switch (curve) {
+    case ANIM_LINEAR: return t;
+    case ANIM_EASE_IN_QUAD: return q16_mul(t, t);
+    case ANIM_EASE_OUT_QUAD: return Q16_ONE - q16_mul(u, u);
+    case ANIM_EASE_OUT_CUBIC: return Q16_ONE - q16_mul(q16_mul(u, u), u);
+    case ANIM_EASE_IN_OUT_CUBIC:
+      if (t < Q16_ONE / 2) return 4 * q16_mul(q16_mul(t, t), t);
+      return Q16_ONE - 4 * q16_mul(q16_mul(u, u), u);
+  }
+  return t;
+}
+
+// One ANIM_STEP_US step. Returns true if the value changed.
+static bool _stepProp(anim_prop_t *p) {
+  const q16_t before = p->value;
+
+  switch (p->mode) {
+    case ANIM_SPRING: {
+      q16_t offset = p->value - p->target;
+      if (_abs(offset) <= p->settle && _abs(p->velocity) <= p->settle) {
+        p->value = p->target;
+        p->velocity = 0;
+        break;
+      }
+      p->velocity -= q16_mul(p->k, offset);
+      p->velocity = q16_mul(p->velocity, p->d);
+      p->value += p->velocity;
+      offset = p->value - p->target;
+      if (_abs(offset) <= p->settle && _abs(p->velocity) <= p->settle) {
+        p->value = p->target;
+        p->velocity = 0;
+      }
+      break;
+    }
+    case ANIM_APPROACH: {
+      q16_t gap = p->target - p->value;
+      if (_abs(gap) <= p->settle) p->value = p->target;
+      else p->value += q16_mul(gap, p->rate);
+      break;
+    }
+    case ANIM_TWEEN: {
+      if (p->elapsedUs >= p->durationUs) {
+        p->value = p->target;
+        break;
+      }
+      p->elapsedUs += ANIM_STEP_US;
+      if (p->elapsedUs >= p->durationUs) {
+        p->value = p->target;
+        break;
+      }
+      q16_t t = q16_div((int32_t)p->elapsedUs, (int32_t)p->durationUs);
+      p->value = p->from + q16_mul(p->target - p->from, anim_ease(p->curve, t));
+      break;
+    }
+  }
+  return p->value != before;
+}
+
+bool anim_step(uint32_t elapsedUs) {
+  s_backlogUs += elapsedUs;
+  bool moved = false;
+  int steps = 0;
+  while (s_backlogUs >= ANIM_STEP_US && steps++ < ANIM_MAX_CATCHUP) {
+    s_backlogUs -= ANIM_STEP_US;
+    for (int i = 0; i < s_count; ++i) {
+      if (_stepProp(s_props[i])) moved = true;
+    }
+  }
+  // Skip what is left of a long stall, keeping the phase
+  s_backlogUs %= ANIM_STEP_US;
+  return moved;
+}
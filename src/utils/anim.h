@@ -0,0 +1,99 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstdint>
+
+/*
+ * anim.h
+ *
+ * Fixed-point animation engine for UI transitions.
+ *
+ * Values are Q16 (16.16 fixed point, 1.0 = Q16_ONE). Each animated property
+ * is an anim_prop_t registered once; anim_step() advances all of them by the
+ * elapsed time in microseconds, in fixed ANIM_STEP_US steps, so motion is
+ * the same at any frame rate and bit-identical on both boards (no FPU on the
+ * C6: nothing in here touches floating point).
+ *
+ * Modes:
+ *  - spring : damped spring towards `target` (stiffness k, damping d per step)
+ *  - approach: exponential approach, a fraction `rate` of the gap per step
+ *  - tween  : eased move to `target` over a fixed duration
+ */
+
+typedef int32_t q16_t;
+
+#define Q16_ONE 65536
+// Compile-time constants only (the float is folded away)
+#define Q16_CONST(x) ((q16_t)((x) * 65536.0 + ((x) < 0 ? -0.5 : 0.5)))
+
+// Step the physics constants were tuned for; a late frame runs several
+#define ANIM_STEP_US 20000
+// Steps made up after a stall; longer stalls skip ahead
+#define ANIM_MAX_CATCHUP 10
+#define ANIM_MAX_PROPS 8
+
+enum anim_mode_t { ANIM_SPRING, ANIM_APPROACH, ANIM_TWEEN };
+
+enum anim_curve_t {
+  ANIM_LINEAR,
+  ANIM_EASE_IN_QUAD,
+  ANIM_EASE_OUT_QUAD,
+  ANIM_EASE_OUT_CUBIC,
+  ANIM_EASE_IN_OUT_CUBIC
+};
+
+struct anim_prop_t {
+  anim_mode_t mode;
+  q16_t value;
+  q16_t target;
+  q16_t velocity;   // spring
+  q16_t k;          // spring: stiffness
+  q16_t d;          // spring: velocity kept per step
+  q16_t rate;       // approach: fraction of the gap per step
+  q16_t settle;     // snap to the target when this close (and slow)
+  // tween
+  anim_curve_t curve;
+  q16_t from;
+  uint32_t durationUs;
+  uint32_t elapsedUs;
+};
+
+// Property setup (value = target = 0, not moving)
+void anim_spring(anim_prop_t *p, q16_t k, q16_t d, q16_t settle);
+void anim_approach(anim_prop_t *p, q16_t rate, q16_t settle);
+
+// Add `p` to the set advanced by anim_step(). False when the set is full.
+bool anim_register(anim_prop_t *p);
+
+// Jump to `value` and stop (target unchanged)
+void anim_set(anim_prop_t *p, q16_t value);
+// Jump to `value`, target too, and stop
+void anim_reset(anim_prop_t *p, q16_t value);
+// Move towards `target` (spring / approach)
+inline void anim_setTarget(anim_prop_t *p, q16_t target) { p->target = target; }
+// Ease from the current value to `target` over `durationMs`
+void anim_tween(anim_prop_t *p, q16_t target, uint32_t durationMs, anim_curve_t curve);
+
+inline bool anim_isMoving(const anim_prop_t *p) {
+  return p->value != p->target || p->velocity != 0;
+}
+
+// Advance every registered property by `elapsedUs`. Returns true if any moved.
+bool anim_step(uint32_t elapsedUs);
+
+// Easing curve at t (0..Q16_ONE)
+q16_t anim_ease(anim_curve_t curve, q16_t t);
+
+// value * n, truncated towards zero (e.g. an offset in pixels)
+inline int32_t q16_mulInt(q16_t value, int32_t n) {
+  return (int32_t)(((int64_t)value * n) / Q16_ONE);
+}
+
+inline q16_t q16_mul(q16_t a, q16_t b) {
+  return (q16_t)(((int64_t)a * b) >> 16);
+}
+
+// num / den as Q16 (den > 0)
+inline q16_t q16_div(int32_t num, int32_t den) {
+  return (q16_t)(((int64_t)num << 16) / den);
+}
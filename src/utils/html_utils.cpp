@@ -1,4 +1,6 @@
 #include "html_utils.h"
+#include <ctype.h>
+#include <string.h>
 
 String html_decode_entities(const String& str) {
     String result = str;
@@ -66,6 +68,27 @@ String html_strip_tags(const String& html) {
     return html_decode_entities(result);
 }
 
+// True if the tag starting after '<' at `p` breaks the text flow (opening or
+// closing block-level tag, or <br>)
+static bool _isBlockTag(const char* p, const char* end) {
+    static const char* const kBlockTags[] = {
+        "p", "br", "div", "li", "tr", "hr", "blockquote", "section",
+        "h1", "h2", "h3", "h4", "h5", "h6"
+    };
+    if (p < end && *p == '/') p++;
+    char name[12];
+    size_t n = 0;
+    while (p < end && n < sizeof(name) - 1 && isalnum((unsigned char)*p)) {
+        name[n++] = (char)tolower((unsigned char)*p++);
+    }
+    name[n] = 0;
+    if (n == 0 || (p < end && isalnum((unsigned char)*p))) return false;
+    for (const char* tag : kBlockTags) {
+        if (strcmp(name, tag) == 0) return true;
+    }
+    return false;
+}
+
 void html_strip_tags_inplace(char* buffer, size_t length) {
     if (!buffer || length == 0) return;
     
@@ -76,6 +99,7 @@ void html_strip_tags_inplace(char* buffer, size_t length) {
     bool inTag = false;
     bool inScript = false;
     bool inStyle = false;
+    bool blockTag = false;
     
     while (read < end) {
         char c = *read;
@@ -134,14 +158,19 @@ void html_strip_tags_inplace(char* buffer, size_t length) {
 
         if (c == '<') {
             inTag = true;
+            blockTag = _isBlockTag(read + 1, end);
         } else if (c == '>') {
+            // The tag took at least "<x", so write is still behind read
+            if (inTag && blockTag && !inScript && !inStyle) *write++ = '\n';
             inTag = false;
+            blockTag = false;
             read++;
             continue;
         }
 
         if (!inTag && !inScript && !inStyle) {
-            *write++ = c;
+            // Source line breaks are just whitespace in HTML
+            *write++ = (c == '\r' || c == '\n' || c == '\t') ? ' ' : c;
         }
         
         read++;
@@ -23,6 +23,8 @@ String html_strip_tags(const String& html);
  * @brief Strips HTML tags from a buffer in-place.
  * Also decodes entities. The result will always be shorter or equal length.
  * The buffer will be null-terminated at the new length.
+ * Source line breaks and tabs become spaces; block-level tags (p, br, div,
+ * h1-h6, li, ...) become '\n', so each '\n' marks a paragraph break.
  * 
  * @param buffer Mutable buffer containing HTML.
  * @param length Length of the valid data in buffer.
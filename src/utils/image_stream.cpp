@@ -0,0 +1,180 @@
+/*
+ * image_stream.cpp
+ *
+ * PBM / PNG streaming encoder for 1-bpp frames (see image_stream.h).
+ */
+
+#include "image_stream.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// PNG layout: signature, IHDR, one IDAT holding a zlib stream with one stored
+// block per scanline (filter byte + row), IEND
+static const size_t PNG_SIGNATURE = 8;
+static const size_t PNG_CHUNK = 12;   // length + type + CRC
+static const size_t PNG_IHDR = 13;
+static const size_t ZLIB_HEADER = 2;
+static const size_t ZLIB_TRAILER = 4; // Adler-32
+static const size_t STORED_HEADER = 5;
+
+static uint32_t _crc32(uint32_t crc, const uint8_t *p, size_t n) {
+  static uint32_t table[256];
+  static bool ready = false;
+  if (!ready) {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      table[i] = c;
+    }
+    ready = true;
+  }
+  crc = ~crc;
+  while (n--) crc = table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+static uint32_t _adler32(uint32_t adler, const uint8_t *p, size_t n) {
+  uint32_t a = adler & 0xFFFF;
+  uint32_t b = adler >> 16;
+  while (n--) {
+    a = (a + *p++) % 65521;
+    b = (b + a) % 65521;
+  }
+  return (b << 16) | a;
+}
+
+static void _put32(uint8_t *out, uint32_t v) {
+  out[0] = v >> 24;
+  out[1] = v >> 16;
+  out[2] = v >> 8;
+  out[3] = v;
+}
+
+static size_t _pbmHeader(char *buf, size_t size, int width, int height) {
+  return (size_t)snprintf(buf, size, "P4\n%d %d\n", width, height);
+}
+
+static size_t _idatBytes(int height, size_t rowBytes) {
+  return ZLIB_HEADER + (size_t)height * (STORED_HEADER + 1 + rowBytes) + ZLIB_TRAILER;
+}
+
+size_t img_stream_size(img_format_t format, int width, int height) {
+  size_t rowBytes = (width + 7) / 8;
+  if (format == IMG_PBM) {
+    char header[32];
+    return _pbmHeader(header, sizeof(header), width, height) + rowBytes * height;
+  }
+  return PNG_SIGNATURE + (PNG_CHUNK + PNG_IHDR) + (PNG_CHUNK + _idatBytes(height, rowBytes)) + PNG_CHUNK;
+}
+
+// Emit IDAT payload bytes (counted in the chunk CRC)
+static void _idat(img_stream_t *s, const uint8_t *data, size_t len) {
+  s->crc = _crc32(s->crc, data, len);
+  s->write(data, len, s->ctx);
+}
+
+// A chunk whose data is written in one piece
+static void _chunk(img_stream_t *s, const char *type, const uint8_t *data, size_t len) {
+  uint8_t head[8];
+  _put32(head, len);
+  memcpy(head + 4, type, 4);
+  s->write(head, sizeof(head), s->ctx);
+  if (len) s->write(data, len, s->ctx);
+
+  uint8_t crc[4];
+  _put32(crc, _crc32(_crc32(0, (const uint8_t *)type, 4), data, len));
+  s->write(crc, sizeof(crc), s->ctx);
+}
+
+void img_stream_begin(img_stream_t *s, img_format_t format, int width, int height, img_write_cb cb, void *ctx) {
+  s->format = format;
+  s->width = width;
+  s->height = height;
+  s->rowBytes = (width + 7) / 8;
+  s->y = 0;
+  s->crc = 0;
+  s->adler = 1;
+  s->write = cb;
+  s->ctx = ctx;
+
+  if (format == IMG_PBM) {
+    char header[32];
+    size_t n = _pbmHeader(header, sizeof(header), width, height);
+    cb((const uint8_t *)header, n, ctx);
+    return;
+  }
+
+  static const uint8_t SIGNATURE[PNG_SIGNATURE] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  cb(SIGNATURE, sizeof(SIGNATURE), ctx);
+
+  uint8_t ihdr[PNG_IHDR];
+  _put32(ihdr, width);
+  _put32(ihdr + 4, height);
+  ihdr[8] = 1;  // bit depth
+  ihdr[9] = 0;  // grayscale
+  ihdr[10] = 0; // deflate
+  ihdr[11] = 0; // adaptive filtering
+  ihdr[12] = 0; // no interlace
+  _chunk(s, "IHDR", ihdr, sizeof(ihdr));
+
+  // IDAT: length and type now, CRC accumulated row by row
+  uint8_t head[8];
+  _put32(head, _idatBytes(height, s->rowBytes));
+  memcpy(head + 4, "IDAT", 4);
+  cb(head, sizeof(head), ctx);
+  s->crc = _crc32(0, head + 4, 4);
+
+  static const uint8_t ZLIB[ZLIB_HEADER] = {0x78, 0x01}; // 32K window, no preset dictionary
+  _idat(s, ZLIB, sizeof(ZLIB));
+}
+
+void img_stream_row(img_stream_t *s, const uint8_t *row) {
+  if (s->y >= s->height) return;
+  s->y++;
+
+  if (s->format == IMG_PBM) {
+    s->write(row, s->rowBytes, s->ctx);
+    return;
+  }
+
+  // Stored block: BFINAL on the last row, LEN / NLEN little endian
+  const uint16_t len = 1 + s->rowBytes;
+  uint8_t block[STORED_HEADER + 1] = {
+    (uint8_t)(s->y == s->height ? 1 : 0),
+    (uint8_t)len, (uint8_t)(len >> 8),
+    (uint8_t)~len, (uint8_t)(~len >> 8),
+    0 // filter: none
+  };
+  _idat(s, block, sizeof(block));
+  s->adler = _adler32(s->adler, &block[STORED_HEADER], 1);
+
+  // PNG grayscale: 0 = black, the inverse of the frame convention
+  uint8_t chunk[32];
+  for (size_t i = 0; i < s->rowBytes; i += sizeof(chunk)) {
+    size_t n = s->rowBytes - i < sizeof(chunk) ? s->rowBytes - i : sizeof(chunk);
+    for (size_t k = 0; k < n; ++k) chunk[k] = ~row[i + k];
+    s->adler = _adler32(s->adler, chunk, n);
+    _idat(s, chunk, n);
+  }
+}
+
+void img_stream_end(img_stream_t *s) {
+  if (s->y < s->height) {
+    uint8_t white[32] = {0};
+    uint8_t *row = s->rowBytes <= sizeof(white) ? white : (uint8_t *)calloc(s->rowBytes, 1);
+    while (row && s->y < s->height) img_stream_row(s, row);
+    if (row != white) free(row);
+  }
+  if (s->format == IMG_PBM) return;
+
+  uint8_t adler[ZLIB_TRAILER];
+  _put32(adler, s->adler);
+  _idat(s, adler, sizeof(adler));
+
+  uint8_t crc[4];
+  _put32(crc, s->crc);
+  s->write(crc, sizeof(crc), s->ctx);
+
+  _chunk(s, "IEND", NULL, 0);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstdint>
+
+/*
+ * image_stream.h
+ *
+ * Streaming encoder for packed 1-bpp frames (same convention as the "bw"
+ * image format: MSB first, bit set = black) to PBM (P4) or PNG.
+ *
+ * Rows are encoded as they are handed in and the output goes straight to a
+ * write callback, so a frame can be sent without an image-sized buffer. The
+ * PNG uses stored (uncompressed) deflate blocks: a 1-bpp frame is small
+ * enough that zlib would not be worth its RAM.
+ *
+ * The encoded size is known up front (img_stream_size), e.g. for a
+ * Content-Length header.
+ */
+
+enum img_format_t {
+  IMG_PBM,
+  IMG_PNG
+};
+
+// Receives encoded bytes in order
+typedef void (*img_write_cb)(const uint8_t *data, size_t len, void *ctx);
+
+struct img_stream_t {
+  img_format_t format;
+  int width;
+  int height;
+  size_t rowBytes;
+  int y;              // next row index
+  uint32_t crc;       // PNG: running CRC of the IDAT chunk
+  uint32_t adler;     // PNG: Adler-32 of the uncompressed scanlines
+  img_write_cb write;
+  void *ctx;
+};
+
+// Total encoded bytes for a `width` x `height` frame
+size_t img_stream_size(img_format_t format, int width, int height);
+
+// Write the header. `cb` gets every encoded byte.
+void img_stream_begin(img_stream_t *s, img_format_t format, int width, int height, img_write_cb cb, void *ctx);
+
+// Encode the next row (ceil(width / 8) bytes). Extra rows are ignored.
+void img_stream_row(img_stream_t *s, const uint8_t *row);
+
+// Write the trailer. Missing rows are sent as white first.
+void img_stream_end(img_stream_t *s);
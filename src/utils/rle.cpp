@@ -0,0 +1,99 @@
+/*
+ * rle.cpp
+ *
+ * PackBits encoder and incremental row decoder (see rle.h).
+ */
+
+#include "rle.h"
+
+#include <string.h>
+
+void rle_stream_begin(rle_stream_t *s, uint8_t *rowBuf, size_t rowBytes, int rows, rle_row_cb cb, void *ctx) {
+  s->row = rowBuf;
+  s->rowBytes = rowBytes;
+  s->fill = 0;
+  s->y = 0;
+  s->rows = rows;
+  s->literal = 0;
+  s->run = 0;
+  s->cb = cb;
+  s->ctx = ctx;
+}
+
+// Append `n` bytes (copied from `src`, or `n` x `value` when src is NULL).
+static bool _emit(rle_stream_t *s, const uint8_t *src, uint8_t value, size_t n) {
+  while (n > 0) {
+    if (s->y >= s->rows) return false; // more data than the image holds
+    size_t take = s->rowBytes - s->fill;
+    if (take > n) take = n;
+    if (src) {
+      memcpy(s->row + s->fill, src, take);
+      src += take;
+    } else {
+      memset(s->row + s->fill, value, take);
+    }
+    s->fill += take;
+    n -= take;
+
+    if (s->fill == s->rowBytes) {
+      if (s->cb) s->cb(s->row, s->y, s->ctx);
+      s->fill = 0;
+      s->y++;
+    }
+  }
+  return true;
+}
+
+bool rle_stream_feed(rle_stream_t *s, const uint8_t *data, size_t len) {
+  size_t i = 0;
+  while (i < len) {
+    if (s->literal > 0) {
+      size_t n = len - i;
+      if (n > (size_t)s->literal) n = s->literal;
+      if (!_emit(s, data + i, 0, n)) return false;
+      s->literal -= n;
+      i += n;
+    } else if (s->run > 0) {
+      if (!_emit(s, NULL, data[i], s->run)) return false;
+      s->run = 0;
+      i++;
+    } else {
+      uint8_t h = data[i++];
+      if (h < 128) s->literal = h + 1;
+      else if (h > 128) s->run = 257 - h;
+    }
+  }
+  return true;
+}
+
+bool rle_stream_done(const rle_stream_t *s) {
+  return s->y == s->rows && s->fill == 0 && s->literal == 0 && s->run == 0;
+}
+
+void rle_encode(const uint8_t *in, size_t len, std::vector<uint8_t> &out) {
+  out.clear();
+  size_t i = 0;
+  while (i < len) {
+    // Length of the run starting at i
+    size_t run = 1;
+    while (i + run < len && run < 128 && in[i + run] == in[i]) run++;
+
+    if (run >= 2) {
+      out.push_back((uint8_t)(257 - run));
+      out.push_back(in[i]);
+      i += run;
+      continue;
+    }
+
+    // Literal block: stop before the next run of 2+ identical bytes
+    size_t start = i;
+    size_t n = 0;
+    while (i < len && n < 128) {
+      if (i + 1 < len && in[i] == in[i + 1]) break;
+      i++;
+      n++;
+    }
+    out.push_back((uint8_t)(n - 1));
+    out.insert(out.end(), in + start, in + start + n);
+  }
+}
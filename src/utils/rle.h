@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+#include <cstdint>
+
+/*
+ * rle.h
+ *
+ * PackBits run-length codec for packed 1-bpp image data ("rle" format).
+ *
+ * Encoding (one stream for the whole image, runs may cross row boundaries):
+ *  - header n in 0..127   : copy the next n + 1 bytes literally
+ *  - header n in 129..255 : repeat the next byte 257 - n times
+ *  - header 128           : no-op
+ *
+ * The decoder is incremental: compressed bytes can be fed in arbitrary chunks
+ * and each decoded row is handed to a callback as soon as it is complete, so
+ * callers never need a full-size intermediate buffer.
+ */
+
+// Called for each decoded row (`row` holds `rowBytes` bytes)
+typedef void (*rle_row_cb)(const uint8_t *row, int y, void *ctx);
+
+struct rle_stream_t {
+  uint8_t *row;       // caller-provided row buffer (rowBytes bytes)
+  size_t rowBytes;
+  size_t fill;        // bytes already in `row`
+  int y;              // next row index
+  int rows;           // total rows expected
+  int literal;        // literal bytes still to copy
+  int run;            // pending run length (waiting for the run byte)
+  rle_row_cb cb;
+  void *ctx;
+};
+
+// Start decoding `rows` rows of `rowBytes` bytes. `cb` may be NULL (validation only).
+void rle_stream_begin(rle_stream_t *s, uint8_t *rowBuf, size_t rowBytes, int rows, rle_row_cb cb, void *ctx);
+
+// Feed a chunk of compressed data. Returns false if the data overflows the image.
+bool rle_stream_feed(rle_stream_t *s, const uint8_t *data, size_t len);
+
+// True once every row was decoded and no run is left half-finished.
+bool rle_stream_done(const rle_stream_t *s);
+
+// Encode `len` bytes with PackBits, replacing the contents of `out`.
+void rle_encode(const uint8_t *in, size_t len, std::vector<uint8_t> &out);
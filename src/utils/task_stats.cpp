@@ -0,0 +1,66 @@
+/*
+ * task_stats.cpp
+ *
+ * Self-reported task busy time (see task_stats.h).
+ */
+
+#include "task_stats.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static const char *const NAMES[TASK_STAT_COUNT] = {"loop", "ui", "app", "epd"};
+
+struct TaskSlot {
+  // Written by the task only
+  volatile uint32_t busyUs;   // running total (wraps)
+  volatile uint32_t count;
+  volatile uint32_t maxUs;
+  volatile int core;
+  volatile bool resetMax;     // set by the reader at a window boundary
+
+  // Reader side
+  uint32_t windowBusy;
+  uint32_t windowCount;
+  TaskStat last;
+};
+
+static TaskSlot s_slots[TASK_STAT_COUNT];
+static uint32_t s_windowStartUs = 0;
+
+void task_stats_add(TaskStatId id, uint32_t busyUs) {
+  TaskSlot &s = s_slots[id];
+  if (s.resetMax) {
+    s.maxUs = 0;
+    s.resetMax = false;
+  }
+  s.busyUs += busyUs;
+  s.count++;
+  if (busyUs > s.maxUs) s.maxUs = busyUs;
+  s.core = xPortGetCoreID();
+}
+
+void task_stats_read(TaskStat *out) {
+  uint32_t now = micros();
+  uint32_t elapsed = now - s_windowStartUs;
+  bool roll = elapsed >= TASK_STATS_WINDOW_MS * 1000UL;
+
+  for (int i = 0; i < TASK_STAT_COUNT; ++i) {
+    TaskSlot &s = s_slots[i];
+    if (roll) {
+      uint32_t busy = s.busyUs;
+      uint32_t count = s.count;
+      s.last.load = s_windowStartUs ? (float)(busy - s.windowBusy) / elapsed : 0.0f;
+      if (s.last.load > 1.0f) s.last.load = 1.0f;
+      s.last.count = count - s.windowCount;
+      s.last.maxUs = s.maxUs;
+      s.windowBusy = busy;
+      s.windowCount = count;
+      s.resetMax = true;
+    }
+    s.last.name = NAMES[i];
+    s.last.core = s.count ? s.core : -1;
+    out[i] = s.last;
+  }
+  if (roll) s_windowStartUs = now;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstdint>
+
+/*
+ * task_stats.h
+ *
+ * Busy time of the firmware's own tasks, for /status.
+ *
+ * FreeRTOS run-time stats are compiled out of the Arduino core, so each task
+ * reports the time it spent working (a loop() pass, a UI frame, an EPD job)
+ * itself. Load is busy time over the last window of at least
+ * TASK_STATS_WINDOW_MS; `maxUs` is the longest single piece of work in it,
+ * which for loop() is the worst stall of the HTTP server / app events.
+ *
+ * Every slot has a single writer (its task); readers may be anywhere.
+ */
+
+#define TASK_STATS_WINDOW_MS 1000
+
+enum TaskStatId {
+  TASK_STAT_LOOP,     // Arduino loop(): HTTP server, app events
+  TASK_STAT_UI,       // UI task: buttons, input events, animation frames
+  TASK_STAT_APP,      // App worker: jobs from ui_runAsync (fetches, books)
+  TASK_STAT_EPD,      // EPD worker: rasterizing and panel writes (not BUSY waits)
+  TASK_STAT_COUNT
+};
+
+struct TaskStat {
+  const char *name;
+  int core;           // core of the last report
+  float load;         // 0..1 over the last window
+  uint32_t maxUs;     // longest report in the last window
+  uint32_t count;     // reports in the last window
+};
+
+// Record `busyUs` of work by the calling task
+void task_stats_add(TaskStatId id, uint32_t busyUs);
+
+// Snapshot of every slot (TASK_STAT_COUNT entries). Starts a new window when
+// the current one is older than TASK_STATS_WINDOW_MS.
+void task_stats_read(TaskStat *out);
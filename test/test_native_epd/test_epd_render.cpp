@@ -0,0 +1,639 @@
+/*
+ * test_epd_render.cpp
+ *
+ * Host tests for the e-paper job paths, run against the simulated panel
+ * (pio test -e native).
+ *
+ * - Images ("bw", "rle", "g4") land on the panel pixel for pixel
+ * - Job slots and payload buffers are reused when the queue overflows
+ * - Partial jobs (text, date overlay) only change their own window
+ * - Paged frame buffers draw the same frames as the full-frame one
+ * - Page turns swap in the screen prepared in the standby buffer
+ * - The layout pass splits long pages into screens that fit the panel and
+ *   wraps paragraphs to its width
+ * - Screenshots (/api/epd/screenshot) read back what the panel shows
+ * - Pages without text match the golden PBMs in golden/ (text depends on the
+ *   U8g2 fonts, so text screens have no goldens yet)
+ * - Scrolling OLED text is measured once, not every frame
+ * - The OLED reports when a toast next needs a frame (idle governor deadline)
+ * - UI animations step the same at any frame rate and settle on the target
+ *
+ * Goldens: a missing file fails the test. Run with SIM_UPDATE_GOLDEN=1 to
+ * record them (the test is then reported as ignored), e.g. after an intended
+ * layout change, and commit the .pbm files. On a mismatch the actual frame is
+ * written to .pio/sim/actual/<name>.png.
+ */
+
+#include <Arduino.h>
+#include <GxEPD2.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include <sim.h>
+#include <sys/stat.h>
+
+#include "drivers/epaper/display.h"
+#include "utils/anim.h"
+#include "drivers/epaper/glyph_atlas.h"
+#include "drivers/epaper/layout.h"
+#include "drivers/epaper/stats.h"
+#include "drivers/oled/oled.h"
+#include "utils/image_stream.h"
+#include "utils/rle.h"
+
+#define GOLDEN_DIR "test/test_native_epd/golden/"
+#define ACTUAL_DIR ".pio/sim/actual/"
+
+static uint32_t _jobsDone(void) {
+  EpdStatsSummary s;
+  epd_stats_summary(s);
+  return s.jobs;
+}
+
+// Wait for the job queued by `queued` (true when the call accepted it)
+static void _finish(bool queued, uint32_t before) {
+  TEST_ASSERT_TRUE_MESSAGE(queued, "job rejected");
+  uint32_t start = millis();
+  while (_jobsDone() <= before) {
+    TEST_ASSERT_TRUE_MESSAGE(millis() - start < 10000, "job did not finish");
+    delay(1);
+  }
+}
+
+#define RUN_JOB(call) do { uint32_t _n = _jobsDone(); _finish((call), _n); } while (0)
+#define RUN_JOB_VOID(call) do { uint32_t _n = _jobsDone(); call; _finish(true, _n); } while (0)
+
+static void _writeActual(const char *name, const SimImage &frame) {
+  char path[128];
+  mkdir(".pio/sim", 0755);
+  mkdir(ACTUAL_DIR, 0755);
+  snprintf(path, sizeof(path), ACTUAL_DIR "%s.png", name);
+  sim_writePng(path, frame);
+  snprintf(path, sizeof(path), ACTUAL_DIR "%s.pbm", name);
+  sim_writePbm(path, frame);
+}
+
+static void _assertGolden(const char *name, const SimImage &frame) {
+  char path[128];
+  snprintf(path, sizeof(path), GOLDEN_DIR "%s.pbm", name);
+
+  SimImage golden;
+  if (getenv("SIM_UPDATE_GOLDEN")) {
+    TEST_ASSERT_TRUE_MESSAGE(sim_writePbm(path, frame), "cannot write golden");
+    TEST_IGNORE_MESSAGE("golden recorded");
+  }
+  if (!sim_readPbm(path, golden)) {
+    _writeActual(name, frame);
+    TEST_FAIL_MESSAGE("golden missing: record it with SIM_UPDATE_GOLDEN=1");
+  }
+
+  size_t diff = sim_diffPixels(golden, frame);
+  if (diff != 0) _writeActual(name, frame);
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, diff, "frame differs from golden");
+}
+
+static bool _ink(const SimImage &img, int x, int y) {
+  return img.luma[(size_t)y * img.width + x] < 128;
+}
+
+// Pixels that differ outside the rectangle (x, y, w, h)
+static size_t _changesOutside(const SimImage &a, const SimImage &b, int x, int y, int w, int h) {
+  size_t n = 0;
+  for (int yy = 0; yy < a.height; ++yy) {
+    for (int xx = 0; xx < a.width; ++xx) {
+      bool inside = xx >= x && xx < x + w && yy >= y && yy < y + h;
+      if (!inside && _ink(a, xx, yy) != _ink(b, xx, yy)) n++;
+    }
+  }
+  return n;
+}
+
+static std::vector<uint8_t> _testCard(int w, int h) {
+  const int stride = (w + 7) / 8;
+  std::vector<uint8_t> data(stride * h, 0);
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      int dx = x - w / 2;
+      int dy = y - h / 2;
+      if (x == 0 || y == 0 || x == w - 1 || y == h - 1 || x == y || dx * dx + dy * dy <= 100) {
+        data[y * stride + x / 8] |= 0x80 >> (x & 7);
+      }
+    }
+  }
+  return data;
+}
+
+void setUp(void) {
+  epd_setPartialEnabled(false);
+}
+
+void tearDown(void) {}
+
+void test_image_bw_lands_centered(void) {
+  const int w = 40, h = 30;
+  std::vector<uint8_t> card = _testCard(w, h);
+  RUN_JOB(epd_drawImageFromBitplanes(w, h, card, "bw", "black", true));
+
+  SimImage frame = sim_epd_frame();
+  TEST_ASSERT_EQUAL(epd_width(), frame.width);
+  TEST_ASSERT_EQUAL(epd_height(), frame.height);
+
+  const int rx = (frame.width - w) / 2;
+  const int ry = (frame.height - h) / 2;
+  size_t wrong = 0;
+  for (int y = 0; y < frame.height; ++y) {
+    for (int x = 0; x < frame.width; ++x) {
+      bool expected = false;
+      if (x >= rx && x < rx + w && y >= ry && y < ry + h) {
+        int sx = x - rx, sy = y - ry;
+        expected = card[sy * ((w + 7) / 8) + sx / 8] & (0x80 >> (sx & 7));
+      }
+      if (_ink(frame, x, y) != expected) wrong++;
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, wrong, "bw image pixels");
+}
+
+void test_image_rle_matches_bw(void) {
+  const int w = 96, h = 64;
+  std::vector<uint8_t> card = _testCard(w, h);
+  RUN_JOB(epd_drawImageFromBitplanes(w, h, card, "bw", "black", true));
+  SimImage raw = sim_epd_frame();
+
+  std::vector<uint8_t> packed;
+  rle_encode(card.data(), card.size(), packed);
+  RUN_JOB(epd_drawImageFromBitplanes(w, h, packed, "rle", "black", true));
+
+  TEST_ASSERT_EQUAL_UINT32(0, sim_diffPixels(raw, sim_epd_frame()));
+}
+
+void test_job_slots_reused(void) {
+  // A burst fills the queue: jobs past the slots are rejected, and payloads
+  // past the arena are copied to the heap
+  const int w = epd_width(), h = epd_height();
+  EpdMemoryInfo before;
+  epd_getMemoryInfo(before);
+
+  sim_setTimingScale(0.05f);
+  std::vector<uint8_t> frames[8];
+  int accepted = 0, last = -1;
+  uint32_t n = _jobsDone();
+  for (int i = 0; i < 8; ++i) {
+    frames[i] = _testCard(w, h);
+    frames[i][i] ^= 0xFF;
+    if (epd_drawImageFromBitplanes(w, h, frames[i], "bw", "black", true)) {
+      accepted++;
+      last = i;
+    }
+  }
+  uint32_t start = millis();
+  while (_jobsDone() < n + accepted && millis() - start < 10000) delay(1);
+  sim_setTimingScale(0);
+
+  TEST_ASSERT_TRUE(accepted >= 5 && accepted < 8);
+  TEST_ASSERT_EQUAL_UINT32(n + accepted, _jobsDone());
+  EpdMemoryInfo after;
+  epd_getMemoryInfo(after);
+  TEST_ASSERT_TRUE(after.heapPayloads > before.heapPayloads);
+
+  // The last accepted image is on screen
+  SimImage frame = sim_epd_frame();
+  size_t wrong = 0;
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      bool expected = frames[last][y * (w / 8) + x / 8] & (0x80 >> (x & 7));
+      if (_ink(frame, x, y) != expected) wrong++;
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, wrong);
+
+  // Every slot and arena block came back
+  for (int i = 0; i < 8; ++i) RUN_JOB(epd_drawImageFromBitplanes(w, h, frames[i], "bw", "black", true));
+  epd_getMemoryInfo(before);
+  TEST_ASSERT_EQUAL_UINT32(after.heapPayloads, before.heapPayloads);
+}
+
+void test_gray_levels(void) {
+  const int w = 128, h = 296;
+  const int stride = w / 4;
+  std::vector<uint8_t> data(stride * h, 0);
+  for (int y = 0; y < h; ++y) {
+    memset(&data[y * stride], (y * 4 / h) * 0x55, stride); // same level in all 4 pixels of a byte
+  }
+
+  SimEpdCounters before = sim_epd_counters();
+  RUN_JOB(epd_drawImageFromBitplanes(w, h, data, "g4", "black", true));
+  TEST_ASSERT_EQUAL_UINT32(before.grayRefreshes + 1, sim_epd_counters().grayRefreshes);
+
+  static const uint8_t LUMA[4] = {255, 170, 85, 0};
+  SimImage frame = sim_epd_frame();
+  for (int band = 0; band < 4; ++band) {
+    int y = band * h / 4 + h / 8;
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(LUMA[band], frame.luma[y * w + w / 2], "gray band level");
+  }
+}
+
+void test_partial_text_only_changes_its_window(void) {
+  RUN_JOB_VOID(epd_clear());
+  SimImage before = sim_epd_frame();
+  SimEpdCounters counters = sim_epd_counters();
+
+  epd_setPartialEnabled(true);
+  RUN_JOB_VOID(epd_displayText("Hi", GxEPD_BLACK));
+  SimImage after = sim_epd_frame();
+
+  TEST_ASSERT_EQUAL_UINT32(counters.partialRefreshes + 1, sim_epd_counters().partialRefreshes);
+  TEST_ASSERT_TRUE_MESSAGE(sim_diffPixels(before, after) > 0, "text was not drawn");
+  // The text box is centered; everything above and below its band stays untouched
+  TEST_ASSERT_EQUAL_UINT32(0, _changesOutside(before, after, 0, after.height / 2 - 40, after.width, 80));
+}
+
+void test_date_refreshes_overlay_only(void) {
+  const time_t day = 1767225600; // 2026-01-01
+  RUN_JOB_VOID(epd_displayWallpaper(day));
+  SimImage wallpaper = sim_epd_frame();
+  SimEpdCounters counters = sim_epd_counters();
+
+  RUN_JOB_VOID(epd_displayDate(day + 86400));
+  SimImage dated = sim_epd_frame();
+
+  TEST_ASSERT_EQUAL_UINT32(counters.fullRefreshes, sim_epd_counters().fullRefreshes);
+  TEST_ASSERT_EQUAL_UINT32(counters.partialRefreshes + 1, sim_epd_counters().partialRefreshes);
+  TEST_ASSERT_TRUE_MESSAGE(sim_diffPixels(wallpaper, dated) > 0, "date did not change");
+  // The overlay sits in the bottom-right corner
+  TEST_ASSERT_EQUAL_UINT32(0, _changesOutside(wallpaper, dated, dated.width / 2, dated.height - 32, dated.width / 2, 32));
+}
+
+void test_paged_matches_full(void) {
+  EpdPage page;
+  page.title = "Paged";
+  page.components.push_back({EPD_COMP_ROW, "Rows", "40", 0, 0});
+  page.components.push_back({EPD_COMP_PROGRESS, "CPU", "66%", 66, 0});
+  page.components.push_back({EPD_COMP_SEPARATOR, "", "", 0, 0});
+  const time_t day = 1767225600;
+  const int w = 96, h = 200; // spans several pages
+  std::vector<uint8_t> card = _testCard(w, h);
+
+  RUN_JOB_VOID(epd_displayPage(page));
+  SimImage fullPage = sim_epd_frame();
+  RUN_JOB(epd_drawImageFromBitplanes(w, h, card, "bw", "black", true));
+  SimImage fullImage = sim_epd_frame();
+  RUN_JOB_VOID(epd_displayWallpaper(day));
+  SimImage fullWallpaper = sim_epd_frame();
+
+  RUN_JOB(epd_setFramebufferRows(40));
+  TEST_ASSERT_EQUAL(EPD_BUFFER_OK, epd_getFramebufferResult(1000));
+  EpdMemoryInfo mem;
+  epd_getMemoryInfo(mem);
+  TEST_ASSERT_TRUE(mem.paged);
+  TEST_ASSERT_EQUAL_UINT16(40, mem.rows);
+
+  RUN_JOB_VOID(epd_displayPage(page));
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, sim_diffPixels(fullPage, sim_epd_frame()), "page");
+  RUN_JOB(epd_drawImageFromBitplanes(w, h, card, "bw", "black", true));
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, sim_diffPixels(fullImage, sim_epd_frame()), "image");
+  RUN_JOB_VOID(epd_displayWallpaper(day));
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, sim_diffPixels(fullWallpaper, sim_epd_frame()), "wallpaper");
+
+  RUN_JOB(epd_setFramebufferRows(0));
+  epd_getMemoryInfo(mem);
+  TEST_ASSERT_FALSE(mem.paged);
+}
+
+void test_layout_paginates_long_page(void) {
+  EpdPage page;
+  page.title = "Article";
+  for (int i = 0; i < 60; ++i) {
+    page.components.push_back({i % 10 == 0 ? EPD_COMP_HEADER : EPD_COMP_ROW, "Line " + String(i), "", 0, 0});
+  }
+
+  EpdLayout layout;
+  size_t screens = epd_layout_paginate(page, layout);
+  TEST_ASSERT_TRUE(screens > 1);
+  TEST_ASSERT_EQUAL_UINT32(0, layout.starts[0].component);
+
+  // Every screen fits, and the first component of the next one would not have
+  size_t shown = 0;
+  for (size_t i = 0; i < screens; ++i) {
+    EpdPage screen;
+    epd_layout_screen(page, layout, i, screen);
+    TEST_ASSERT_TRUE(screen.components.size() > 0);
+    int16_t y = epd_layout_top(screen);
+    for (const EpdComponent &comp : screen.components) {
+      EpdLayoutBox box = epd_layout_measure(screen, comp);
+      TEST_ASSERT_TRUE(y + box.extent <= (int16_t)epd_height());
+      y += box.advance;
+    }
+    shown += screen.components.size();
+    if (shown < page.components.size()) {
+      TEST_ASSERT_TRUE(y + epd_layout_measure(page, page.components[shown]).extent > (int16_t)epd_height());
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32(page.components.size(), shown);
+
+  RUN_JOB_VOID(epd_displayPageScreen(page, layout, screens - 1));
+
+  // Cached until reset
+  size_t starts = layout.starts.size();
+  page.components.resize(1);
+  TEST_ASSERT_EQUAL_UINT32(screens, epd_layout_paginate(page, layout));
+  TEST_ASSERT_EQUAL_UINT32(starts, layout.starts.size());
+  layout = EpdLayout();
+  TEST_ASSERT_EQUAL_UINT32(1, epd_layout_paginate(page, layout));
+}
+
+void test_layout_wraps_paragraph(void) {
+  String text;
+  for (int i = 0; i < 200; ++i) text += "word" + String(i) + (i % 17 == 16 ? " extraordinarilylongwordthatneverfits " : " ");
+  text.trim();
+
+  EpdPage page;
+  page.components.push_back({EPD_COMP_HEADER, "Chapter", "", 0, 0});
+  epd_page_addParagraph(page, text);
+  TEST_ASSERT_EQUAL_UINT32(text.length(), page.text->length());
+
+  EpdLayout layout;
+  size_t screens = epd_layout_paginate(page, layout);
+  TEST_ASSERT_TRUE(screens > 1);
+
+  // The screens' spans tile the paragraph (only break spaces are skipped)
+  // and every line fits the text width
+  const int16_t pitch = epd_layout_paragraphPitch();
+  uint32_t next = 0;
+  String joined;
+  for (size_t i = 0; i < screens; ++i) {
+    EpdPage screen;
+    epd_layout_screen(page, layout, i, screen);
+    TEST_ASSERT_TRUE(screen.text == page.text);
+
+    const EpdComponent &para = screen.components.back();
+    TEST_ASSERT_EQUAL(EPD_COMP_PARAGRAPH, para.type);
+    TEST_ASSERT_TRUE(para.offset >= next);
+    for (uint32_t k = next; k < para.offset; ++k) TEST_ASSERT_TRUE(text[k] == ' ');
+    next = para.offset + para.length;
+
+    EpdLayoutBox box = epd_layout_measure(screen, para);
+    int16_t y = epd_layout_top(screen) + (screen.components.size() > 1 ? epd_layout_measure(screen, screen.components[0]).advance : 0);
+    TEST_ASSERT_TRUE(y + box.extent <= (int16_t)epd_height());
+    TEST_ASSERT_TRUE(y + box.extent + pitch > (int16_t)epd_height() || i == screens - 1);
+
+    const char *s = page.text->c_str() + para.offset;
+    for (size_t pos = 0; pos < para.length;) {
+      size_t drawLen;
+      pos += epd_layout_nextLine(s + pos, para.length - pos, epd_layout_paragraphWidth(), drawLen);
+      TEST_ASSERT_TRUE(drawLen * epd_atlas_advance(EPD_FONT_PROFONT12, 'w') <= (size_t)epd_layout_paragraphWidth());
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32(text.length(), next);
+
+  // Rendered screens carry ink below the header
+  RUN_JOB_VOID(epd_displayPageScreen(page, layout, 1));
+  SimImage frame = sim_epd_frame();
+  size_t ink = 0;
+  for (int y = frame.height / 2; y < frame.height; ++y) {
+    for (int x = 0; x < frame.width; ++x) ink += _ink(frame, x, y);
+  }
+  TEST_ASSERT_TRUE(ink > 0);
+}
+
+void test_standby_page_turn(void) {
+  EpdPage page;
+  page.title = "Book";
+  String text;
+  for (int i = 0; i < 300; ++i) text += "w" + String(i) + " ";
+  epd_page_addParagraph(page, text);
+  EpdLayout layout;
+  TEST_ASSERT_TRUE(epd_layout_paginate(page, layout) > 2);
+
+  // Screen 0 queues screen 1 into the standby buffer (two jobs per turn);
+  // turning the page swaps it in
+  uint32_t n = _jobsDone();
+  epd_displayPageScreen(page, layout, 0);
+  _finish(true, n + 1);
+  n = _jobsDone();
+  epd_displayPageScreen(page, layout, 1);
+  _finish(true, n + 1);
+
+  EpdJobStats recent[2]; // newest first
+  TEST_ASSERT_EQUAL_UINT32(2, epd_stats_recent(recent, 2));
+  TEST_ASSERT_EQUAL_STRING("standby", recent[0].type);
+  TEST_ASSERT_EQUAL_STRING("page", recent[1].type);
+  TEST_ASSERT_TRUE(recent[1].standby);
+  const SimImage swapped = sim_epd_frame();
+
+  // Same pixels as drawing the screen directly (the standby now holds screen 2)
+  EpdPage screen;
+  epd_layout_screen(page, layout, 1, screen);
+  RUN_JOB_VOID(epd_displayPage(screen));
+  TEST_ASSERT_EQUAL_UINT32(1, epd_stats_recent(recent, 1));
+  TEST_ASSERT_FALSE(recent[0].standby);
+  TEST_ASSERT_EQUAL_UINT32(0, sim_diffPixels(swapped, sim_epd_frame()));
+}
+
+static void _collect(const uint8_t *data, size_t len, void *ctx) {
+  std::vector<uint8_t> &out = *(std::vector<uint8_t> *)ctx;
+  out.insert(out.end(), data, data + len);
+}
+
+static void _encodeRow(const uint8_t *row, int, void *ctx) {
+  img_stream_row((img_stream_t *)ctx, row);
+}
+
+void test_screenshot_matches_panel(void) {
+  RUN_JOB_VOID(epd_displayText("Screenshot", GxEPD_BLACK, true));
+  const SimImage frame = sim_epd_frame();
+
+  std::vector<uint8_t> pbm;
+  img_stream_t img;
+  img_stream_begin(&img, IMG_PBM, epd_width(), epd_snapshotHeight(false), _collect, &pbm);
+  TEST_ASSERT_EQUAL(EPD_SNAPSHOT_OK, epd_snapshot(_encodeRow, &img, false, 1000));
+  img_stream_end(&img);
+  TEST_ASSERT_EQUAL_UINT32(img_stream_size(IMG_PBM, frame.width, frame.height), pbm.size());
+
+  // P4 rows follow the header, bit set = black
+  const int stride = (frame.width + 7) / 8;
+  const uint8_t *bits = pbm.data() + pbm.size() - (size_t)stride * frame.height;
+  size_t diff = 0;
+  for (int y = 0; y < frame.height; ++y) {
+    for (int x = 0; x < frame.width; ++x) {
+      bool ink = bits[y * stride + x / 8] & (0x80 >> (x & 7));
+      if (ink != _ink(frame, x, y)) diff++;
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, diff);
+
+  // PNG with the OLED below: exact size, well-formed ends
+  std::vector<uint8_t> png;
+  img_stream_begin(&img, IMG_PNG, epd_width(), epd_snapshotHeight(true), _collect, &png);
+  TEST_ASSERT_EQUAL(EPD_SNAPSHOT_OK, epd_snapshot(_encodeRow, &img, true, 1000));
+  img_stream_end(&img);
+  TEST_ASSERT_EQUAL_UINT32(img_stream_size(IMG_PNG, epd_width(), epd_snapshotHeight(true)), png.size());
+  TEST_ASSERT_EQUAL_MEMORY("\x89PNG", png.data(), 4);
+  TEST_ASSERT_EQUAL_MEMORY("IEND", png.data() + png.size() - 8, 4);
+
+  // A paged frame buffer keeps no frame to read
+  RUN_JOB(epd_setFramebufferRows(64));
+  TEST_ASSERT_EQUAL(EPD_SNAPSHOT_PAGED, epd_snapshot(_encodeRow, &img, false, 1000));
+  RUN_JOB(epd_setFramebufferRows(0));
+}
+
+void test_page_bars_golden(void) {
+  // No text: only lines and bars, so the golden does not depend on fonts
+  EpdPage page;
+  page.components.push_back({EPD_COMP_SEPARATOR, "", "", 0, 0});
+  page.components.push_back({EPD_COMP_PROGRESS, "", "", 0, 0});
+  page.components.push_back({EPD_COMP_PROGRESS, "", "", 50, 0});
+  page.components.push_back({EPD_COMP_PROGRESS, "", "", 100, 0});
+  page.components.push_back({EPD_COMP_SEPARATOR, "", "", 0, 0});
+  RUN_JOB_VOID(epd_displayPage(page));
+  _assertGolden("page_bars", sim_epd_frame());
+}
+
+void test_oled_flush_sends_changed_pages(void) {
+  oled_setMenuMode(false);
+  oled_showProgress("Clearing", 2, 4);
+  uint32_t before = sim_oled_bytesWritten();
+
+  // Same frame: nothing to send
+  oled_showProgress("Clearing", 2, 4);
+  TEST_ASSERT_EQUAL(before, sim_oled_bytesWritten());
+
+  // Only the counter changes
+  oled_showProgress("Clearing", 3, 4);
+  oled_setMenuMode(true);
+  uint32_t sent = sim_oled_bytesWritten() - before;
+  TEST_ASSERT_TRUE(sent > 0);
+  TEST_ASSERT_TRUE(sent < OLED_WIDTH * OLED_HEIGHT / 8 / 2);
+
+  // The panel matches the buffer
+  SimImage frame = sim_oled_frame();
+  uint8_t row[OLED_WIDTH / 8];
+  size_t wrong = 0;
+  for (int y = 0; y < OLED_HEIGHT; ++y) {
+    oled_readRow(y, row);
+    for (int x = 0; x < OLED_WIDTH; ++x) {
+      bool lit = row[x >> 3] & (0x80 >> (x & 7));
+      if (lit != (frame.luma[(size_t)y * frame.width + x] > 127)) wrong++;
+    }
+  }
+  TEST_ASSERT_EQUAL(0, wrong);
+}
+
+void test_oled_sprite_moves_with_offset(void) {
+  // First draw renders the sprite, the second is a shifted copy of it
+  oled_clearBuffer();
+  oled_drawBigText("Books", 0, 0, true);
+  SimImage still = sim_oled_frame();
+  oled_clearBuffer();
+  oled_drawBigText("Books", 3, 13, true);
+  SimImage moved = sim_oled_frame();
+
+  size_t lit = 0, wrong = 0;
+  for (int y = 0; y < OLED_HEIGHT; ++y) {
+    for (int x = 0; x < OLED_WIDTH; ++x) {
+      bool a = still.luma[(size_t)y * OLED_WIDTH + x] > 127;
+      lit += a;
+      int mx = x + 3, my = y + 13;
+      if (mx >= OLED_WIDTH || my >= OLED_HEIGHT) continue;
+      if (a != (moved.luma[(size_t)my * OLED_WIDTH + mx] > 127)) wrong++;
+    }
+  }
+  TEST_ASSERT_TRUE(lit > 0);
+  TEST_ASSERT_EQUAL(0, wrong);
+}
+
+void test_oled_marquee_measured_once(void) {
+  const char *headline = "Long headline that has to scroll across the screen";
+  OledCacheStats before, after;
+  oled_clearBuffer();
+  oled_drawScrollingText(headline, 0, 0, false);
+  oled_getCacheStats(before);
+
+  for (int i = 0; i < 5; ++i) {
+    oled_clearBuffer();
+    oled_drawScrollingText(headline, 0, 0, false);
+  }
+  oled_getCacheStats(after);
+  TEST_ASSERT_EQUAL(before.measureMisses, after.measureMisses);
+  TEST_ASSERT_EQUAL(before.measureHits + 5, after.measureHits);
+
+  // Same text in another case: same layout, same entry
+  oled_drawScrollingText("LONG HEADLINE THAT HAS TO SCROLL ACROSS THE SCREEN", 0, 0, false);
+  oled_getCacheStats(after);
+  TEST_ASSERT_EQUAL(before.measureMisses, after.measureMisses);
+}
+
+void test_oled_toast_deadline(void) {
+  oled_clearBuffer();
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, oled_msUntilUpdate());
+
+  // Sliding in: frames now; shown: nothing until the slide out
+  oled_showToast("Saved", 2000);
+  TEST_ASSERT_EQUAL_UINT32(0, oled_msUntilUpdate());
+  delay(300);
+  uint32_t left = oled_msUntilUpdate();
+  TEST_ASSERT_TRUE(left > 1300 && left <= 1450);
+
+  // Scrolling text needs every frame
+  oled_drawScrollingText("Long headline that has to scroll across the screen", 0, 0, false);
+  TEST_ASSERT_EQUAL_UINT32(0, oled_msUntilUpdate());
+  oled_clearBuffer();
+}
+
+void test_anim_frame_rate_independent(void) {
+  static anim_prop_t spring;
+  anim_spring(&spring, Q16_CONST(2.0), Q16_CONST(0.28), Q16_CONST(0.005));
+  TEST_ASSERT_TRUE(anim_register(&spring));
+
+  // 20 ms frames and 60 ms frames land on the same values
+  q16_t fast[20];
+  anim_set(&spring, Q16_ONE);
+  for (int i = 0; i < 20; ++i) {
+    for (int k = 0; k < 3; ++k) anim_step(ANIM_STEP_US);
+    fast[i] = spring.value;
+  }
+  anim_set(&spring, Q16_ONE);
+  for (int i = 0; i < 20; ++i) {
+    anim_step(3 * ANIM_STEP_US);
+    TEST_ASSERT_EQUAL(fast[i], spring.value);
+  }
+  // Settled exactly, not a fraction off
+  TEST_ASSERT_EQUAL(0, spring.value);
+  TEST_ASSERT_FALSE(anim_isMoving(&spring));
+
+  // A tween ends on its target after its duration, however it is stepped
+  anim_tween(&spring, Q16_ONE, 150, ANIM_EASE_OUT_CUBIC);
+  anim_step(7 * ANIM_STEP_US);
+  TEST_ASSERT_TRUE(spring.value > Q16_ONE / 2 && spring.value < Q16_ONE);
+  anim_step(ANIM_STEP_US + 1);
+  TEST_ASSERT_EQUAL(Q16_ONE, spring.value);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  // Start from an empty flash (default wallpaper)
+  setenv("SIM_FS_ROOT", ".pio/sim/test_fs", 1);
+  LittleFS.begin();
+  LittleFS.remove("/wallpaper.bin");
+  epd_init();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_image_bw_lands_centered);
+  RUN_TEST(test_image_rle_matches_bw);
+  RUN_TEST(test_job_slots_reused);
+  RUN_TEST(test_gray_levels);
+  RUN_TEST(test_partial_text_only_changes_its_window);
+  RUN_TEST(test_date_refreshes_overlay_only);
+  RUN_TEST(test_paged_matches_full);
+  RUN_TEST(test_layout_paginates_long_page);
+  RUN_TEST(test_layout_wraps_paragraph);
+  RUN_TEST(test_standby_page_turn);
+  RUN_TEST(test_screenshot_matches_panel);
+  RUN_TEST(test_page_bars_golden);
+  RUN_TEST(test_oled_flush_sends_changed_pages);
+  RUN_TEST(test_oled_sprite_moves_with_offset);
+  RUN_TEST(test_oled_marquee_measured_once);
+  RUN_TEST(test_oled_toast_deadline);
+  RUN_TEST(test_anim_frame_rate_independent);
+  return UNITY_END();
+}
@@ -1,6 +1,6 @@
 #!/usr/bin/env python3
 """
-upload_image.py - convert an image to 1-bit or 3-color bitplanes and upload to ESP32 E-Paper API
+upload_image.py - convert an image to 1-bit, 3-color or grayscale data and upload to ESP32 E-Paper API
 
 Requirements:
   - Python 3
@@ -20,6 +20,14 @@ Usage:
   # Force a full refresh on the device (useful if partial updates are unstable)
   python3 tools/upload_image.py -f img.png -u http://esp-ip/image --force-full
 
+  # 4-level grayscale (dithered here) or 8-bit luminance (dithered on the device)
+  python3 tools/upload_image.py -f photo.jpg -u http://esp-ip/image --format g4
+  python3 tools/upload_image.py -f photo.jpg -u http://esp-ip/image --format g8
+
+  # Send a PackBits-compressed bw plane (format "rle"); also works for
+  # http://esp-ip/api/wallpaper/upload
+  python3 tools/upload_image.py -f img.png -u http://esp-ip/image --format bw --compress
+
 The 3c format expects the uploader to pack two bitplanes:
   [black_plane bytes] + [red_plane bytes]
 Each plane is width*height bits, MSB-first, row-major, padded on the last byte as needed.
@@ -47,6 +55,35 @@ except Exception as e:
 # Helpers for bitplane packing -------------------------------------------------
 
 
+def pack_bits(data):
+    """
+    Compress bytes with PackBits (matches src/utils/rle.cpp on the device).
+    - header n in 0..127   : n + 1 literal bytes follow
+    - header n in 129..255 : the next byte repeats 257 - n times
+    """
+    out = bytearray()
+    i = 0
+    n = len(data)
+    while i < n:
+        run = 1
+        while i + run < n and run < 128 and data[i + run] == data[i]:
+            run += 1
+        if run >= 2:
+            out.append(257 - run)
+            out.append(data[i])
+            i += run
+            continue
+
+        start = i
+        while i < n and i - start < 128:
+            if i + 1 < n and data[i] == data[i + 1]:
+                break
+            i += 1
+        out.append(i - start - 1)
+        out.extend(data[start:i])
+    return bytes(out)
+
+
 def pack_bitplane_bool(width, height, pixel_fn):
     """
     Pack a plane as bytes (row-major, MSB-first per byte).
@@ -138,6 +175,59 @@ def image_to_1bit_planes(
     return (black_plane, red_plane)
 
 
+def image_to_gray(img, width, height, format_="g4", preview_path=None):
+    """
+    Convert a PIL image to grayscale payloads.
+
+    - For 'g8': returns (luminance bytes,) one byte per pixel, 255 = white
+    - For 'g4': returns (packed bytes,) 2 bpp, 4 px per byte MSB-first,
+      0 = white .. 3 = black, Floyd-Steinberg dithered
+    """
+    im = ImageOps.fit(
+        img.convert("L"), (width, height), Image.LANCZOS, centering=(0.5, 0.5)
+    )
+    if format_ == "g8":
+        if preview_path:
+            im.save(preview_path)
+        return (im.tobytes(),)
+
+    # Error diffusion to 4 levels, working in "darkness" (0 = white, 255 = black)
+    dark = [[255 - im.getpixel((x, y)) for x in range(width)] for y in range(height)]
+    levels = [[0] * width for _ in range(height)]
+    for y in range(height):
+        for x in range(width):
+            v = dark[y][x]
+            q = max(0, min(3, int(round(v * 3 / 255.0))))
+            levels[y][x] = q
+            err = v - q * 85
+            if x + 1 < width:
+                dark[y][x + 1] += err * 7 / 16.0
+            if y + 1 < height:
+                if x > 0:
+                    dark[y + 1][x - 1] += err * 3 / 16.0
+                dark[y + 1][x] += err * 5 / 16.0
+                if x + 1 < width:
+                    dark[y + 1][x + 1] += err * 1 / 16.0
+
+    if preview_path:
+        preview = Image.new("L", (width, height), 255)
+        pr = preview.load()
+        for y in range(height):
+            for x in range(width):
+                pr[x, y] = 255 - levels[y][x] * 85
+        preview.save(preview_path)
+
+    out = bytearray()
+    for y in range(height):
+        for x0 in range(0, width, 4):
+            byte = 0
+            for i in range(4):
+                lv = levels[y][x0 + i] if x0 + i < width else 0
+                byte |= lv << (6 - 2 * i)
+            out.append(byte)
+    return (bytes(out),)
+
+
 # HTTP upload ------------------------------------------------------------------
 
 
@@ -178,9 +268,14 @@ def parse_args():
     p.add_argument(
         "-F",
         "--format",
-        choices=["3c", "bw"],
+        choices=["3c", "bw", "g4", "g8"],
         default="3c",
-        help="Output format: 3c or bw",
+        help="Output format: 3c, bw, g4 (4-gray) or g8 (8-bit, dithered on device)",
+    )
+    p.add_argument(
+        "--compress",
+        action="store_true",
+        help="PackBits-compress the bw plane and send it as format 'rle' (bw only)",
     )
     p.add_argument(
         "--force-full",
@@ -223,7 +318,11 @@ def main():
         sys.exit(1)
 
     print("Converting to {} ({}x{})...".format(args.format, args.width, args.height))
-    if args.format == "bw":
+    if args.format in ("g4", "g8"):
+        planes = image_to_gray(
+            img, args.width, args.height, format_=args.format, preview_path=args.preview
+        )
+    elif args.format == "bw":
         planes = image_to_1bit_planes(
             img,
             args.width,
@@ -243,6 +342,16 @@ def main():
             red_delta=args.red_delta,
             preview_path=args.preview,
         )
+    fmt = args.format
+    if args.compress:
+        if args.format != "bw":
+            print("--compress requires --format bw")
+            sys.exit(1)
+        raw_bytes = len(planes[0])
+        planes = (pack_bits(planes[0]),)
+        fmt = "rle"
+        print("Compressed %d -> %d bytes" % (raw_bytes, len(planes[0])))
+
     # Show sizes
     total_bytes = sum(len(p) for p in planes)
     print(
@@ -256,7 +365,7 @@ def main():
             args.url,
             args.width,
             args.height,
-            args.format,
+            fmt,
             planes,
             force_full=args.force_full,
             timeout=args.timeout,